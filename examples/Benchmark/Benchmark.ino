@@ -0,0 +1,410 @@
+/*
+	Benchmark.ino - Driving engine benchmark for the Evaluation Kit animations and display helpers
+	For Driver 5.x Hardware, or for a host build with YNV_ECD_SIMULATOR defined
+
+	Runs every Evaluation Kit animation and the core display helpers and prints
+	one JSON object per benchmark on the Serial port:
+	  - device_ms     : device time (simulated time in host builds)
+	  - cpu_us        : CPU time spent running the benchmark
+	  - execute_calls : executeDisplay() calls
+	  - drive_ms      : time spent inside executeDisplay()
+	  - ce_settles    : CE enable + settle cycles
+	  - color_pulses / bleach_pulses : pulses per polarity (transition + refresh)
+	  - refresh_retries : refresh pulse + re-check iterations
+	  - charge_mC     : charge delivered to the display (host simulation only)
+
+	To compare against a previous run (host builds), save its output and give
+	it back in the BENCHMARK_BASELINE environment variable, as a file path or
+	"-" for stdin:
+	  ./Benchmark > baseline.jsonl
+	  BENCHMARK_BASELINE=baseline.jsonl ./Benchmark
+	Each benchmark found in the baseline also reports a delta_<field> for
+	every field above.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#ifdef YNV_ECD_SIMULATOR
+#include <stdio.h>
+#include <stdlib.h>
+
+YNV_ECD_Simulator simBoard;               // Simulated Driver v5 board (host builds)
+#endif
+
+#define BENCHMARK_MAX_BASELINE  32        // Benchmarks kept from the baseline run
+#define BENCHMARK_NAME_LENGTH   48        // Longest benchmark name + 1
+
+struct benchmark_t {
+  const char* name;
+  void (*run)(void);
+};
+
+// Results of one benchmark, as printed by runBenchmark()
+struct baseline_t {
+  char  name[BENCHMARK_NAME_LENGTH];
+  long  deviceMs;
+  long  cpuMicros;
+  long  executeCalls;
+  long  driveTimeMs;
+  long  ceSettles;
+  long  colorPulses;
+  long  bleachPulses;
+  long  refreshRetries;
+  float chargeMilliCoulomb;
+};
+
+baseline_t   baselineResults[BENCHMARK_MAX_BASELINE];
+unsigned int baselineCount = 0;
+
+/**
+ * Device time in ms (virtual clock of the simulator in host builds)
+ */
+unsigned long deviceMillis(void){
+#ifdef YNV_ECD_SIMULATOR
+  return simBoard.millis();
+#else
+  return millis();
+#endif
+}
+
+/**
+ * Hold the displayed content for some time, as the animations do
+ */
+void holdFor(unsigned long holdTime){
+#ifdef YNV_ECD_SIMULATOR
+  simBoard.advanceTime(holdTime);
+#else
+  delay(holdTime);
+#endif
+}
+
+/******************************************************************************
+ *                              ANIMATIONS                                    *
+ ******************************************************************************/
+
+void benchDirectToggle(void){
+  displayDirectSetAll(true, EVAL_KIT_DIRECT_TOGGLE_DELAY);
+  displayDirectSetAll(false, EVAL_KIT_DIRECT_TOGGLE_DELAY);
+}
+
+void bench15SegPositiveUp(void){
+  display15SegNegInit();
+  for(int i = 0; i <= 99; i++){
+    display15SegNegRun(i, false);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void bench15SegPositiveDown(void){
+  display15SegNegInit();
+  for(int i = 99; i >= 0; i--){
+    display15SegNegRun(i, false);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void bench15SegNegativeUp(void){
+  display15SegNegInit();
+  for(int i = 99; i >= 0; i--){
+    display15SegNegRun(i, true);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void bench15SegNegativeDown(void){
+  display15SegNegInit();
+  for(int i = 0; i <= 99; i++){
+    display15SegNegRun(i, true);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void bench15SegDotUp(void){
+  display15SegDotInit();
+  for(int i = 0; i <= 99; i++){
+    display15SegDotRun(i, true);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void bench15SegDotDown(void){
+  display15SegDotInit();
+  for(int i = 99; i >= 0; i--){
+    display15SegDotRun(i, true);
+    holdFor(EVAL_KIT_15SEG_COUNT_DELAY);
+  }
+}
+
+void benchSingleOn(void){
+  displaySingleSet(SEGMENT_STATE_COLOR);
+  holdFor(EVAL_KIT_SINGLE_ON_TIME);
+  displaySingleSet(SEGMENT_STATE_BLEACH);
+  holdFor(EVAL_KIT_SINGLE_OFF_TIME);
+}
+
+void bench7SegDotCountUp(void){
+  for(int i = 0; i <= 9; i++){
+    display7SegDotRun(i, true);
+    holdFor(EVAL_KIT_7SEG_DOT_COUNT_DELAY);
+  }
+}
+
+void bench7SegDotCountDown(void){
+  for(int i = 9; i >= 0; i--){
+    display7SegDotRun(i, true);
+    holdFor(EVAL_KIT_7SEG_DOT_COUNT_DELAY);
+  }
+}
+
+void bench7BarsCountUp(void){
+  for(int i = 0; i < 7; i++){
+    display7BarsSet(i, SEGMENT_STATE_COLOR);
+    holdFor(EVAL_KIT_7BAR_COUNT_DELAY);
+  }
+  display7BarsClear();
+}
+
+void bench7BarsCountDown(void){
+  for(int i = 6; i >= 0; i--){
+    display7BarsSet(i, SEGMENT_STATE_COLOR);
+    holdFor(EVAL_KIT_7BAR_COUNT_DELAY);
+  }
+  display7BarsClear();
+}
+
+void bench3BarsCountUp(void){
+  for(int i = 0; i < 3; i++){
+    display3BarsSet(i, SEGMENT_STATE_COLOR);
+    holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+  }
+  holdFor(2 * EVAL_KIT_3BAR_COUNT_DELAY);
+  for(int i = 0; i < 3; i++){
+    display3BarsSet(i, SEGMENT_STATE_BLEACH);
+  }
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+}
+
+void bench3BarsCountDown(void){
+  for(int i = 2; i >= 0; i--){
+    display3BarsSet(i, SEGMENT_STATE_COLOR);
+    holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+  }
+  for(int i = 2; i >= 0; i--){
+    display3BarsSet(i, SEGMENT_STATE_BLEACH);
+  }
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+}
+
+void bench3BarsMidTopBot(void){
+  display3BarsSet(1, SEGMENT_STATE_COLOR);
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+  display3BarsSet(2, SEGMENT_STATE_COLOR);
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+  display3BarsSet(0, SEGMENT_STATE_COLOR);
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+  display3BarsSet(1, SEGMENT_STATE_BLEACH);
+  display3BarsSet(0, SEGMENT_STATE_BLEACH);
+  display3BarsSet(2, SEGMENT_STATE_BLEACH);
+  holdFor(EVAL_KIT_3BAR_COUNT_DELAY);
+}
+
+/******************************************************************************
+ *                              DISPLAY HELPERS                               *
+ ******************************************************************************/
+
+void bench7SegDotRun(void){
+  display7SegDotRun(8, true);             // All segments ON
+  display7SegDotRun(1, false);            // Most segments OFF
+}
+
+void bench15SegNegRun(void){
+  display15SegNegInit();
+  display15SegNegRun(9, false);
+  display15SegNegRun(10, true);           // Tens rollover + minus sign
+}
+
+void bench7BarsSet(void){
+  display7BarsSet(3, SEGMENT_STATE_COLOR);
+  display7BarsSet(3, SEGMENT_STATE_BLEACH);
+}
+
+void bench3BarsSet(void){
+  display3BarsSet(1, SEGMENT_STATE_COLOR);
+  display3BarsSet(1, SEGMENT_STATE_BLEACH);
+}
+
+void benchCancelAnimation(void){
+  display7BarsSet(6, SEGMENT_STATE_COLOR);
+  displayCancelAnimation();
+}
+
+// Ordered as evaluationKitAnimations_e, followed by the display helpers
+const benchmark_t benchmarks[] = {
+  { "EVAL_ANIMATION_DIRECT_TOGGLE",           benchDirectToggle       },
+  { "EVAL_ANIMATION_15SEG_NEGATIVE_POS_UP",   bench15SegPositiveUp    },
+  { "EVAL_ANIMATION_15SEG_NEGATIVE_POS_DOWN", bench15SegPositiveDown  },
+  { "EVAL_ANIMATION_15SEG_NEGATIVE_NEG_UP",   bench15SegNegativeUp    },
+  { "EVAL_ANIMATION_15SEG_NEGATIVE_NEG_DOWN", bench15SegNegativeDown  },
+  { "EVAL_ANIMATION_15SEG_DOT_UP",            bench15SegDotUp         },
+  { "EVAL_ANIMATION_15SEG_DOT_DOWN",          bench15SegDotDown       },
+  { "EVAL_ANIMATION_SINGLE_ON",               benchSingleOn           },
+  { "EVAL_ANIMATION_7SEG_DOT_COUNT_UP",       bench7SegDotCountUp     },
+  { "EVAL_ANIMATION_7SEG_DOT_COUNT_DOWN",     bench7SegDotCountDown   },
+  { "EVAL_ANIMATION_7BARS_COUNT_UP",          bench7BarsCountUp       },
+  { "EVAL_ANIMATION_7BARS_COUNT_DOWN",        bench7BarsCountDown     },
+  { "EVAL_ANIMATION_3BARS_COUNT_UP",          bench3BarsCountUp       },
+  { "EVAL_ANIMATION_3BARS_COUNT_DOWN",        bench3BarsCountDown     },
+  { "EVAL_ANIMATION_3BARS_MID_TOP_BOT",       bench3BarsMidTopBot     },
+  { "display7SegDotRun",                      bench7SegDotRun         },
+  { "display15SegNegRun",                     bench15SegNegRun        },
+  { "display7BarsSet",                        bench7BarsSet           },
+  { "display3BarsSet",                        bench3BarsSet           },
+  { "displayCancelAnimation",                 benchCancelAnimation    }
+};
+
+/**
+ * Find the baseline entry of a benchmark
+ * @returns pointer to the entry, or nullptr if there is no baseline
+ */
+const baseline_t* findBaseline(const char* name){
+  for(unsigned int i = 0; i < baselineCount; i++){
+    if(strcmp(baselineResults[i].name, name) == 0){
+      return &baselineResults[i];
+    }
+  }
+  return nullptr;
+}
+
+#ifdef YNV_ECD_SIMULATOR
+/**
+ * Value of a numeric field in one JSON line
+ * @returns true if the field is present
+ */
+bool readField(const char* line, const char* field, double& value){
+  char key[32];
+  snprintf(key, sizeof(key), "\"%s\":", field);
+
+  const char* found = strstr(line, key);
+  if(found == nullptr){
+    return false;
+  }
+  value = strtod(found + strlen(key), nullptr);
+  return true;
+}
+
+/**
+ * Load the results of a previous run (file path, or "-" for stdin); lines
+ * that are not benchmark results are skipped
+ */
+void loadBaseline(const char* path){
+  FILE* file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+  if(file == nullptr){
+    fprintf(stderr, "Cannot open baseline %s\n", path);
+    return;
+  }
+
+  char line[512];
+  while(baselineCount < BENCHMARK_MAX_BASELINE && fgets(line, sizeof(line), file) != nullptr){
+    baseline_t& entry = baselineResults[baselineCount];
+    double      value;
+
+    if(sscanf(line, "{\"name\":\"%47[^\"]\"", entry.name) != 1){
+      continue;
+    }
+    entry.deviceMs           = readField(line, "device_ms", value)       ? (long)value : 0;
+    entry.cpuMicros          = readField(line, "cpu_us", value)          ? (long)value : 0;
+    entry.executeCalls       = readField(line, "execute_calls", value)   ? (long)value : 0;
+    entry.driveTimeMs        = readField(line, "drive_ms", value)        ? (long)value : 0;
+    entry.ceSettles          = readField(line, "ce_settles", value)      ? (long)value : 0;
+    entry.colorPulses        = readField(line, "color_pulses", value)    ? (long)value : 0;
+    entry.bleachPulses       = readField(line, "bleach_pulses", value)   ? (long)value : 0;
+    entry.refreshRetries     = readField(line, "refresh_retries", value) ? (long)value : 0;
+    entry.chargeMilliCoulomb = readField(line, "charge_mC", value)       ? (float)value : 0.0f;
+    baselineCount++;
+  }
+  if(file != stdin){
+    fclose(file);
+  }
+}
+#endif
+
+/**
+ * Print the change of one counter against the baseline
+ */
+void printDelta(const char* field, long current, long reference){
+  Serial.print(",\"delta_"); Serial.print(field); Serial.print("\":");
+  Serial.print(current - reference);
+}
+
+/**
+ * Run one benchmark and print its results as a JSON object
+ */
+void runBenchmark(const benchmark_t& benchmark){
+  evaluationKitResetStats();
+#ifdef YNV_ECD_SIMULATOR
+  simBoard.resetChargeDelivered();
+#endif
+
+  unsigned long startDevice = deviceMillis();
+  unsigned long startCpu    = micros();
+
+  benchmark.run();
+
+  unsigned long cpuTime    = micros() - startCpu;
+  unsigned long deviceTime = deviceMillis() - startDevice;
+  ECD_Stats stats          = evaluationKitGetStats();
+
+  Serial.print("{\"name\":\"");          Serial.print(benchmark.name);
+  Serial.print("\",\"device_ms\":");     Serial.print(deviceTime);
+  Serial.print(",\"cpu_us\":");          Serial.print(cpuTime);
+  Serial.print(",\"execute_calls\":");   Serial.print(stats.executeCount);
+  Serial.print(",\"drive_ms\":");        Serial.print(stats.driveTimeMs);
+  Serial.print(",\"ce_settles\":");      Serial.print(stats.ceSettles);
+  Serial.print(",\"color_pulses\":");    Serial.print(stats.colorPulses);
+  Serial.print(",\"bleach_pulses\":");   Serial.print(stats.bleachPulses);
+  Serial.print(",\"refresh_retries\":"); Serial.print(stats.refreshRetries);
+
+#ifdef YNV_ECD_SIMULATOR
+  float charge = simBoard.getChargeDelivered() * 1000.0f;
+  Serial.print(",\"charge_mC\":");       Serial.print(charge, 3);
+#endif
+
+  const baseline_t* baseline = findBaseline(benchmark.name);
+  if(baseline != nullptr){
+    printDelta("device_ms",       (long)deviceTime,           baseline->deviceMs);
+    printDelta("cpu_us",          (long)cpuTime,              baseline->cpuMicros);
+    printDelta("execute_calls",   (long)stats.executeCount,   baseline->executeCalls);
+    printDelta("drive_ms",        (long)stats.driveTimeMs,    baseline->driveTimeMs);
+    printDelta("ce_settles",      (long)stats.ceSettles,      baseline->ceSettles);
+    printDelta("color_pulses",    (long)stats.colorPulses,    baseline->colorPulses);
+    printDelta("bleach_pulses",   (long)stats.bleachPulses,   baseline->bleachPulses);
+    printDelta("refresh_retries", (long)stats.refreshRetries, baseline->refreshRetries);
+#ifdef YNV_ECD_SIMULATOR
+    Serial.print(",\"delta_charge_mC\":"); Serial.print(charge - baseline->chargeMilliCoulomb, 3);
+#endif
+  }
+  Serial.println("}");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  evaluationKitInit();
+#ifdef YNV_ECD_SIMULATOR
+  evaluationKitAttachSimulator(&simBoard);
+
+  const char* baselinePath = getenv("BENCHMARK_BASELINE");
+  if(baselinePath != nullptr){
+    loadBaseline(baselinePath);
+  }
+#endif
+
+  for(unsigned int i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++){
+    runBenchmark(benchmarks[i]);
+  }
+}
+
+void loop() {
+}
@@ -0,0 +1,172 @@
+/*
+	CrosstalkRefresh.ino - Refresh triggers with and without crosstalk-aware OCP measurement
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	A simulated 7-bar display whose bars couple into the readings of the
+	bars next to them (a static share of the neighbour potential, and a share
+	of its double-layer polarisation that fades after each pulse) shows a
+	changing bar level for HOLD_DAYS days, checked every POLL_INTERVAL:
+	  - plain      : pin-order OCP sweeps, read right after the pulses
+	  - ordered    : adjacency map + ocpSettleTime on the OCP check sweep,
+	                 undisturbed bars read first, settle only before the
+	                 disturbed ones (the refresh re-checks read at once)
+	  - compensated: as ordered, plus the gains learned by learnCrosstalk()
+	All modes run the same refresh limits.
+
+	One JSON line per mode: OCP checks that started a refresh, refresh
+	pulses (transitions not counted), charge delivered, drive time, and the
+	contrast kept (lowest charge of a colored bar, highest charge of a
+	bleached bar, at hourly samples).
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define HOLD_DAYS               2           // Days of operation
+#define HOUR_MS                 3600000UL   // (ms) One hour
+#define POLL_INTERVAL           1800000UL   // (ms) executeDisplay() period
+#define LEVEL_INTERVAL          10800000UL  // (ms) Bar level change period (3 h)
+#define SPREAD_SEED             7           // Manufacturing spread of the panel
+#define RETENTION_MS            43200000.0f // (ms) Nominal self-discharge time constant (12 h)
+#define NEIGHBOUR_COUPLING      0.05f       // Static share of each neighbour potential
+#define POLARISATION_COUPLING   0.25f       // Share of each neighbour double-layer voltage
+#define SETTLE_TIME_MS          150         // (ms) ocpSettleTime of the ordered modes
+#define SETTLE_BUDGET_MS        150         // (ms) ocpSettleBudget of the ordered modes (one settle per update)
+
+#ifdef YNV_ECD_SIMULATOR
+
+int crosstalkPinList[EVAL_KIT_7BARS_NUM_SEGMENTS] = EVAL_KIT_7BARS_PIN_LIST;
+YNV_ECD crosstalkDisplay(EVAL_KIT_7BARS_NUM_SEGMENTS, crosstalkPinList);
+
+ecdSegmentMask_t neighbours[EVAL_KIT_7BARS_NUM_SEGMENTS];    // Bars side by side: i-1 and i+1
+float            gains[EVAL_KIT_7BARS_NUM_SEGMENTS];
+
+const int levels[] = {3, 6, 2, 5, 1, 4, 7, 0};               // Bar levels shown in turn
+
+/**
+ * Show a bar level: bars below it colored, the others bleached
+ */
+void showLevel(int level){
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    crosstalkDisplay.setSegmentState(i, i < level);
+  }
+  crosstalkDisplay.executeDisplay();
+}
+
+/**
+ * Run HOLD_DAYS of bar level changes with one measurement mode
+ */
+void runMode(const char* name, bool ordered, bool compensated){
+  YNV_ECD_Simulator sim;
+  ECD_SegmentModel  nominal;
+  ECD_SegmentSpread spread;
+  ECD_Config        cfg;
+
+  nominal.selfDischargeTime    = RETENTION_MS;
+  nominal.neighbourCoupling    = NEIGHBOUR_COUPLING;
+  nominal.polarisationCoupling = POLARISATION_COUPLING;
+  crosstalkDisplay.attachSimulator(&sim);
+  sim.applySegmentSpread(nominal, spread, SPREAD_SEED);
+  sim.setNeighbours(neighbours);
+
+  cfg.ocpSettleTime   = ordered ? SETTLE_TIME_MS : 0;
+  cfg.ocpSettleBudget = ordered ? SETTLE_BUDGET_MS : 0;
+  crosstalkDisplay.setConfig(cfg);
+  crosstalkDisplay.setNeighbours(ordered ? neighbours : nullptr);
+  crosstalkDisplay.setCrosstalkGains(compensated ? gains : nullptr);
+
+  crosstalkDisplay.begin();
+  if(compensated){
+    crosstalkDisplay.learnCrosstalk();
+  }
+
+  crosstalkDisplay.resetStats();
+  sim.resetChargeDelivered();
+  sim.resetSafetyViolations();
+
+  unsigned long start      = sim.millis();
+  unsigned long endMs      = start + HOLD_DAYS * 24 * HOUR_MS;
+  unsigned long nextHour   = start + HOUR_MS;
+  int           step       = 0;
+  int           level      = levels[0];
+  float         minColored = 1.0f;
+  float         maxBleached = 0.0f;
+
+  showLevel(level);
+  while(sim.millis() < endMs){
+    sim.advanceTime(POLL_INTERVAL - (sim.millis() - start) % POLL_INTERVAL);
+    if((sim.millis() - start) / LEVEL_INTERVAL != (unsigned long)step){
+      step  = (sim.millis() - start) / LEVEL_INTERVAL;
+      level = levels[step % (sizeof(levels) / sizeof(levels[0]))];
+      showLevel(level);
+    }else{
+      crosstalkDisplay.executeDisplay();
+    }
+    if(sim.millis() >= nextHour){
+      for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+        float charge = sim.getSegmentCharge(i);
+        if(i < level){
+          minColored  = min(minColored, charge);
+        }else{
+          maxBleached = max(maxBleached, charge);
+        }
+      }
+      nextHour += HOUR_MS;
+    }
+  }
+
+  const ECD_Stats& stats = crosstalkDisplay.getStats();
+  float meanGain = 0.0f;
+  for(int i = 0; compensated && i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    meanGain += gains[i] / EVAL_KIT_7BARS_NUM_SEGMENTS;
+  }
+
+  Serial.print("{\"mode\":\"");              Serial.print(name);
+  Serial.print("\",\"days\":");              Serial.print(HOLD_DAYS);
+  Serial.print(",\"checks\":");              Serial.print(stats.executeCount);
+  Serial.print(",\"refresh_triggers\":");    Serial.print(stats.refreshTriggers);
+  Serial.print(",\"refresh_pulses\":");      Serial.print(stats.refreshRetries);
+  Serial.print(",\"charge_uC\":");           Serial.print(sim.getChargeDelivered() * 1.0e6f, 1);
+  Serial.print(",\"drive_ms\":");            Serial.print(stats.driveTimeMs);
+  Serial.print(",\"min_colored\":");         Serial.print(minColored, 3);
+  Serial.print(",\"max_bleached\":");        Serial.print(maxBleached, 3);
+  Serial.print(",\"mean_gain\":");           Serial.print(meanGain, 4);
+  Serial.print(",\"safety_violations\":");   Serial.print(sim.getSafetyViolations());
+  Serial.println("}");
+
+  crosstalkDisplay.setNeighbours(nullptr);
+  crosstalkDisplay.setCrosstalkGains(nullptr);
+  crosstalkDisplay.attachSimulator(nullptr);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    neighbours[i] = 0;
+    if(i > 0){
+      neighbours[i] |= (ecdSegmentMask_t)1 << (i - 1);
+    }
+    if(i < EVAL_KIT_7BARS_NUM_SEGMENTS - 1){
+      neighbours[i] |= (ecdSegmentMask_t)1 << (i + 1);
+    }
+  }
+
+  runMode("plain", false, false);
+  runMode("ordered", true, false);
+  runMode("compensated", true, true);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("CrosstalkRefresh runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,124 @@
+/*
+	ExpanderPanel.ino - 48-segment panel driven through GPIO expanders
+	For a host build with YNV_ECD_SIMULATOR and YNV_ECD_HAL_EXPANDER defined
+
+	The WE pins of the panel sit on three simulated 16-output expanders
+	(ECD_SimExpanderBus, MCP23017 timing); the CE stays on the board DAC.
+	A checkerboard and its inverse are written, then held long enough for the
+	segments to drift, and updated again (refresh). The sequence runs twice:
+	  - open loop: no OCP path to the expander pins, the refresh never triggers
+	  - with an OCP reader (setOcpReader(), here the ideal simulator read)
+
+	Reported per run:
+	  - expander transactions and modelled bus time
+	  - largest start skew between chips (longest flush)
+	  - largest pulse width difference between chips of one pulse
+	  - CE safety violations and visibly wrong segments after each update
+
+	On hardware, replace ECD_SimExpanderBus by ECD_Mcp23017Bus or
+	ECD_Mcp23S17Bus from YnvisibleECDExpanderBus.h.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleECD.h"
+
+#ifdef YNV_ECD_SIMULATOR
+#include "YnvisibleECDSimulator.h"
+#endif
+
+#define PANEL_NUM_CHIPS         3
+#define PANEL_NUM_SEGMENTS      (PANEL_NUM_CHIPS * ECD_EXPANDER_PINS_PER_CHIP)
+#define PANEL_HOLD_TIME         1800000UL   // (ms) Hold between updates (self-discharge)
+#define PANEL_NUM_CYCLES        3           // Checkerboard / inverse / hold cycles per run
+
+#if defined(YNV_ECD_SIMULATOR) && defined(YNV_ECD_HAL_EXPANDER)
+
+// The 16 outputs of one expander chip
+#define PANEL_CHIP_PINS(c) \
+  ECD_EXPANDER_PIN(c, 0),  ECD_EXPANDER_PIN(c, 1),  ECD_EXPANDER_PIN(c, 2),  ECD_EXPANDER_PIN(c, 3),  \
+  ECD_EXPANDER_PIN(c, 4),  ECD_EXPANDER_PIN(c, 5),  ECD_EXPANDER_PIN(c, 6),  ECD_EXPANDER_PIN(c, 7),  \
+  ECD_EXPANDER_PIN(c, 8),  ECD_EXPANDER_PIN(c, 9),  ECD_EXPANDER_PIN(c, 10), ECD_EXPANDER_PIN(c, 11), \
+  ECD_EXPANDER_PIN(c, 12), ECD_EXPANDER_PIN(c, 13), ECD_EXPANDER_PIN(c, 14), ECD_EXPANDER_PIN(c, 15)
+
+const int panelPinList[PANEL_NUM_SEGMENTS] = { PANEL_CHIP_PINS(0), PANEL_CHIP_PINS(1), PANEL_CHIP_PINS(2) };
+YNV_ECD_Sized<PANEL_NUM_SEGMENTS> panel(PANEL_NUM_SEGMENTS, panelPinList);
+YNV_ECD_Simulator simBoard;
+ECD_SimExpanderBus expanderBus(simBoard);
+
+unsigned int wrongSegments = 0;
+
+/**
+ * Apply one frame (checkerboard or its inverse) and count visibly wrong segments
+ */
+void runUpdate(bool inverse){
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    panel.setSegmentState(i, ((i & 1) != 0) != inverse);
+  }
+  panel.executeDisplay();
+
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    if(simBoard.isSegmentVisiblyColored(i) != (((i & 1) != 0) != inverse)){
+      wrongSegments++;
+    }
+  }
+}
+
+/**
+ * Run the update sequence and print the result as JSON
+ */
+void runPanel(const char* name, bool ocpReader){
+  if(ocpReader){ panel.getHal().setOcpReader(ECD_SimExpanderBus::readOcp, &simBoard); }
+  else{          panel.getHal().setOcpReader(nullptr, nullptr); }
+
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    simBoard.setSegmentCharge(i, 0.0f);
+  }
+  panel.getHal().attachExpander(&expanderBus, PANEL_NUM_CHIPS);
+  simBoard.resetSafetyViolations();
+  panel.resetStats();
+  wrongSegments = 0;
+
+  panel.begin();
+  for(int cycle = 0; cycle < PANEL_NUM_CYCLES; cycle++){
+    runUpdate(false);
+    runUpdate(true);
+    simBoard.advanceTime(PANEL_HOLD_TIME);
+    runUpdate(true);                                  // Same frame: refresh only
+  }
+
+  const ECD_ExpanderStats& bus = panel.getHal().getExpanderStats();
+
+  Serial.print("{\"run\":\"");                   Serial.print(name);
+  Serial.print("\",\"transactions\":");          Serial.print(bus.transactions);
+  Serial.print(",\"bus_us\":");                  Serial.print(bus.busMicros);
+  Serial.print(",\"max_start_skew_us\":");       Serial.print(bus.maxFlushMicros);
+  Serial.print(",\"pulse_mismatch_us\":");       Serial.print(expanderBus.getMaxPulseMismatchMicros());
+  Serial.print(",\"color_pulses\":");            Serial.print(panel.getStats().colorPulses);
+  Serial.print(",\"bleach_pulses\":");           Serial.print(panel.getStats().bleachPulses);
+  Serial.print(",\"safety_violations\":");       Serial.print(simBoard.getSafetyViolations());
+  Serial.print(",\"wrong_segments\":");          Serial.print(wrongSegments);
+  Serial.println("}");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  panel.attachSimulator(&simBoard);
+
+  runPanel("open_loop", false);
+  runPanel("ocp_reader", true);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("ExpanderPanel runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR and YNV_ECD_HAL_EXPANDER defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,295 @@
+/*
+	GoldenTrace.ino - Golden drive-waveform regression of the Evaluation Kit
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	Runs a fixed list of Eval Kit operations (begin, digit transitions, bar
+	level changes, cancel in the middle of a pulse) on the simulated board and
+	records the full timeline of each one: CE DAC codes, WE pin modes and
+	levels, ADC sample points and delays (ECD_SimEvent, times relative to the
+	start of the operation).
+
+	The 7-seg and 7-bar displays are the Eval Kit ones (same segment order,
+	ECD_Config and helper sequences), on fixed pin numbers (GOLDEN_PIN_CE,
+	goldenDigitPins, goldenBarPins) so the timelines do not depend on the
+	board variant of the host core.
+
+	  - Check mode (default, GoldenTraces.h next to this sketch): every
+	    timeline is compared with its golden copy, with
+	    GOLDEN_TIME_TOLERANCE_MS allowed per event. Any change in pulse count,
+	    order or duration reports the first diverging event.
+	  - Record mode (GOLDEN_RECORD defined, or no GoldenTraces.h): the
+	    timelines are printed as a C header. Save the output as GoldenTraces.h
+	    and check it in with the driver change it belongs to.
+
+	Both modes also check the safety ordering on the simulator: the CE must
+	never be changed or released while a segment WE is still driven.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define GOLDEN_TRACE_CAPACITY       8192    // Events per operation
+#define GOLDEN_TIME_TOLERANCE_MS    5       // (ms) Allowed timing difference per event
+#define GOLDEN_CANCEL_DELAY_MS      120     // (ms) Cancel request time after the start of the operation
+#define GOLDEN_PIN_CE               100     // Counter Electrode pin of the golden timelines
+
+#ifdef YNV_ECD_SIMULATOR
+
+#if defined(__has_include) && !defined(GOLDEN_RECORD)
+#if __has_include("GoldenTraces.h")
+#include "GoldenTraces.h"
+#define GOLDEN_CHECK
+#endif
+#endif
+
+YNV_ECD_Simulator simBoard;
+ECD_SimEvent      traceBuffer[GOLDEN_TRACE_CAPACITY];
+
+// Eval Kit segment order on fixed pins (PIN_SEG_n = n)
+int goldenDigitPins[EVAL_KIT_7SEG_DOT_NUM_SEGMENTS] = {8, 7, 5, 6, 4, 3, 1, 2};
+int goldenBarPins[EVAL_KIT_7BARS_NUM_SEGMENTS]      = {4, 3, 5, 2, 6, 1, 7};
+
+YNV_ECD_Sized<EVAL_KIT_7SEG_DOT_NUM_SEGMENTS> goldenDigit(EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, goldenDigitPins, GOLDEN_PIN_CE);
+YNV_ECD_Sized<EVAL_KIT_7BARS_NUM_SEGMENTS>    goldenBars (EVAL_KIT_7BARS_NUM_SEGMENTS,    goldenBarPins,   GOLDEN_PIN_CE);
+
+// Eval Kit 7-seg masks of the digits used (segments a..g, the dot is index 3)
+const bool digitMasks[10][EVAL_KIT_7SEG_DOT_NUM_SEGMENTS - 1] = {
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+const char* eventTypeNames[] = {
+  "ECD_SIM_EVENT_PIN_MODE", "ECD_SIM_EVENT_DIGITAL_WRITE", "ECD_SIM_EVENT_ANALOG_WRITE",
+  "ECD_SIM_EVENT_ANALOG_READ", "ECD_SIM_EVENT_DELAY", "ECD_SIM_EVENT_PHASE"
+};
+
+/* ---- Operations under test ---- */
+
+/**
+ * Same sequence as display7SegDotRun(): clear, then the digit and the dot
+ * (number 10 = all off)
+ */
+void digitRun(unsigned int number, bool dot){
+  for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+    goldenDigit.setSegmentState(i, false);
+  }
+  goldenDigit.executeDisplay();
+  for(int i = 0, m = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+    if(i != 3){
+      goldenDigit.setSegmentState(i, number < 10 && digitMasks[number][m]);
+      m++;
+    }
+  }
+  goldenDigit.setSegmentState(3, dot);
+  goldenDigit.executeDisplay();
+}
+
+/**
+ * Same sequence as display7BarsSet()
+ */
+void barSet(int segment, bool state){
+  goldenBars.setSegmentState(segment, state);
+  goldenBars.executeDisplay();
+}
+
+void cancelHandler(void*){
+  goldenDigit.setStopDrivingFlag();                   // Same call as the Eval Kit button ISR
+}
+
+void opBegin7Seg()     { digitRun(8, true); digitRun(10, false); }
+void opDigit0To1()     { digitRun(0, false); digitRun(1, false); }
+void opDigit1To7()     { digitRun(7, true); }
+void opBarsLevel3()    { goldenBars.setAllSegmentsBleach(); goldenBars.executeDisplay(); for(int i = 0; i < 3; i++) barSet(i, true); }
+void opBarsLevel3To5() { barSet(3, true); barSet(4, true); }
+void opCancel(){
+  simBoard.scheduleInterrupt(simBoard.millis() + GOLDEN_CANCEL_DELAY_MS, cancelHandler, nullptr);
+  digitRun(8, false);
+  goldenDigit.clearStopDriving();                     // Same sequence as displayCancelAnimation()
+  goldenDigit.setAllSegmentsBleach();
+  goldenDigit.executeDisplay();
+}
+
+/**
+ * Eval Kit ECD_Config of the 7-seg (with dot) and 7-bar displays
+ */
+void configureDisplays(){
+  ECD_Config digitConfig;
+  ECD_Config barConfig;
+
+  digitConfig.refreshColorLimitHVoltage  = 1.1;
+  digitConfig.refreshColorLimitLVoltage  = 0.95;
+  digitConfig.refreshBleachLimitHVoltage = 0.3;
+  digitConfig.refreshBleachLimitLVoltage = 0.5;
+  digitConfig.coloringVoltage            = 1.3;
+  digitConfig.refreshColoringVoltage     = 1.3;
+  digitConfig.coloringTime               = 350;
+  digitConfig.refreshColorPulseTime      = 100;
+  digitConfig.bleachingVoltage           = 0.7;
+  digitConfig.refreshBleachingVoltage    = 0.6;
+  digitConfig.bleachingTime              = 350;
+  digitConfig.refreshBleachPulseTime     = 100;
+  goldenDigit.setConfig(digitConfig);
+
+  barConfig.refreshColorLimitHVoltage    = 1.1;
+  barConfig.refreshColorLimitLVoltage    = 0.95;
+  barConfig.refreshBleachLimitHVoltage   = 0.3;
+  barConfig.refreshBleachLimitLVoltage   = 0.4;
+  barConfig.coloringVoltage              = 1.3;
+  barConfig.refreshColoringVoltage       = 1.3;
+  barConfig.coloringTime                 = 350;
+  barConfig.refreshColorPulseTime        = 100;
+  barConfig.bleachingVoltage             = 0.8;
+  barConfig.refreshBleachingVoltage      = 0.7;
+  barConfig.bleachingTime                = 350;
+  barConfig.refreshBleachPulseTime       = 200;
+  goldenBars.setConfig(barConfig);
+}
+
+struct goldenOperation_t {
+  const char* name;
+  void        (*run)(void);
+};
+
+const goldenOperation_t operations[] = {
+  { "begin_7seg",         opBegin7Seg     },
+  { "digit_0_to_1",       opDigit0To1     },
+  { "digit_1_to_7",       opDigit1To7     },
+  { "bars_level_3",       opBarsLevel3    },
+  { "bars_level_3_to_5",  opBarsLevel3To5 },
+  { "cancel_mid_pulse",   opCancel        },
+};
+
+#define GOLDEN_NUM_OPERATIONS   (sizeof(operations) / sizeof(operations[0]))
+
+/**
+ * Run one operation and record its timeline, relative to its start
+ * @returns number of events
+ */
+unsigned int recordOperation(const goldenOperation_t& op){
+  unsigned long start = simBoard.millis();
+
+  simBoard.setTraceBuffer(traceBuffer, GOLDEN_TRACE_CAPACITY);
+  simBoard.resetSafetyViolations();
+  op.run();
+
+  unsigned int length = simBoard.getTraceLength();
+  if(simBoard.getTraceDropped() > 0){
+    Serial.println("// Trace buffer full: increase GOLDEN_TRACE_CAPACITY");
+  }
+  simBoard.setTraceBuffer(nullptr, 0);
+
+  for(unsigned int i = 0; i < length; i++){
+    traceBuffer[i].timeMs -= start;
+  }
+  return length;
+}
+
+#ifdef GOLDEN_CHECK
+
+/**
+ * Compare a timeline with its golden copy and print the result as JSON
+ * @returns true if the operation matches and respects the safety ordering
+ */
+bool checkOperation(const goldenOperation_t& op, unsigned int length){
+  const goldenTrace_t* golden = nullptr;
+
+  for(unsigned int i = 0; i < sizeof(goldenTraces) / sizeof(goldenTraces[0]); i++){
+    if(strcmp(goldenTraces[i].name, op.name) == 0){
+      golden = &goldenTraces[i];
+    }
+  }
+
+  int divergence = (golden == nullptr) ? 0 :
+                   YNV_ECD_Simulator::findTraceDivergence(golden->events, golden->length, traceBuffer, length,
+                                                          GOLDEN_TIME_TOLERANCE_MS);
+  bool pass = divergence < 0 && simBoard.getSafetyViolations() == 0;
+
+  Serial.print("{\"op\":\"");                Serial.print(op.name);
+  Serial.print("\",\"events\":");            Serial.print(length);
+  Serial.print(",\"golden_events\":");       Serial.print(golden ? golden->length : 0);
+  Serial.print(",\"safety_violations\":");   Serial.print(simBoard.getSafetyViolations());
+  Serial.print(",\"divergence\":");          Serial.print(divergence);
+  Serial.print(",\"result\":\"");            Serial.print(pass ? "pass" : "fail");
+  Serial.println("\"}");
+
+  if(divergence >= 0 && golden != nullptr){
+    Serial.print("// expected: ");
+    if((unsigned int)divergence < golden->length){ YNV_ECD_Simulator::printTraceEvent(Serial, golden->events[divergence]); }
+    else{ Serial.println("end of timeline"); }
+    Serial.print("// actual:   ");
+    if((unsigned int)divergence < length){ YNV_ECD_Simulator::printTraceEvent(Serial, traceBuffer[divergence]); }
+    else{ Serial.println("end of timeline"); }
+  }
+  return pass;
+}
+
+#else
+
+/**
+ * Print a timeline as a golden array
+ */
+void printGolden(const goldenOperation_t& op, unsigned int length){
+  Serial.print("// "); Serial.print(op.name);
+  Serial.print(": safety violations "); Serial.println(simBoard.getSafetyViolations());
+  Serial.print("const ECD_SimEvent golden_"); Serial.print(op.name); Serial.println("[] = {");
+  for(unsigned int i = 0; i < length; i++){
+    Serial.print("  { ");  Serial.print(traceBuffer[i].timeMs);
+    Serial.print(", ");    Serial.print(eventTypeNames[traceBuffer[i].type]);
+    Serial.print(", ");    Serial.print((int)traceBuffer[i].pin);
+    Serial.print(", ");    Serial.print(traceBuffer[i].value);
+    Serial.println(" },");
+  }
+  Serial.println("};");
+  Serial.println();
+}
+
+#endif
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  configureDisplays();
+  goldenDigit.attachSimulator(&simBoard);
+  goldenBars.attachSimulator(&simBoard);
+
+#ifdef GOLDEN_CHECK
+  unsigned int failures = 0;
+  for(unsigned int i = 0; i < GOLDEN_NUM_OPERATIONS; i++){
+    unsigned int length = recordOperation(operations[i]);
+    failures += checkOperation(operations[i], length) ? 0 : 1;
+  }
+  Serial.print("{\"operations\":"); Serial.print((unsigned int)GOLDEN_NUM_OPERATIONS);
+  Serial.print(",\"failures\":");   Serial.print(failures);
+  Serial.println("}");
+#else
+  Serial.println("// GoldenTraces.h - generated by GoldenTrace.ino, do not edit");
+  Serial.println("#pragma once");
+  Serial.println();
+  for(unsigned int i = 0; i < GOLDEN_NUM_OPERATIONS; i++){
+    printGolden(operations[i], recordOperation(operations[i]));
+  }
+  Serial.println("struct goldenTrace_t { const char* name; const ECD_SimEvent* events; unsigned int length; };");
+  Serial.println("const goldenTrace_t goldenTraces[] = {");
+  for(unsigned int i = 0; i < GOLDEN_NUM_OPERATIONS; i++){
+    Serial.print("  { \""); Serial.print(operations[i].name);
+    Serial.print("\", golden_");  Serial.print(operations[i].name);
+    Serial.print(", sizeof(golden_"); Serial.print(operations[i].name);
+    Serial.println(") / sizeof(ECD_SimEvent) },");
+  }
+  Serial.println("};");
+#endif
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("GoldenTrace runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
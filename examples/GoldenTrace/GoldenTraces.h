@@ -0,0 +1,836 @@
+// GoldenTraces.h - generated by GoldenTrace.ino, do not edit
+#pragma once
+
+// begin_7seg: safety violations 0
+const ECD_SimEvent golden_begin_7seg[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 238 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 400, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 400, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 8, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 7, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 5, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 6, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 4, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 3, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 1, 289 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 2, 289 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 850, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 850, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 850, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 8, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 7, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 5, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 6, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 4, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 3, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 1, 852 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 2, 852 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 900, ECD_SIM_EVENT_ANALOG_WRITE, 100, 238 },
+  { 900, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 950, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1300, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1300, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1300, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 8, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 7, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 5, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 6, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 4, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 3, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 1, 359 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 2, 359 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1350, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 1350, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1350, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1350, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 8, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 7, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 5, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 6, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 4, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 3, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 1, 387 },
+  { 1400, ECD_SIM_EVENT_ANALOG_READ, 2, 387 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1400, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+// digit_0_to_1: safety violations 0
+const ECD_SimEvent golden_digit_0_to_1[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 8, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 7, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 5, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 6, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 4, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 3, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 1, 402 },
+  { 50, ECD_SIM_EVENT_ANALOG_READ, 2, 402 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 50, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 50, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 50, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 100, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 1 },
+  { 100, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 100, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 8, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 7, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 5, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 6, 417 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 4, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 3, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 1, 865 },
+  { 500, ECD_SIM_EVENT_ANALOG_READ, 2, 417 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 500, ECD_SIM_EVENT_PHASE, 0, 4 },
+  { 500, ECD_SIM_EVENT_ANALOG_WRITE, 100, 204 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 550, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 0 },
+  { 550, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 550, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 550, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 550, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 650, ECD_SIM_EVENT_ANALOG_READ, 6, 18 },
+  { 650, ECD_SIM_EVENT_ANALOG_READ, 2, 18 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 650, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 650, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 650, ECD_SIM_EVENT_ANALOG_WRITE, 100, 238 },
+  { 650, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 700, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1050, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1050, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1050, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 8, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 7, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 5, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 6, 372 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 4, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 3, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 1, 363 },
+  { 1100, ECD_SIM_EVENT_ANALOG_READ, 2, 372 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1100, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1100, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 1100, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 1100, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 1100, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1150, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 1 },
+  { 1150, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 1150, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 1150, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 1150, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1500, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1500, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1500, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 8, 422 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 7, 867 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 5, 867 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 6, 373 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 4, 422 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 3, 422 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 1, 422 },
+  { 1550, ECD_SIM_EVENT_ANALOG_READ, 2, 373 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1550, ECD_SIM_EVENT_PHASE, 0, 4 },
+  { 1550, ECD_SIM_EVENT_ANALOG_WRITE, 100, 204 },
+  { 1550, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1600, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 0 },
+  { 1600, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 1600, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 1600, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 1600, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 1600, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 1600, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 0 },
+  { 1600, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 1600, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1700, ECD_SIM_EVENT_ANALOG_READ, 8, 20 },
+  { 1700, ECD_SIM_EVENT_ANALOG_READ, 4, 20 },
+  { 1700, ECD_SIM_EVENT_ANALOG_READ, 3, 20 },
+  { 1700, ECD_SIM_EVENT_ANALOG_READ, 1, 20 },
+  { 1700, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1700, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+// digit_1_to_7: safety violations 0
+const ECD_SimEvent golden_digit_1_to_7[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 238 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 400, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 400, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 8, 376 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 7, 363 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 5, 363 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 6, 373 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 4, 376 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 3, 376 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 1, 376 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 2, 373 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 850, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 850, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 850, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 8, 860 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 7, 867 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 5, 867 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 6, 859 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 4, 376 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 3, 376 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 1, 376 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 2, 373 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+// bars_level_3: safety violations 0
+const ECD_SimEvent golden_bars_level_3[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 272 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 1, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 1, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 400, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 400, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 4, 273 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 3, 273 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 5, 334 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 2, 272 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 6, 333 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 1, 273 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 7, 334 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 850, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 850, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 850, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 850, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 4, 853 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 3, 306 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 5, 399 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 2, 306 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 6, 397 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 1, 306 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 7, 399 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 900, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 900, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 950, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 1 },
+  { 950, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 950, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1300, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1300, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1300, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1300, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 4, 788 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 3, 852 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 5, 399 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 2, 306 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 6, 397 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 1, 306 },
+  { 1350, ECD_SIM_EVENT_ANALOG_READ, 7, 399 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1350, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1350, ECD_SIM_EVENT_PHASE, 0, 5 },
+  { 1350, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 1350, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1400, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 1 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 1400, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 1 },
+  { 1400, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 1400, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1500, ECD_SIM_EVENT_ANALOG_READ, 4, 994 },
+  { 1500, ECD_SIM_EVENT_ANALOG_READ, 3, 995 },
+  { 1500, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1500, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 1500, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 1500, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 1500, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1550, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 1550, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 1550, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1900, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1900, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1900, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1900, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 4, 856 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 3, 845 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 5, 862 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 2, 306 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 6, 397 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 1, 306 },
+  { 1950, ECD_SIM_EVENT_ANALOG_READ, 7, 399 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1950, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1950, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+// bars_level_3_to_5: safety violations 0
+const ECD_SimEvent golden_bars_level_3_to_5[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 1 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 400, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 400, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 4, 856 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 3, 845 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 5, 801 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 2, 852 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 6, 397 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 1, 306 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 7, 399 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 5 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 1 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 4, 1008 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 3, 1006 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 5, 997 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 2, 995 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 600, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 600, ECD_SIM_EVENT_PHASE, 0, 2 },
+  { 600, ECD_SIM_EVENT_ANALOG_WRITE, 100, 579 },
+  { 600, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 650, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 1 },
+  { 650, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 650, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1000, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1000, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 1000, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 1000, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 4, 896 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 3, 889 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 5, 864 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 2, 845 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 6, 862 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 1, 306 },
+  { 1050, ECD_SIM_EVENT_ANALOG_READ, 7, 399 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 1050, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 1050, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+// cancel_mid_pulse: safety violations 0
+const ECD_SimEvent golden_cancel_mid_pulse[] = {
+  { 0, ECD_SIM_EVENT_PHASE, 0, 1 },
+  { 0, ECD_SIM_EVENT_ANALOG_WRITE, 100, 238 },
+  { 0, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 8, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 8, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 7, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 7, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 5, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 5, 1 },
+  { 50, ECD_SIM_EVENT_DIGITAL_WRITE, 6, 0 },
+  { 50, ECD_SIM_EVENT_PIN_MODE, 6, 1 },
+  { 50, ECD_SIM_EVENT_DELAY, 0, 350 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 400, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 0 },
+  { 400, ECD_SIM_EVENT_PHASE, 0, 3 },
+  { 400, ECD_SIM_EVENT_ANALOG_WRITE, 100, 511 },
+  { 400, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 8, 362 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 7, 303 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 5, 369 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 6, 361 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 4, 895 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 3, 889 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 1, 307 },
+  { 450, ECD_SIM_EVENT_ANALOG_READ, 2, 845 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 450, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 450, ECD_SIM_EVENT_PHASE, 0, 4 },
+  { 450, ECD_SIM_EVENT_ANALOG_WRITE, 100, 208 },
+  { 450, ECD_SIM_EVENT_DELAY, 0, 50 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 500, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 500, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 500, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 4, 152 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 3, 150 },
+  { 600, ECD_SIM_EVENT_ANALOG_READ, 2, 136 },
+  { 600, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 600, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 600, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 600, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 600, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 700, ECD_SIM_EVENT_ANALOG_READ, 4, 78 },
+  { 700, ECD_SIM_EVENT_ANALOG_READ, 3, 77 },
+  { 700, ECD_SIM_EVENT_ANALOG_READ, 2, 70 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 700, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 700, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 700, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 800, ECD_SIM_EVENT_ANALOG_READ, 4, 48 },
+  { 800, ECD_SIM_EVENT_ANALOG_READ, 3, 47 },
+  { 800, ECD_SIM_EVENT_ANALOG_READ, 2, 43 },
+  { 800, ECD_SIM_EVENT_DIGITAL_WRITE, 4, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 4, 1 },
+  { 800, ECD_SIM_EVENT_DIGITAL_WRITE, 3, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 3, 1 },
+  { 800, ECD_SIM_EVENT_DIGITAL_WRITE, 2, 0 },
+  { 800, ECD_SIM_EVENT_PIN_MODE, 2, 1 },
+  { 800, ECD_SIM_EVENT_DELAY, 0, 100 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 8, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 7, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 5, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 6, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 4, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 3, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 1, 0 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 2, 0 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 4, 32 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 3, 31 },
+  { 900, ECD_SIM_EVENT_ANALOG_READ, 2, 29 },
+  { 900, ECD_SIM_EVENT_PIN_MODE, 100, 0 },
+  { 900, ECD_SIM_EVENT_PHASE, 0, 0 },
+};
+
+struct goldenTrace_t { const char* name; const ECD_SimEvent* events; unsigned int length; };
+const goldenTrace_t goldenTraces[] = {
+  { "begin_7seg", golden_begin_7seg, sizeof(golden_begin_7seg) / sizeof(ECD_SimEvent) },
+  { "digit_0_to_1", golden_digit_0_to_1, sizeof(golden_digit_0_to_1) / sizeof(ECD_SimEvent) },
+  { "digit_1_to_7", golden_digit_1_to_7, sizeof(golden_digit_1_to_7) / sizeof(ECD_SimEvent) },
+  { "bars_level_3", golden_bars_level_3, sizeof(golden_bars_level_3) / sizeof(ECD_SimEvent) },
+  { "bars_level_3_to_5", golden_bars_level_3_to_5, sizeof(golden_bars_level_3_to_5) / sizeof(ECD_SimEvent) },
+  { "cancel_mid_pulse", golden_cancel_mid_pulse, sizeof(golden_cancel_mid_pulse) / sizeof(ECD_SimEvent) },
+};
@@ -0,0 +1,201 @@
+/*
+	LayeredDisplay.ino - Hand-merged frames against the layered compositor
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	A simulated 7-segment display with dot shows the level (0..9) of a noisy
+	sensor sampled every TICK_MS for RUN_MINUTES minutes:
+	  - base   : the level digit
+	  - overlay: the dot as a warning indicator, from level WARNING_LEVEL up
+	             (SEGMENT_PRIORITY_HIGH)
+	  - blink  : at level 9 the digit blinks (hidden every other BLINK_MS)
+
+	Modes:
+	  - every_tick: the application merges the frame by hand and updates the
+	                display on every sample
+	  - on_change : hand-merged, updated only when the frame changed
+	  - compositor: the layers are written on every sample and ECD_Compositor
+	                commits at most once per WINDOW_MS, only on a change
+
+	One JSON line per mode: display updates, segment changes staged, pulses,
+	charge delivered, drive time, layer toggles cancelled inside a window,
+	and samples where the display differed from the hand-merged frame.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+#include "YnvisibleECDCompositor.h"
+
+#define RUN_MINUTES             10          // Minutes of operation per mode
+#define TICK_MS                 250UL       // (ms) Sensor sample period
+#define WINDOW_MS               2000UL      // (ms) Compositor scheduling window
+#define BLINK_MS                1000UL      // (ms) Blink half-period
+#define SENSOR_PERIOD_MS        240000.0f   // (ms) Period of the sensor swing (0 -> 9 -> 0)
+#define SENSOR_NOISE            0.4f        // Sensor noise (+/- level units)
+#define WARNING_LEVEL           7           // Level that raises the warning dot
+#define DOT_SEGMENT             3           // Dot segment of the 7-segment display
+
+#ifdef YNV_ECD_SIMULATOR
+
+int layeredPinList[EVAL_KIT_7SEG_DOT_NUM_SEGMENTS] = EVAL_KIT_7SEG_DOT_PIN_LIST;
+YNV_ECD layeredDisplay(EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, layeredPinList);
+
+const bool digits[10][7] = {                                 // 7-segment digits (segments a..g)
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+const ecdSegmentMask_t dotMask   = (ecdSegmentMask_t)1 << DOT_SEGMENT;
+const ecdSegmentMask_t digitMask = (((ecdSegmentMask_t)1 << EVAL_KIT_7SEG_DOT_NUM_SEGMENTS) - 1) & ~dotMask;
+
+/**
+ * Segment mask of a digit (segments a..g around the dot)
+ */
+ecdSegmentMask_t digitFrame(int level){
+  ecdSegmentMask_t frame = 0;
+  for(int i = 0, s = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+    if(i != DOT_SEGMENT){
+      frame |= (ecdSegmentMask_t)digits[level][s++] << i;
+    }
+  }
+  return frame;
+}
+
+/**
+ * Noisy sensor level 0..9 (deterministic noise)
+ */
+int sensorLevel(unsigned long t, uint32_t& noiseState){
+  noiseState = noiseState * 1664525UL + 1013904223UL;
+  float noise = ((noiseState >> 8) / 16777216.0f * 2.0f - 1.0f) * SENSOR_NOISE;
+  float phase = (t % (unsigned long)SENSOR_PERIOD_MS) / SENSOR_PERIOD_MS;
+  float value = 0.2f + 9.6f * (phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase) + noise;  // Triangle swing
+  return constrain((int)value, 0, 9);
+}
+
+/**
+ * Frame merged by hand: digit, warning dot, digit hidden in the blink-off halves
+ */
+ecdSegmentMask_t handMerged(int level, unsigned long now, unsigned long blinkStartMs){
+  ecdSegmentMask_t frame = digitFrame(level);
+  if(level >= WARNING_LEVEL){
+    frame |= dotMask;
+  }
+  if(level >= 9 && ((now - blinkStartMs) / BLINK_MS) % 2 == 0){
+    frame &= ~digitMask;                                     // Blink layer shown: digit hidden
+  }
+  return frame;
+}
+
+/**
+ * Run RUN_MINUTES of sensor samples with one update strategy
+ */
+void runMode(const char* name, int mode){
+  YNV_ECD_Simulator sim;
+  ECD_Compositor    compositor(layeredDisplay, WINDOW_MS);
+
+  layeredDisplay.attachSimulator(&sim);
+  layeredDisplay.begin();
+  layeredDisplay.resetStats();
+  sim.resetChargeDelivered();
+  sim.resetSafetyViolations();
+
+  compositor.setLayerPriority(ECD_LAYER_OVERLAY, SEGMENT_PRIORITY_HIGH);
+  compositor.setBlinkPeriod(BLINK_MS);
+  compositor.setLayer(ECD_LAYER_BLINK, 0, digitMask);        // Shown half: digit bleached
+  compositor.showLayer(ECD_LAYER_BLINK, false);
+
+  uint32_t         noiseState   = 12345;
+  unsigned long    start        = sim.millis();
+  unsigned long    nextTick     = start;
+  unsigned long    blinkStartMs = 0;
+  bool             blinking     = false;
+  bool             first        = true;
+  ecdSegmentMask_t lastFrame    = 0;
+  unsigned long    staged       = 0;
+  unsigned int     offSamples   = 0;
+
+  while(sim.millis() - start < RUN_MINUTES * 60000UL){
+    if(sim.millis() < nextTick){
+      sim.advanceTime(nextTick - sim.millis());
+    }
+    unsigned long now   = sim.millis();
+    int           level = sensorLevel(now - start, noiseState);
+
+    if(level >= 9 && !blinking){
+      blinkStartMs = now;
+    }
+    blinking = level >= 9;
+    ecdSegmentMask_t frame = handMerged(level, now, blinkStartMs);
+
+    for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+      if(sim.isSegmentVisiblyColored(i) != (((lastFrame >> i) & 1) != 0)){
+        offSamples++;                                        // Display behind the last requested frame
+        break;
+      }
+    }
+
+    if(mode == 2){
+      compositor.setLayer(ECD_LAYER_BASE, digitFrame(level));
+      if(level >= WARNING_LEVEL){
+        compositor.setSegment(ECD_LAYER_OVERLAY, DOT_SEGMENT, true);
+      }else{
+        compositor.releaseSegment(ECD_LAYER_OVERLAY, DOT_SEGMENT);
+      }
+      compositor.showLayer(ECD_LAYER_BLINK, level >= 9);
+      compositor.service();
+    }else if(mode == 0 || first || frame != lastFrame){
+      for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+        if(mode == 0 || first || (((frame ^ lastFrame) >> i) & 1)){
+          layeredDisplay.setSegmentState(i, (frame >> i) & 1);
+          staged++;
+        }
+      }
+      layeredDisplay.executeDisplay();
+    }
+    lastFrame = frame;
+    first     = false;
+
+    nextTick += TICK_MS;
+    if(nextTick < sim.millis()){
+      nextTick = sim.millis();                               // Update took longer than a sample period
+    }
+  }
+
+  const ECD_Stats&           stats  = layeredDisplay.getStats();
+  const ECD_CompositorStats& layers = compositor.getStats();
+
+  Serial.print("{\"mode\":\"");              Serial.print(name);
+  Serial.print("\",\"updates\":");           Serial.print(stats.executeCount);
+  Serial.print(",\"segments_staged\":");     Serial.print(mode == 2 ? layers.segmentsStaged : staged);
+  Serial.print(",\"pulses\":");              Serial.print(stats.colorPulses + stats.bleachPulses);
+  Serial.print(",\"charge_uC\":");           Serial.print(sim.getChargeDelivered() * 1.0e6f, 1);
+  Serial.print(",\"drive_ms\":");            Serial.print(stats.driveTimeMs);
+  Serial.print(",\"cancelled\":");           Serial.print(layers.cancelledChanges);
+  Serial.print(",\"held_by_window\":");      Serial.print(layers.heldByWindow);
+  Serial.print(",\"off_samples\":");         Serial.print(offSamples);
+  Serial.print(",\"safety_violations\":");   Serial.print(sim.getSafetyViolations());
+  Serial.println("}");
+
+  layeredDisplay.attachSimulator(nullptr);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  runMode("every_tick", 0);
+  runMode("on_change", 1);
+  runMode("compositor", 2);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("LayeredDisplay runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,158 @@
+/*
+	Lifetime.ino - Accelerated lifetime simulation of an ECD_Config
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	Ages a simulated 7-bar display with the aging rates in segmentModel
+	(capacity fade, slower kinetics, faster self-discharge) up to
+	LIFE_TOTAL_CYCLES display cycles. A display cycle colors all bars, holds,
+	bleaches all bars and holds, like a meter going full scale and back.
+
+	Driving every cycle would be slow, so each checkpoint runs a measurement
+	window of LIFE_WINDOW_CYCLES real cycles on the virtual clock, then
+	fast-forwards the age of every segment to the next checkpoint using the
+	aging rate measured in the window.
+
+	One JSON line is printed per checkpoint (latency and energy curves):
+	  - update_ms      : mean executeDisplay() time over the window
+	  - charge_uC      : mean charge per update
+	  - refresh_retries: refresh iterations per update (refresh frequency)
+	  - failures       : refresh loops that hit MAX_REFRESH_RETRIES
+	  - wrong_states   : holds ending with a visibly wrong segment
+	The first checkpoint with failures or wrong states is flagged as the end
+	of life of the configuration under test.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define LIFE_TOTAL_CYCLES       200000UL    // Display cycles to simulate
+#define LIFE_NUM_CHECKPOINTS    20          // Checkpoints over life (linear)
+#define LIFE_WINDOW_CYCLES      5           // Cycles driven at each checkpoint
+#define LIFE_INTERVAL_CYCLES    (LIFE_TOTAL_CYCLES / LIFE_NUM_CHECKPOINTS)
+#define LIFE_HOLD_TIME          1800000UL   // (ms) Hold after each update (self-discharge)
+
+#ifdef YNV_ECD_SIMULATOR
+
+int lifePinList[EVAL_KIT_7BARS_NUM_SEGMENTS] = EVAL_KIT_7BARS_PIN_LIST;
+YNV_ECD lifeDisplay(EVAL_KIT_7BARS_NUM_SEGMENTS, lifePinList);
+YNV_ECD_Simulator simBoard;
+
+ECD_Config        lifeConfig;               // Configuration under test
+ECD_SegmentModel  segmentModel;             // Segment parameters, aging rates set in setup()
+
+/**
+ * Drive one display cycle: all bars colored, hold, all bars bleached, hold
+ * @returns number of updates leaving a visibly wrong segment
+ */
+unsigned int runCycle(){
+  unsigned int wrongStates = 0;
+
+  for(int level = 1; level >= 0; level--){
+    for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+      lifeDisplay.setSegmentState(i, level);
+    }
+    lifeDisplay.executeDisplay();
+    simBoard.advanceTime(LIFE_HOLD_TIME);
+    lifeDisplay.executeDisplay();                   // Periodic refresh after the hold
+
+    for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+      if(simBoard.isSegmentVisiblyColored(i) != (level == 1)){
+        wrongStates++;
+        break;
+      }
+    }
+  }
+  return wrongStates;
+}
+
+/**
+ * Mean age of the display segments in full equivalent cycles
+ */
+float meanSegmentCycles(){
+  float sum = 0.0f;
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    sum += simBoard.getSegmentCycles(i);
+  }
+  return sum / EVAL_KIT_7BARS_NUM_SEGMENTS;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  // Aging rates per full equivalent cycle of a segment
+  segmentModel.capacityFade       = 5.0e-6f;    // -25 % capacity after 50k full cycles
+  segmentModel.kineticsAging      = 1.0e-4f;    // 6x Rct after 50k full cycles
+  segmentModel.selfDischargeAging = 2.0e-4f;    // 11x self-discharge rate after 50k full cycles
+
+  lifeDisplay.attachSimulator(&simBoard);
+  lifeDisplay.setConfig(lifeConfig);
+  simBoard.setAllSegmentsModel(segmentModel);
+  lifeDisplay.begin();
+
+  unsigned long cycle     = 0;
+  long          endOfLife = -1;
+
+  for(int checkpoint = 0; checkpoint <= LIFE_NUM_CHECKPOINTS; checkpoint++){
+    float agedCycles[EVAL_KIT_7BARS_NUM_SEGMENTS];
+
+    for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+      agedCycles[i] = simBoard.getSegmentCycles(i);
+    }
+
+    // Measurement window: real cycles on the virtual clock
+    unsigned int wrongStates = 0;
+    lifeDisplay.resetStats();
+    simBoard.resetChargeDelivered();
+    for(int n = 0; n < LIFE_WINDOW_CYCLES; n++){
+      wrongStates += runCycle();
+    }
+    cycle += LIFE_WINDOW_CYCLES;
+
+    const ECD_Stats& stats = lifeDisplay.getStats();
+    float updates = (float)stats.executeCount;
+
+    Serial.print("{\"cycle\":");             Serial.print(cycle);
+    Serial.print(",\"days\":");              Serial.print((float)cycle * 2 * LIFE_HOLD_TIME / 86400000.0f, 1);
+    Serial.print(",\"segment_cycles\":");    Serial.print(meanSegmentCycles(), 0);
+    Serial.print(",\"update_ms\":");         Serial.print(stats.driveTimeMs / updates, 1);
+    Serial.print(",\"charge_uC\":");         Serial.print(simBoard.getChargeDelivered() * 1.0e6f / updates, 1);
+    Serial.print(",\"refresh_retries\":");   Serial.print(stats.refreshRetries / updates, 2);
+    Serial.print(",\"failures\":");          Serial.print(stats.refreshFailures);
+    Serial.print(",\"wrong_states\":");      Serial.print(wrongStates);
+    Serial.println("}");
+
+    if((stats.refreshFailures > 0 || wrongStates > 0) && endOfLife < 0){
+      endOfLife = cycle;
+    }
+
+    // Fast-forward every segment to the next checkpoint at its measured aging rate
+    if(checkpoint < LIFE_NUM_CHECKPOINTS){
+      unsigned long skipped = LIFE_INTERVAL_CYCLES - LIFE_WINDOW_CYCLES;
+
+      for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+        float rate = (simBoard.getSegmentCycles(i) - agedCycles[i]) / LIFE_WINDOW_CYCLES;
+        simBoard.setSegmentCycles(i, simBoard.getSegmentCycles(i) + rate * skipped);
+      }
+      cycle += skipped;
+    }
+  }
+
+  Serial.print("{\"end_of_life_cycle\":");
+  Serial.print(endOfLife);
+  Serial.println(endOfLife < 0 ? ",\"status\":\"converges over the simulated life\"}"
+                               : ",\"status\":\"config failing\"}");
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("Lifetime runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
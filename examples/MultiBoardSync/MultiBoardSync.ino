@@ -0,0 +1,321 @@
+/*
+	MultiBoardSync.ino - Start skew of a sign made of several Driver v5 boards
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	Simulates SYNC_NUM_BOARDS boards, each with its own 7-segment display,
+	simulated board and clock (power-up offset and drift in ppm), linked to a
+	coordinator by a serial bus with latency and jitter. Every update stages a
+	different digit on each board (ECD_SyncCoordinator::stageFrame()) and
+	commits it, in three modes:
+	  - no_sync : tick commit without clock offsets (boards assume offset 0)
+	  - tick    : syncClock() of every board before each tick commit
+	  - trigger : syncClock() (for the reports), then commit on a shared trigger
+	              line, asserted after the lead time
+	  - lossy   : tick mode where every other update loses one FRAME message of
+	              one board (as a frame dropped for a bad checksum). The board
+	              refuses the commit and answers STATUS with a NAK; the
+	              coordinator stages every board again and commits again
+
+	Reported per mode, as JSON:
+	  - start / completion skew between boards, in true (simulation) time
+	  - completion skew as reported back to the coordinator (DONE messages)
+	  - CE safety violations and visibly wrong segments
+	  - commits refused by a board and commits sent again
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+#include "YnvisibleECDSync.h"
+
+#define SYNC_NUM_BOARDS         4
+#define SYNC_NUM_UPDATES        10          // Updates per mode
+#define SYNC_COMMIT_LEAD_MS     30          // (ms) Commit tick / trigger after the commit message
+#define SYNC_LINK_LATENCY_MS    3           // (ms) Serial bus latency of one message
+#define SYNC_LINK_JITTER        3           // Extra latency 0..SYNC_LINK_JITTER-1 ms per message
+#define SYNC_HOLD_TIME          60000UL     // (ms) Hold between updates
+#define SYNC_TIMEOUT_MS         20000UL     // (ms) Max wait for an update or report
+#define SYNC_QUEUE_CAPACITY     64          // Messages in flight
+#define SYNC_MAX_ATTEMPTS       3           // Commits of one update before giving up
+
+#ifdef YNV_ECD_SIMULATOR
+
+const int  boardPins[EVAL_KIT_7SEG_DOT_NUM_SEGMENTS] = EVAL_KIT_7SEG_DOT_PIN_LIST;
+const long boardClockOffset[SYNC_NUM_BOARDS]         = { 0, 1500, 320, 2750 };  // (ms) Power-up offsets
+const long boardDriftPpm[SYNC_NUM_BOARDS]            = { 80, -50, 20, -100 };   // Clock drift
+
+// Same layout as the Eval Kit 7-segment masks; the dot (index 3) stays OFF
+const bool digitMasks[10][7] = {
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+/* ---- Simulated serial bus: coordinator = endpoint 0, board b = endpoint b + 1 ---- */
+
+struct pendingMessage_t {
+  ECD_SyncMessage message;
+  int             endpoint;
+  unsigned long   deliverMs;
+};
+
+pendingMessage_t queue[SYNC_QUEUE_CAPACITY];
+unsigned int     queueLength = 0;
+unsigned long    trueMs      = 0;                   // Simulation (true) time
+unsigned long    lastDeliverMs[SYNC_NUM_BOARDS + 1];
+uint32_t         jitterSeed  = 1;
+int              dropFrameTo = -1;                  // Board whose next FRAME is lost (-1 = none)
+
+void enqueue(int endpoint, const ECD_SyncMessage& message){
+  jitterSeed = jitterSeed * 1664525UL + 1013904223UL;
+  unsigned long deliverMs = trueMs + SYNC_LINK_LATENCY_MS + (jitterSeed >> 24) % SYNC_LINK_JITTER;
+
+  if(message.type == ECD_SYNC_MSG_FRAME && message.board == dropFrameTo && endpoint == dropFrameTo + 1){
+    dropFrameTo = -1;                               // Lost on the way to the addressed board
+    return;
+  }
+  deliverMs = max(deliverMs, lastDeliverMs[endpoint]);      // A serial link keeps the order
+  lastDeliverMs[endpoint] = deliverMs;
+  if(queueLength < SYNC_QUEUE_CAPACITY){
+    queue[queueLength++] = { message, endpoint, deliverMs };
+  }
+}
+
+class SimSyncLink : public ECD_SyncLink {
+public:
+  explicit SimSyncLink(int endpoint) : m_endpoint(endpoint) {}
+
+  void send(const ECD_SyncMessage& message) override {
+    if(m_endpoint == 0){
+      for(int b = 1; b <= SYNC_NUM_BOARDS; b++){ enqueue(b, message); }
+    }
+    else{
+      enqueue(0, message);
+    }
+  }
+
+  bool receive(ECD_SyncMessage& message) override {
+    for(unsigned int i = 0; i < queueLength; i++){
+      if(queue[i].endpoint == m_endpoint && queue[i].deliverMs <= trueMs){
+        message = queue[i].message;
+        for(unsigned int j = i + 1; j < queueLength; j++){ queue[j - 1] = queue[j]; }
+        queueLength--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  int m_endpoint;
+};
+
+unsigned long coordinatorClock(){ return trueMs; }
+
+SimSyncLink         coordinatorLink(0);
+ECD_SyncCoordinator coordinator(coordinatorLink, SYNC_NUM_BOARDS, coordinatorClock);
+
+YNV_ECD_Sized<EVAL_KIT_7SEG_DOT_NUM_SEGMENTS> displays[SYNC_NUM_BOARDS] = {
+  { EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, boardPins }, { EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, boardPins },
+  { EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, boardPins }, { EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, boardPins }
+};
+YNV_ECD_Simulator simBoards[SYNC_NUM_BOARDS];
+SimSyncLink       boardLinks[SYNC_NUM_BOARDS]  = { SimSyncLink(1), SimSyncLink(2), SimSyncLink(3), SimSyncLink(4) };
+ECD_SyncBoard     boards[SYNC_NUM_BOARDS]      = {
+  { displays[0], boardLinks[0], 0 }, { displays[1], boardLinks[1], 1 },
+  { displays[2], boardLinks[2], 2 }, { displays[3], boardLinks[3], 3 }
+};
+
+double        trueStartMs[SYNC_NUM_BOARDS];         // True time of the last start / completion of each board
+double        trueEndMs[SYNC_NUM_BOARDS];
+unsigned long triggerMs = 0;                        // True time of the trigger line edge (0 = none)
+
+/* ---- Board clocks ---- */
+
+unsigned long boardLocalMs(int b, unsigned long t){
+  return (unsigned long)(boardClockOffset[b] + t + ((double)t * boardDriftPpm[b]) / 1e6);
+}
+
+double boardTrueMs(int b, unsigned long local){
+  return (double)(local - boardClockOffset[b]) / (1.0 + boardDriftPpm[b] / 1e6);
+}
+
+/**
+ * Advance the simulation by 1 ms: coordinator, trigger line, every board
+ * that is not still busy in an update
+ */
+void step(){
+  trueMs++;
+  coordinator.poll();
+
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+    unsigned long local = boardLocalMs(b, trueMs);
+    if((long)(local - simBoards[b].millis()) < 0){
+      continue;                                     // Board clock ahead: still executing
+    }
+    simBoards[b].advanceTime(local - simBoards[b].millis());
+
+    if(triggerMs != 0 && trueMs == triggerMs){
+      boards[b].trigger();                          // Same line edge on every board
+    }
+    boards[b].poll();
+    if(boards[b].run()){
+      trueStartMs[b] = boardTrueMs(b, boards[b].getLastStartMs());
+      trueEndMs[b]   = boardTrueMs(b, boards[b].getLastEndMs());
+    }
+  }
+}
+
+bool stepUntil(bool (*done)(uint16_t), uint16_t sequence){
+  for(unsigned long waited = 0; waited < SYNC_TIMEOUT_MS; waited++){
+    if(done(sequence)){ return true; }
+    step();
+  }
+  return false;
+}
+
+unsigned long refusedBefore[SYNC_NUM_BOARDS];       // getRefusedCommits() of each board before the commit
+
+bool boardsCompleted(uint16_t sequence){
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+    bool refused = boards[b].getRefusedCommits() != refusedBefore[b];
+    if(!refused && (boards[b].getCompletedSequence() != sequence || boards[b].isArmed())){ return false; }
+  }
+  return true;
+}
+
+bool boardsReported(uint16_t sequence){
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+    if(!coordinator.isDone(b, sequence) && !coordinator.isRefused(b, sequence)){ return false; }
+  }
+  return true;
+}
+
+double spread(const double* values){
+  double low = values[0], high = values[0];
+  for(int b = 1; b < SYNC_NUM_BOARDS; b++){
+    low  = min(low, values[b]);
+    high = max(high, values[b]);
+  }
+  return high - low;
+}
+
+/**
+ * Run SYNC_NUM_UPDATES synchronized updates and print the result as JSON
+ */
+void runMode(const char* name, bool syncClocks, bool trigger, bool lossy = false){
+  double        maxStartSkew = 0, maxEndSkew = 0;
+  unsigned long maxReportedSkew = 0;
+  unsigned int  wrongSegments = 0, safetyViolations = 0, timeouts = 0, recommits = 0;
+  unsigned long refusedCommits = 0;
+
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){ simBoards[b].resetSafetyViolations(); }
+
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){ refusedBefore[b] = boards[b].getRefusedCommits(); }
+
+  for(int update = 0; update < SYNC_NUM_UPDATES; update++){
+    bool frames[SYNC_NUM_BOARDS][EVAL_KIT_7SEG_DOT_NUM_SEGMENTS];
+
+    if(syncClocks){
+      for(int b = 0; b < SYNC_NUM_BOARDS; b++){ coordinator.syncClock(b); }
+      for(int i = 0; i < 4 * (SYNC_LINK_LATENCY_MS + SYNC_LINK_JITTER); i++){ step(); }
+    }
+
+    for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+      uint8_t maskIterator = 0;
+      for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+        frames[b][i] = (i == 3) ? false : digitMasks[(update + 3 * b) % 10][maskIterator++];
+      }
+    }
+    if(lossy && update % 2 == 0){
+      dropFrameTo = (update / 2) % SYNC_NUM_BOARDS;
+    }
+
+    uint16_t sequence = 0;
+    for(int attempt = 0; attempt < SYNC_MAX_ATTEMPTS; attempt++){
+      bool refused = false;
+
+      for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+        refusedBefore[b] = boards[b].getRefusedCommits();
+        coordinator.stageFrame(b, frames[b], EVAL_KIT_7SEG_DOT_NUM_SEGMENTS);
+      }
+      if(trigger){
+        sequence  = coordinator.commitOnTrigger();
+        triggerMs = trueMs + SYNC_COMMIT_LEAD_MS;
+      }
+      else{
+        sequence  = coordinator.commit(SYNC_COMMIT_LEAD_MS);
+      }
+
+      timeouts += stepUntil(boardsCompleted, sequence) ? 0 : 1;
+      triggerMs = 0;
+      for(int b = 0; b < SYNC_NUM_BOARDS; b++){ coordinator.requestStatus(b); }
+      timeouts += stepUntil(boardsReported, sequence) ? 0 : 1;
+
+      for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+        refused |= coordinator.isRefused(b, sequence);
+      }
+      if(!refused){ break; }
+      recommits++;                                  // Every board again: the others just refresh
+    }
+
+    maxStartSkew    = max(maxStartSkew, spread(trueStartMs));
+    maxEndSkew      = max(maxEndSkew, spread(trueEndMs));
+    maxReportedSkew = max(maxReportedSkew, coordinator.getCompletionSkew(sequence));
+
+    for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+      for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+        if(simBoards[b].isSegmentVisiblyColored(i) != frames[b][i]){ wrongSegments++; }
+      }
+    }
+
+    trueMs += SYNC_HOLD_TIME;                       // Boards catch up on the next step
+    step();
+  }
+
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+    safetyViolations += simBoards[b].getSafetyViolations();
+    refusedCommits   += boards[b].getRefusedCommits();
+  }
+
+  Serial.print("{\"mode\":\"");                     Serial.print(name);
+  Serial.print("\",\"updates\":");                  Serial.print(SYNC_NUM_UPDATES);
+  Serial.print(",\"max_start_skew_ms\":");          Serial.print(maxStartSkew, 1);
+  Serial.print(",\"max_completion_skew_ms\":");     Serial.print(maxEndSkew, 1);
+  Serial.print(",\"max_reported_completion_skew_ms\":"); Serial.print(maxReportedSkew);
+  Serial.print(",\"timeouts\":");                   Serial.print(timeouts);
+  Serial.print(",\"safety_violations\":");          Serial.print(safetyViolations);
+  Serial.print(",\"wrong_segments\":");             Serial.print(wrongSegments);
+  Serial.print(",\"refused_commits\":");            Serial.print(refusedCommits);
+  Serial.print(",\"recommits\":");                  Serial.print(recommits);
+  Serial.println("}");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  for(int b = 0; b < SYNC_NUM_BOARDS; b++){
+    displays[b].attachSimulator(&simBoards[b]);
+    simBoards[b].advanceTime(boardLocalMs(b, 0));
+    displays[b].begin();                            // Power-up sequence, before the sign starts
+  }
+  trueMs = SYNC_HOLD_TIME;
+  step();
+
+  runMode("no_sync", false, false);
+  runMode("tick",    true,  false);
+  runMode("trigger", true,  true);
+  runMode("lossy",   true,  false, true);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("MultiBoardSync runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,183 @@
+/*
+	MuxSweep.ino - OCP sweep of a 64-segment expander panel through analog muxes
+	For a host build with YNV_ECD_SIMULATOR and YNV_ECD_HAL_EXPANDER defined
+
+	The 64 WE pins sit on four simulated 16-output expanders; each expander
+	output is also wired to the same channel of one of four 16:1 analog muxes
+	(shared select lines, one ADC input per mux, ECD_SimAnalogMux).
+
+	Time of one OCP sweep (mux settles + ADC reads, MUX_SETTLE_US and
+	MUX_ADC_READ_US), measured on the simulator clock (micros()) and printed
+	as JSON for:
+	  - direct_15     : the 15-segment Eval Kit display, ADC on every WE
+	  - mux_64_per_pin: 64 segments read one by one in pin order
+	  - mux_64_scan   : 64 segments in one scheduled scan (setOcpSensor())
+	The sweep time leaves out the CE settle; the check_64 line times a whole
+	refresh check of the panel through the engine, CE settles included.
+
+	Then a checkerboard / inverse / hold workload runs on the panel with the
+	scheduled scan, and reports the mux activity, refresh pulses, CE safety
+	violations and visibly wrong segments.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleECD.h"
+
+#ifdef YNV_ECD_SIMULATOR
+#include "YnvisibleECDSimulator.h"
+#endif
+
+#define PANEL_NUM_CHIPS         4
+#define PANEL_NUM_SEGMENTS      (PANEL_NUM_CHIPS * ECD_EXPANDER_PINS_PER_CHIP)
+#define PANEL_HOLD_TIME         3600000UL   // (ms) Hold between updates (self-discharge)
+#define PANEL_NUM_CYCLES        3           // Checkerboard / inverse / hold cycles
+#define MUX_SELECT_BITS         4           // 16:1 muxes
+#define MUX_SETTLE_US           10          // (us) Mux settle time after a channel switch
+#define MUX_ADC_READ_US         50          // (us) One analogRead() conversion
+#define DIRECT_NUM_SEGMENTS     15          // Eval Kit 15-segment display
+
+#if defined(YNV_ECD_SIMULATOR) && defined(YNV_ECD_HAL_EXPANDER)
+
+// The 16 outputs of one expander chip
+#define PANEL_CHIP_PINS(c) \
+  ECD_EXPANDER_PIN(c, 0),  ECD_EXPANDER_PIN(c, 1),  ECD_EXPANDER_PIN(c, 2),  ECD_EXPANDER_PIN(c, 3),  \
+  ECD_EXPANDER_PIN(c, 4),  ECD_EXPANDER_PIN(c, 5),  ECD_EXPANDER_PIN(c, 6),  ECD_EXPANDER_PIN(c, 7),  \
+  ECD_EXPANDER_PIN(c, 8),  ECD_EXPANDER_PIN(c, 9),  ECD_EXPANDER_PIN(c, 10), ECD_EXPANDER_PIN(c, 11), \
+  ECD_EXPANDER_PIN(c, 12), ECD_EXPANDER_PIN(c, 13), ECD_EXPANDER_PIN(c, 14), ECD_EXPANDER_PIN(c, 15)
+
+const int panelPinList[PANEL_NUM_SEGMENTS] = { PANEL_CHIP_PINS(0), PANEL_CHIP_PINS(1), PANEL_CHIP_PINS(2), PANEL_CHIP_PINS(3) };
+YNV_ECD_Sized<PANEL_NUM_SEGMENTS> panel(PANEL_NUM_SEGMENTS, panelPinList);
+YNV_ECD_Simulator  simBoard;
+ECD_SimExpanderBus expanderBus(simBoard);
+ECD_SimAnalogMux   ocpMux(simBoard, MUX_SELECT_BITS, PANEL_NUM_CHIPS, MUX_SETTLE_US);
+
+unsigned int wrongSegments = 0;
+
+/**
+ * Print one OCP sweep and its simulator time (CE settle excluded) as JSON
+ */
+void printSweep(const char* name, const ECD_MuxStats& stats, unsigned long sweepMicros){
+  Serial.print("{\"sweep\":\"");                Serial.print(name);
+  Serial.print("\",\"channel_switches\":");      Serial.print(stats.channelSwitches);
+  Serial.print(",\"select_toggles\":");          Serial.print(stats.selectToggles);
+  Serial.print(",\"reads\":");                   Serial.print(stats.reads);
+  Serial.print(",\"sweep_us\":");                Serial.print(sweepMicros);
+  Serial.println("}");
+}
+
+/**
+ * Time one full sweep: direct ADC reference, per-pin mux reads, scheduled scan
+ */
+void runSweeps(){
+  ECD_MuxStats  direct;
+  uint8_t       indices[PANEL_NUM_SEGMENTS];
+  uint16_t      values[PANEL_NUM_SEGMENTS];
+  unsigned long start;
+
+  start = simBoard.micros();
+  for(int i = 0; i < DIRECT_NUM_SEGMENTS; i++){
+    values[i] = simBoard.analogRead(panelPinList[i]);
+  }
+  direct.reads = DIRECT_NUM_SEGMENTS;
+  printSweep("direct_15", direct, simBoard.micros() - start);
+
+  ocpMux.resetMuxStats();
+  start = simBoard.micros();
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    values[i] = ocpMux.read(panelPinList[i]);
+  }
+  printSweep("mux_64_per_pin", ocpMux.getMuxStats(), simBoard.micros() - start);
+
+  ocpMux.resetMuxStats();
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    indices[i] = i;
+  }
+  start = simBoard.micros();
+  ocpMux.scan(panelPinList, indices, PANEL_NUM_SEGMENTS, values);
+  printSweep("mux_64_scan", ocpMux.getMuxStats(), simBoard.micros() - start);
+}
+
+/**
+ * Time one refresh check of the settled panel through the engine (CE settles included)
+ */
+void runCheck(){
+  ocpMux.resetMuxStats();
+  panel.resetStats();
+  unsigned long start = simBoard.micros();
+  panel.executeDisplay();                             // Same frame: OCP check only
+  unsigned long checkMicros = simBoard.micros() - start;
+
+  Serial.print("{\"check\":\"panel_64\"");
+  Serial.print(",\"ce_settles\":");              Serial.print(panel.getStats().ceSettles);
+  Serial.print(",\"reads\":");                   Serial.print(ocpMux.getMuxStats().reads);
+  Serial.print(",\"pulses\":");                  Serial.print(panel.getStats().colorPulses + panel.getStats().bleachPulses);
+  Serial.print(",\"check_us\":");                Serial.print(checkMicros);
+  Serial.println("}");
+}
+
+/**
+ * Apply one frame (checkerboard or its inverse) and count visibly wrong segments
+ */
+void runUpdate(bool inverse){
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    panel.setSegmentState(i, ((i & 1) != 0) != inverse);
+  }
+  panel.executeDisplay();
+
+  for(int i = 0; i < PANEL_NUM_SEGMENTS; i++){
+    if(simBoard.isSegmentVisiblyColored(i) != (((i & 1) != 0) != inverse)){
+      wrongSegments++;
+    }
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  panel.attachSimulator(&simBoard);
+  panel.getHal().attachExpander(&expanderBus, PANEL_NUM_CHIPS);
+  panel.getHal().setOcpSensor(&ocpMux);
+  simBoard.setAdcConversionTime(MUX_ADC_READ_US);
+
+  runSweeps();
+  panel.begin();
+  runCheck();
+
+  ocpMux.resetMuxStats();
+  panel.resetStats();
+  simBoard.resetSafetyViolations();
+  for(int cycle = 0; cycle < PANEL_NUM_CYCLES; cycle++){
+    runUpdate(false);
+    runUpdate(true);
+    simBoard.advanceTime(PANEL_HOLD_TIME);
+    runUpdate(true);                                  // Same frame: refresh only
+  }
+
+  const ECD_MuxStats& mux = ocpMux.getMuxStats();
+
+  Serial.print("{\"run\":\"panel_64\"");
+  Serial.print(",\"scans\":");                   Serial.print(mux.scans);
+  Serial.print(",\"reads\":");                   Serial.print(mux.reads);
+  Serial.print(",\"channel_switches\":");        Serial.print(mux.channelSwitches);
+  Serial.print(",\"settle_us\":");               Serial.print(mux.settleMicros);
+  Serial.print(",\"color_pulses\":");            Serial.print(panel.getStats().colorPulses);
+  Serial.print(",\"bleach_pulses\":");           Serial.print(panel.getStats().bleachPulses);
+  Serial.print(",\"refresh_failures\":");        Serial.print(panel.getStats().refreshFailures);
+  Serial.print(",\"safety_violations\":");       Serial.print(simBoard.getSafetyViolations());
+  Serial.print(",\"wrong_segments\":");          Serial.print(wrongSegments);
+  Serial.println("}");
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("MuxSweep runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR and YNV_ECD_HAL_EXPANDER defined.");
+}
+
+#endif
+
+void loop() {
+}
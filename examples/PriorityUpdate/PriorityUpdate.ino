@@ -0,0 +1,138 @@
+/*
+	PriorityUpdate.ino - Alarm indicator latency with and without a latency-first phase
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	A simulated 7-segment display with dot counts 0..9, one digit every
+	UPDATE_INTERVAL; the dot is an alarm indicator raised and cleared every
+	ALARM_PERIOD updates, in the same updates as a digit change:
+	  - bulk      : the dot waits behind the bleach and color phases
+	  - priority  : setSegmentPriority(dot, SEGMENT_PRIORITY_HIGH), every dot
+	                change is driven first
+	  - raise_only: only the alarm raise is staged with SEGMENT_PRIORITY_HIGH
+	                (per change), the clear goes with the bulk update
+
+	One JSON line per mode: mean and worst alarm time-to-visible, mean digit
+	time-to-visible, mean update time, CE settles, latency-first phases, and
+	updates whose final segments did not match the request.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define UPDATES                 40          // Digit updates per mode
+#define UPDATE_INTERVAL         60000UL     // (ms) Time between the updates
+#define ALARM_PERIOD            3           // Updates between alarm raise and clear
+#define ALARM_SEGMENT           3           // Dot segment (alarm indicator)
+
+#ifdef YNV_ECD_SIMULATOR
+
+int priorityPinList[EVAL_KIT_7SEG_DOT_NUM_SEGMENTS] = EVAL_KIT_7SEG_DOT_PIN_LIST;
+YNV_ECD priorityDisplay(EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, priorityPinList);
+
+const bool digits[10][7] = {                                 // 7-segment digits (segments a..g)
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+/**
+ * Requested state of a segment: digit segments a..g around the dot
+ */
+bool requested(int segment, int digit, bool alarm){
+  if(segment == ALARM_SEGMENT){
+    return alarm;
+  }
+  return digits[digit][segment < ALARM_SEGMENT ? segment : segment - 1];
+}
+
+/**
+ * Count UPDATES digits with one priority setting
+ */
+void runMode(const char* name, bool prioritySegment, bool urgentRaise){
+  YNV_ECD_Simulator sim;
+
+  priorityDisplay.attachSimulator(&sim);
+  priorityDisplay.setSegmentPriority(ALARM_SEGMENT, prioritySegment ? SEGMENT_PRIORITY_HIGH : SEGMENT_PRIORITY_NORMAL);
+  priorityDisplay.begin();
+  priorityDisplay.resetStats();
+  sim.resetSafetyViolations();
+
+  bool          alarm        = false;
+  unsigned int  alarmChanges = 0;
+  unsigned long alarmSumMs   = 0;
+  unsigned long alarmMaxMs   = 0;
+  unsigned long digitSumMs   = 0;
+  unsigned int  mismatches   = 0;
+
+  for(int step = 1; step <= UPDATES; step++){
+    int  digit     = step % 10;
+    bool newAlarm  = (step / ALARM_PERIOD) % 2 == 1;
+    bool alarmEdge = newAlarm != alarm;
+    bool urgent    = prioritySegment || (urgentRaise && newAlarm);
+
+    sim.advanceTime(UPDATE_INTERVAL);
+    for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+      if(i == ALARM_SEGMENT && urgentRaise && newAlarm){
+        priorityDisplay.setSegmentState(i, newAlarm, SEGMENT_PRIORITY_HIGH);
+      }else{
+        priorityDisplay.setSegmentState(i, requested(i, digit, newAlarm));
+      }
+    }
+    priorityDisplay.executeDisplay();
+
+    if(alarmEdge){
+      unsigned long ms = priorityDisplay.getTimeToVisible(urgent ? SEGMENT_PRIORITY_HIGH : SEGMENT_PRIORITY_NORMAL);
+      alarmChanges++;
+      alarmSumMs += ms;
+      alarmMaxMs  = max(alarmMaxMs, ms);
+    }
+    digitSumMs += priorityDisplay.getTimeToVisible(SEGMENT_PRIORITY_NORMAL);
+    alarm = newAlarm;
+
+    for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+      if(sim.isSegmentVisiblyColored(i) != requested(i, digit, alarm)){
+        mismatches++;
+        break;
+      }
+    }
+  }
+
+  const ECD_Stats& stats = priorityDisplay.getStats();
+
+  Serial.print("{\"mode\":\"");              Serial.print(name);
+  Serial.print("\",\"updates\":");           Serial.print(stats.executeCount);
+  Serial.print(",\"alarm_changes\":");       Serial.print(alarmChanges);
+  Serial.print(",\"alarm_ms_mean\":");       Serial.print((float)alarmSumMs / alarmChanges, 1);
+  Serial.print(",\"alarm_ms_max\":");        Serial.print(alarmMaxMs);
+  Serial.print(",\"digit_ms_mean\":");       Serial.print((float)digitSumMs / UPDATES, 1);
+  Serial.print(",\"update_ms_mean\":");      Serial.print((float)stats.driveTimeMs / stats.executeCount, 1);
+  Serial.print(",\"ce_settles\":");          Serial.print(stats.ceSettles);
+  Serial.print(",\"priority_phases\":");     Serial.print(stats.priorityPhases);
+  Serial.print(",\"mismatches\":");          Serial.print(mismatches);
+  Serial.print(",\"safety_violations\":");   Serial.print(sim.getSafetyViolations());
+  Serial.println("}");
+
+  priorityDisplay.setSegmentPriority(ALARM_SEGMENT, SEGMENT_PRIORITY_NORMAL);
+  priorityDisplay.attachSimulator(nullptr);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  runMode("bulk", false, false);
+  runMode("priority", true, false);
+  runMode("raise_only", false, true);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("PriorityUpdate runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
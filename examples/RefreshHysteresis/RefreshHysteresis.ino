@@ -0,0 +1,129 @@
+/*
+	RefreshHysteresis.ino - Refresh rounds with stateless and hysteresis classification
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	A simulated 7-bar display with manufacturing spread and ADC noise holds a
+	pattern for HOLD_DAYS days with an OCP check every CHECK_INTERVAL (e.g. a
+	clock updating its display):
+	  - stateless : every check classifies the segments from scratch
+	  - hysteresis: refreshEntryMarginVoltage + refreshHysteresisVoltage, a
+	                segment enters the due or marginal class only once past
+	                its threshold by the entry margin, and stays in it until
+	                it recovered the hysteresis margin
+	  - spaced    : hysteresis + minRefreshInterval between the rounds of one
+	                polarity
+
+	One JSON line per mode: refresh rounds, marginal segments taken along,
+	classifications held by the hysteresis, rounds deferred, refresh pulses,
+	charge delivered, and the contrast kept (lowest charge of a colored bar,
+	highest charge of a bleached bar, at hourly samples).
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define HOLD_DAYS               2           // Days the pattern is held
+#define HOUR_MS                 3600000UL   // (ms) One hour
+#define CHECK_INTERVAL          600000UL    // (ms) executeDisplay() period (10 min)
+#define SPREAD_SEED             7           // Manufacturing spread of the panel
+#define NOISE_LSB               4.0f        // (LSB rms) ADC noise
+#define RETENTION_MS            43200000.0f // (ms) Nominal self-discharge time constant (12 h)
+#define HYSTERESIS_V            0.03f       // (V) refreshHysteresisVoltage of the hysteresis modes
+#define ENTRY_MARGIN_V          0.01f       // (V) refreshEntryMarginVoltage of the hysteresis modes
+#define ROUND_SPACING_MS        7200000UL   // (ms) minRefreshInterval of the spaced mode (2 h)
+
+#ifdef YNV_ECD_SIMULATOR
+
+int hysteresisPinList[EVAL_KIT_7BARS_NUM_SEGMENTS] = EVAL_KIT_7BARS_PIN_LIST;
+YNV_ECD hysteresisDisplay(EVAL_KIT_7BARS_NUM_SEGMENTS, hysteresisPinList);
+
+const bool pattern[EVAL_KIT_7BARS_NUM_SEGMENTS] = {1, 0, 1, 1, 0, 1, 0};
+
+/**
+ * Hold the pattern for HOLD_DAYS with one classification setting
+ */
+void runMode(const char* name, float entryMargin, float hysteresis, unsigned long spacing){
+  YNV_ECD_Simulator sim;
+  ECD_SegmentModel  nominal;
+  ECD_SegmentSpread spread;
+  ECD_Config        cfg;
+
+  nominal.selfDischargeTime = RETENTION_MS;
+  hysteresisDisplay.attachSimulator(&sim);
+  sim.applySegmentSpread(nominal, spread, SPREAD_SEED);
+  sim.setAdcNoise(NOISE_LSB);
+
+  cfg.refreshEntryMarginVoltage = entryMargin;
+  cfg.refreshHysteresisVoltage  = hysteresis;
+  cfg.minRefreshInterval        = spacing;
+  hysteresisDisplay.setConfig(cfg);
+
+  hysteresisDisplay.begin();
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    hysteresisDisplay.setSegmentState(i, pattern[i]);
+  }
+  hysteresisDisplay.executeDisplay();
+
+  hysteresisDisplay.resetStats();
+  sim.resetChargeDelivered();
+  sim.resetSafetyViolations();
+
+  unsigned long endMs       = sim.millis() + HOLD_DAYS * 24 * HOUR_MS;
+  unsigned long nextHour    = sim.millis() + HOUR_MS;
+  float         minColored  = 1.0f;
+  float         maxBleached = 0.0f;
+
+  while(sim.millis() < endMs){
+    sim.advanceTime(CHECK_INTERVAL);
+    hysteresisDisplay.executeDisplay();
+    if(sim.millis() >= nextHour){
+      for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+        if(pattern[i]){
+          minColored  = min(minColored, sim.getSegmentCharge(i));
+        }else{
+          maxBleached = max(maxBleached, sim.getSegmentCharge(i));
+        }
+      }
+      nextHour += HOUR_MS;
+    }
+  }
+
+  const ECD_Stats& stats = hysteresisDisplay.getStats();
+
+  Serial.print("{\"mode\":\"");              Serial.print(name);
+  Serial.print("\",\"checks\":");            Serial.print(stats.executeCount);
+  Serial.print(",\"refresh_rounds\":");      Serial.print(stats.refreshRounds);
+  Serial.print(",\"marginal_joins\":");      Serial.print(stats.marginalJoins);
+  Serial.print(",\"hysteresis_holds\":");    Serial.print(stats.hysteresisHolds);
+  Serial.print(",\"deferred\":");            Serial.print(stats.deferredRefreshes);
+  Serial.print(",\"refresh_pulses\":");      Serial.print(stats.colorPulses + stats.bleachPulses);
+  Serial.print(",\"charge_uC\":");           Serial.print(sim.getChargeDelivered() * 1.0e6f, 1);
+  Serial.print(",\"min_colored\":");         Serial.print(minColored, 3);
+  Serial.print(",\"max_bleached\":");        Serial.print(maxBleached, 3);
+  Serial.print(",\"safety_violations\":");   Serial.print(sim.getSafetyViolations());
+  Serial.println("}");
+
+  hysteresisDisplay.attachSimulator(nullptr);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  runMode("stateless", 0.0f, 0.0f, 0);
+  runMode("hysteresis", ENTRY_MARGIN_V, HYSTERESIS_V, 0);
+  runMode("spaced", ENTRY_MARGIN_V, HYSTERESIS_V, ROUND_SPACING_MS);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("RefreshHysteresis runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,131 @@
+/*
+	Replay.ino - Replay of a recorded trace through the driving engine
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	Regression harness for refresh-logic changes:
+	  1. Record: a workload runs on a panel with spread parameters and the
+	     simulator records every pin/CE/ADC access (stand-in for a trace
+	     captured from a field panel, one "time,type,pin,value" line per event).
+	  2. Replay: the same workload runs on a fresh simulator whose ADC returns
+	     the recorded readings. The engine must issue exactly the same actions.
+	  3. Replay with a changed configuration (stands for a code change): the
+	     first diverging action is reported with the events around it.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define REPLAY_TRACE_CAPACITY   8192        // Events per trace
+#define REPLAY_HOLD_TIME        1200000UL   // (ms) Time each digit is held
+#define REPLAY_CONTEXT_EVENTS   4           // Events printed around a divergence
+
+#ifdef YNV_ECD_SIMULATOR
+
+int replayPinList[EVAL_KIT_7SEG_DOT_NUM_SEGMENTS] = EVAL_KIT_7SEG_DOT_PIN_LIST;
+
+ECD_SimEvent recordedTrace[REPLAY_TRACE_CAPACITY];
+ECD_SimEvent replayedTrace[REPLAY_TRACE_CAPACITY];
+
+// Same layout as the Eval Kit 7-segment masks; the dot (index 3) stays OFF
+const bool replayDigitMasks[4][7] = {
+  {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1}
+};
+
+/**
+ * Run the workload (begin, then digits 1..4 with long holds) on a fresh
+ * engine attached to a simulator
+ * @returns number of recorded events
+ */
+unsigned int runWorkload(YNV_ECD_Simulator& sim, const ECD_Config& config, ECD_SimEvent* trace){
+  YNV_ECD replayDisplay(EVAL_KIT_7SEG_DOT_NUM_SEGMENTS, replayPinList);
+
+  replayDisplay.setConfig(config);
+  replayDisplay.attachSimulator(&sim);
+  sim.setTraceBuffer(trace, REPLAY_TRACE_CAPACITY);
+
+  replayDisplay.begin();
+  for(int digit = 0; digit < 4; digit++){
+    uint8_t maskIterator = 0;
+    for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+      replayDisplay.setSegmentState(i, (i == 3) ? false : replayDigitMasks[digit][maskIterator++]);
+    }
+    replayDisplay.executeDisplay();
+    sim.advanceTime(REPLAY_HOLD_TIME);
+    replayDisplay.executeDisplay();
+  }
+
+  if(sim.getTraceDropped() > 0){
+    Serial.println("// Trace buffer full: increase REPLAY_TRACE_CAPACITY");
+  }
+  return sim.getTraceLength();
+}
+
+/**
+ * Compare a replayed run with the recording and show where it diverges
+ */
+void reportReplay(const char* name, YNV_ECD_Simulator& sim, unsigned int recordedLength, unsigned int replayedLength){
+  int divergence = YNV_ECD_Simulator::findTraceDivergence(recordedTrace, recordedLength, replayedTrace, replayedLength);
+
+  Serial.print("{\"replay\":\"");        Serial.print(name);
+  Serial.print("\",\"events\":");        Serial.print(replayedLength);
+  Serial.print(",\"read_misses\":");     Serial.print(sim.getReplayMisses());
+  Serial.print(",\"divergence\":");      Serial.print(divergence);
+  Serial.println("}");
+
+  if(divergence < 0){
+    return;
+  }
+
+  unsigned int first = (divergence > REPLAY_CONTEXT_EVENTS) ? divergence - REPLAY_CONTEXT_EVENTS : 0;
+  Serial.println("// recorded (time,type,pin,value):");
+  for(unsigned int i = first; i < min(recordedLength, (unsigned int)divergence + REPLAY_CONTEXT_EVENTS); i++){
+    Serial.print(i == (unsigned int)divergence ? "// > " : "//   ");
+    YNV_ECD_Simulator::printTraceEvent(Serial, recordedTrace[i]);
+  }
+  Serial.println("// replayed:");
+  for(unsigned int i = first; i < min(replayedLength, (unsigned int)divergence + REPLAY_CONTEXT_EVENTS); i++){
+    Serial.print(i == (unsigned int)divergence ? "// > " : "//   ");
+    YNV_ECD_Simulator::printTraceEvent(Serial, replayedTrace[i]);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  ECD_Config config;
+
+  // 1. Recording on a "field" panel
+  YNV_ECD_Simulator fieldPanel;
+  for(int i = 0; i < EVAL_KIT_7SEG_DOT_NUM_SEGMENTS; i++){
+    fieldPanel.addSegment(replayPinList[i]);
+  }
+  fieldPanel.applySegmentSpread(ECD_SegmentModel(), ECD_SegmentSpread(), 42);
+  unsigned int recordedLength = runWorkload(fieldPanel, config, recordedTrace);
+
+  // 2. Replay with the same engine and configuration: actions must match
+  YNV_ECD_Simulator replayBoard;
+  replayBoard.setReplayTrace(recordedTrace, recordedLength);
+  unsigned int replayedLength = runWorkload(replayBoard, config, replayedTrace);
+  reportReplay("same_engine", replayBoard, recordedLength, replayedLength);
+
+  // 3. Replay after a change of the refresh logic
+  YNV_ECD_Simulator changedBoard;
+  changedBoard.setReplayTrace(recordedTrace, recordedLength);
+  config.refreshColorPulseTime = 50;
+  replayedLength = runWorkload(changedBoard, config, replayedTrace);
+  reportReplay("changed_refresh", changedBoard, recordedLength, replayedLength);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("Replay runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
@@ -0,0 +1,66 @@
+/*
+	WaveformVcd.ino - Drive waveforms of the Evaluation Kit as a VCD file
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	Records one Eval Kit operation (WAVEFORM_DIGIT shown on the 7-segment
+	display after a long hold, so the refresh engine also runs) and writes the
+	trace as a Value Change Dump to Serial. Redirect the output to a file and
+	open it with GTKWave:
+
+	  ./WaveformVcd > waveform.vcd && gtkwave waveform.vcd
+
+	Signals: CE DAC code and CE enable, engine phase (bleach, color, check,
+	refresh, direct drive), ADC sample markers and readings, and the mode
+	(driven/High-Z) and level of every segment WE pin.
+
+	Traces captured from a board in the same "time,type,pin,value" format can
+	be loaded into an ECD_SimEvent array and passed to writeTraceVcd() too.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define WAVEFORM_TRACE_CAPACITY   8192        // Events recorded
+#define WAVEFORM_DIGIT            4           // Digit shown during the capture
+#define WAVEFORM_HOLD_TIME        1800000UL   // (ms) Hold before the captured update
+
+#ifdef YNV_ECD_SIMULATOR
+
+YNV_ECD_Simulator simBoard;
+ECD_SimEvent      traceBuffer[WAVEFORM_TRACE_CAPACITY];
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  evaluationKitInit();
+  evaluationKitAttachSimulator(&simBoard);
+  display7SegDotRun(8, true);
+  simBoard.advanceTime(WAVEFORM_HOLD_TIME);
+
+  // Capture, with times relative to the start of the operation
+  unsigned long start = simBoard.millis();
+  simBoard.setTraceBuffer(traceBuffer, WAVEFORM_TRACE_CAPACITY);
+  display7SegDotRun(WAVEFORM_DIGIT, false);
+  unsigned int length = simBoard.getTraceLength();
+  simBoard.setTraceBuffer(nullptr, 0);
+
+  for(unsigned int i = 0; i < length; i++){
+    traceBuffer[i].timeMs -= start;
+  }
+
+  YNV_ECD_Simulator::writeTraceVcd(Serial, traceBuffer, length);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("WaveformVcd runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
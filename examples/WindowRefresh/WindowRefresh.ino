@@ -0,0 +1,138 @@
+/*
+	WindowRefresh.ino - Polled refresh against the event-driven refresh watch
+	For a host build with YNV_ECD_SIMULATOR defined
+
+	A simulated 7-bar display with manufacturing spread (so the segments
+	self-discharge at different rates, around RETENTION_MS) holds a pattern
+	for HOLD_DAYS days:
+	  - polled: executeDisplay() every POLL_INTERVAL, i.e. a CE settle and a
+	    full OCP sweep each time, drifting or not
+	  - watch : startRefreshWatch() once, then refreshWatchStep() every
+	    WATCH_STEP_MS (one window compare of one segment: a CPU conversion
+	    compared in software) and executePendingRefresh() only after an event
+
+	One JSON line per mode: CE settles, CPU conversions (sweep reads, or
+	window compares plus the reads of the refreshes they started), window
+	compare events, refresh pulses, charge delivered, and hourly samples where
+	a segment looked wrong.
+*/
+
+#include <Arduino.h>
+#include "YnvisibleEvaluationKit.h"
+
+#define HOLD_DAYS               2           // Days the pattern is held
+#define HOUR_MS                 3600000UL   // (ms) One hour
+#define POLL_INTERVAL           1800000UL   // (ms) Polled mode: executeDisplay() period
+#define WATCH_STEP_MS           10000UL     // (ms) Watch mode: one segment compared per step
+#define SPREAD_SEED             7           // Manufacturing spread of the panel
+#define RETENTION_MS            43200000.0f // (ms) Nominal self-discharge time constant (12 h)
+
+#ifdef YNV_ECD_SIMULATOR
+
+int windowPinList[EVAL_KIT_7BARS_NUM_SEGMENTS] = EVAL_KIT_7BARS_PIN_LIST;
+YNV_ECD windowDisplay(EVAL_KIT_7BARS_NUM_SEGMENTS, windowPinList);
+
+const bool pattern[EVAL_KIT_7BARS_NUM_SEGMENTS] = {1, 1, 0, 1, 0, 0, 1};
+
+/**
+ * Hourly check: true if any segment looks different from the pattern
+ */
+bool lookWrong(YNV_ECD_Simulator& sim){
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    if(sim.isSegmentVisiblyColored(i) != pattern[i]){
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Hold the pattern for HOLD_DAYS with the polled refresh or the refresh watch
+ */
+void runMode(const char* name, bool watch){
+  YNV_ECD_Simulator sim;
+  ECD_SegmentModel  nominal;
+  ECD_SegmentSpread spread;
+
+  nominal.selfDischargeTime = RETENTION_MS;
+  windowDisplay.attachSimulator(&sim);
+  sim.applySegmentSpread(nominal, spread, SPREAD_SEED);
+  windowDisplay.begin();
+  for(int i = 0; i < EVAL_KIT_7BARS_NUM_SEGMENTS; i++){
+    windowDisplay.setSegmentState(i, pattern[i]);
+  }
+  windowDisplay.executeDisplay();
+  if(watch){
+    windowDisplay.startRefreshWatch();
+  }
+
+  windowDisplay.resetStats();
+  sim.resetChargeDelivered();
+  sim.resetComparatorStats();
+  sim.resetAdcConversions();
+  sim.resetSafetyViolations();
+
+  unsigned long endMs       = sim.millis() + HOLD_DAYS * 24 * HOUR_MS;
+  unsigned long nextHour    = sim.millis() + HOUR_MS;
+  unsigned long nextPoll    = sim.millis() + POLL_INTERVAL;
+  unsigned int  wrongHours  = 0;
+
+  while(sim.millis() < endMs){
+    if(watch){
+      sim.advanceTime(WATCH_STEP_MS);
+      if(windowDisplay.refreshWatchStep()){
+        windowDisplay.executePendingRefresh();
+      }
+    }else{
+      sim.advanceTime(nextPoll - sim.millis());
+      windowDisplay.executeDisplay();
+      nextPoll += POLL_INTERVAL;
+    }
+    if(sim.millis() >= nextHour){
+      wrongHours += lookWrong(sim);
+      nextHour   += HOUR_MS;
+    }
+  }
+  if(watch){
+    windowDisplay.stopRefreshWatch();
+  }
+
+  const ECD_Stats& stats = windowDisplay.getStats();
+
+  Serial.print("{\"mode\":\"");              Serial.print(name);
+  Serial.print("\",\"days\":");              Serial.print(HOLD_DAYS);
+  Serial.print(",\"ce_settles\":");          Serial.print(stats.ceSettles);
+  Serial.print(",\"cpu_conversions\":");     Serial.print(sim.getAdcConversions());
+  Serial.print(",\"window_compares\":");     Serial.print(sim.getComparatorConversions());
+  Serial.print(",\"compare_events\":");      Serial.print(sim.getComparatorEvents());
+  Serial.print(",\"events\":");              Serial.print(stats.watchEvents);
+  Serial.print(",\"refresh_pulses\":");      Serial.print(stats.colorPulses + stats.bleachPulses);
+  Serial.print(",\"charge_uC\":");           Serial.print(sim.getChargeDelivered() * 1.0e6f, 1);
+  Serial.print(",\"drive_ms\":");            Serial.print(stats.driveTimeMs);
+  Serial.print(",\"wrong_hours\":");         Serial.print(wrongHours);
+  Serial.print(",\"safety_violations\":");   Serial.print(sim.getSafetyViolations());
+  Serial.println("}");
+
+  windowDisplay.attachSimulator(nullptr);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+
+  runMode("polled", false);
+  runMode("watch", true);
+}
+
+#else
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("WindowRefresh runs on the segment simulator: build for the host with YNV_ECD_SIMULATOR defined.");
+}
+
+#endif
+
+void loop() {
+}
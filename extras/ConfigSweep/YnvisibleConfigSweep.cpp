@@ -0,0 +1,535 @@
+/**
+ * @file YnvisibleConfigSweep.cpp
+ * @brief Host tool searching ECD_Config pulse times and refresh thresholds for
+ * a fitted display model.
+ *
+ * Runs the same workload (begin + a list of frames with their hold times) on
+ * a simulated display for every configuration of a grid of pulse times and
+ * refresh limit voltages, and prints the Pareto-optimal configurations as
+ * constexpr profiles.
+ *
+ * Responsibilities:
+ *  - Read the segment models of the display from the output of
+ *    extras/SystemId (the "model.<field> = <value>f;" lines of each
+ *    "simBoard.setSegmentModel(<segment>, model);" block), or use the default
+ *    ECD_SegmentModel on a 7-segment bar graph.
+ *  - Read the workload from a frame file, one frame per line:
+ *    "<hold ms> <states>", states one '0' (bleach) or '1' (color) per
+ *    segment from segment 0 ('#' starts a comment); or use a bar graph
+ *    level going up, SWEEP_NUM_FRAMES frames held SWEEP_HOLD_TIME each.
+ *  - Score each configuration on drive time (time inside executeDisplay()),
+ *    charge delivered, refresh retries and contrast margin (lowest colored
+ *    OCP minus highest bleached OCP, right after the periodic refresh of
+ *    each held frame).
+ *  - Evaluate the grid in parallel, one display and simulator per thread.
+ *  - Keep the configurations no other one beats on all four scores, order
+ *    them by the objective given on the command line and print them as a
+ *    header: a constexpr profile table and an ECD_Config accessor.
+ *
+ * Notes:
+ *  - The objective only orders the Pareto front: profile 0 is the best
+ *    configuration for it, the following ones trade it for the other scores.
+ *    With four scores the front is wide, so only the first
+ *    SWEEP_MAX_PROFILES are printed.
+ *  - A configuration with refresh failures (MAX_REFRESH_RETRIES reached)
+ *    on the workload is never printed.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -pthread -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleConfigSweep.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_config_sweep
+ *
+ * Usage:
+ *   ynv_sysid trace.csv > model.txt
+ *   ynv_config_sweep <latency|energy|retries|contrast> [model.txt|-] [frames.txt|-] [threads] > ConfigProfiles.h
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define SWEEP_DEFAULT_SEGMENTS      7           // Bar graph without a model file
+#define SWEEP_NUM_FRAMES            24          // Frames of the default workload
+#define SWEEP_HOLD_TIME             600000UL    // (ms) Time each default frame is held (self-discharge)
+#define SWEEP_MAX_LINE              256         // Model and frame file line length
+#define SWEEP_MAX_PROFILES          8           // Profiles printed from the ordered Pareto front
+
+static const int   coloringTimes[]               = { 200, 300, 400, 500 };
+static const int   bleachingTimes[]              = { 200, 300, 400, 500 };
+static const int   refreshColorPulseTimes[]      = { 25, 50, 100, 200 };
+static const int   refreshBleachPulseTimes[]     = { 10, 25, 50, 100, 200 };
+static const float refreshColorLimitHVoltages[]  = { 1.05f, 1.1f, 1.15f };
+static const float refreshColorLimitLVoltages[]  = { 0.9f, 0.95f, 1.0f };
+static const float refreshBleachLimitHVoltages[] = { 0.25f, 0.3f, 0.35f };
+static const float refreshBleachLimitLVoltages[] = { 0.4f, 0.5f };
+
+#define NUM_OF(array)               (sizeof(array) / sizeof(array[0]))
+#define SWEEP_NUM_CANDIDATES        (NUM_OF(coloringTimes) * NUM_OF(bleachingTimes) * \
+                                     NUM_OF(refreshColorPulseTimes) * NUM_OF(refreshBleachPulseTimes) * \
+                                     NUM_OF(refreshColorLimitHVoltages) * NUM_OF(refreshColorLimitLVoltages) * \
+                                     NUM_OF(refreshBleachLimitHVoltages) * NUM_OF(refreshBleachLimitLVoltages))
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Score the candidates are ordered by.
+ */
+enum sweepObjective_e {
+    SWEEP_OBJECTIVE_LATENCY     = 0,    // Drive time
+    SWEEP_OBJECTIVE_ENERGY      = 1,    // Charge delivered
+    SWEEP_OBJECTIVE_RETRIES     = 2,    // Refresh retries
+    SWEEP_OBJECTIVE_CONTRAST    = 3,    // Contrast margin
+    SWEEP_NUM_OBJECTIVES        = 4
+};
+
+static const char* sweepObjectiveNames[SWEEP_NUM_OBJECTIVES] = { "latency", "energy", "retries", "contrast" };
+
+/**
+ * @brief One configuration of the grid and its scores.
+ */
+struct SweepResult {
+
+    ECD_Config    cfg;
+    unsigned long driveTimeMs           { 0 };
+    unsigned long refreshRetries        { 0 };
+    unsigned long refreshFailures       { 0 };
+    float         chargeMilliCoulomb    { 0.0f };
+    float         contrastVoltage       { 0.0f };
+};
+
+/**
+ * @brief One frame of the workload.
+ */
+struct SweepFrame {
+
+    ecdSegmentMask_t states             { 0 };                  // Bit i set: segment i colored
+    unsigned long    holdMs             { 0 };                  // (ms) Time the frame is held before the next one
+};
+
+/**
+ * @brief ECD_SegmentModel field as printed by extras/SystemId.
+ */
+struct SweepModelField {
+
+    const char*              name;
+    float ECD_SegmentModel::* member;
+};
+
+static const SweepModelField sweepModelFields[] = {
+    { "seriesResistance",         &ECD_SegmentModel::seriesResistance },
+    { "chargeTransferResistance", &ECD_SegmentModel::chargeTransferResistance },
+    { "doubleLayerCapacitance",   &ECD_SegmentModel::doubleLayerCapacitance },
+    { "chargeCapacity",           &ECD_SegmentModel::chargeCapacity },
+    { "bleachedPotential",        &ECD_SegmentModel::bleachedPotential },
+    { "coloredPotential",         &ECD_SegmentModel::coloredPotential },
+    { "restCharge",               &ECD_SegmentModel::restCharge },
+    { "selfDischargeTime",        &ECD_SegmentModel::selfDischargeTime },
+    { "capacityFade",             &ECD_SegmentModel::capacityFade },
+    { "kineticsAging",            &ECD_SegmentModel::kineticsAging },
+    { "selfDischargeAging",       &ECD_SegmentModel::selfDischargeAging },
+    { "neighbourCoupling",        &ECD_SegmentModel::neighbourCoupling },
+    { "polarisationCoupling",     &ECD_SegmentModel::polarisationCoupling }
+};
+
+
+/***************************************************************************/
+/********************************* HELPERS *********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Read the segment models printed by extras/SystemId.
+ *
+ * @return false if the file cannot be read or holds no model
+ */
+/***************************************************************************/
+
+static bool loadModels(const char* t_path, std::vector<ECD_SegmentModel>& t_models)
+{
+  FILE* file = fopen(t_path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char             line[SWEEP_MAX_LINE];
+  ECD_SegmentModel current;
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    char     name[64];
+    float    value;
+    unsigned segment;
+    const char* text = line + strspn(line, " \t");
+
+    if (strncmp(text, "ECD_SegmentModel model;", 23) == 0) {
+      current = ECD_SegmentModel();
+    } else if (sscanf(text, "model.%63[A-Za-z] = %f", name, &value) == 2) {
+      for (const SweepModelField& field : sweepModelFields) {
+        if (strcmp(name, field.name) == 0) {
+          current.*field.member = value;
+        }
+      }
+    } else if (sscanf(text, "simBoard.setSegmentModel(%u", &segment) == 1 && segment < MAX_NUMBER_OF_SEGMENTS) {
+      if (segment >= t_models.size()) {
+        t_models.resize(segment + 1);
+      }
+      t_models[segment] = current;
+    }
+  }
+  fclose(file);
+  return !t_models.empty();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Read the workload frames ("<hold ms> <states>" per line).
+ *
+ * @return false if the file cannot be read, holds no frame or a malformed one
+ */
+/***************************************************************************/
+
+static bool loadFrames(const char* t_path, int t_segments, std::vector<SweepFrame>& t_frames)
+{
+  FILE* file = fopen(t_path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char line[SWEEP_MAX_LINE];
+  bool valid = true;
+  while (valid && fgets(line, sizeof(line), file) != nullptr) {
+    char          states[SWEEP_MAX_LINE];
+    unsigned long hold;
+    const char*   text = line + strspn(line, " \t");
+
+    if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') {
+      continue;
+    }
+    if (sscanf(text, "%lu %255s", &hold, states) != 2 || (int)strlen(states) > t_segments ||
+        strspn(states, "01") != strlen(states)) {
+      fprintf(stderr, "Bad frame line: %s", text);
+      valid = false;
+      continue;
+    }
+
+    SweepFrame frame;
+    frame.holdMs = hold;
+    for (int i = 0; states[i] != '\0'; i++) {
+      if (states[i] == '1') {
+        frame.states |= ((ecdSegmentMask_t)1 << i);
+      }
+    }
+    t_frames.push_back(frame);
+  }
+  fclose(file);
+  return valid && !t_frames.empty();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Default workload: bar-graph level going up, frame n colors the
+ * n lowest bars.
+ */
+/***************************************************************************/
+
+static void barGraphFrames(int t_segments, std::vector<SweepFrame>& t_frames)
+{
+  for (int frame = 0; frame < SWEEP_NUM_FRAMES; frame++) {
+    int        level = frame % (t_segments + 1);
+    SweepFrame bars;
+
+    for (int i = 0; i < level; i++) {
+      bars.states |= ((ecdSegmentMask_t)1 << i);
+    }
+    bars.holdMs = SWEEP_HOLD_TIME;
+    t_frames.push_back(bars);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Worst-case contrast of a frame: lowest OCP of the colored segments
+ * minus highest OCP of the bleached segments.
+ *
+ * @return contrast in V, or 10 V if the frame has a single state
+ */
+/***************************************************************************/
+
+static float frameContrast(YNV_ECD_Simulator& t_sim, int t_segments, ecdSegmentMask_t t_states)
+{
+  float minColor  = 10.0f;
+  float maxBleach = -10.0f;
+
+  for (int i = 0; i < t_segments; i++) {
+    float ocp = t_sim.getSegmentOcp(i);
+    if (t_states & ((ecdSegmentMask_t)1 << i)) {
+      minColor = std::min(minColor, ocp);
+    } else {
+      maxBleach = std::max(maxBleach, ocp);
+    }
+  }
+  if (minColor > 9.0f || maxBleach < -9.0f) {       // All colored or all bleached: nothing to compare
+    return 10.0f;
+  }
+  return minColor - maxBleach;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Run the workload with one configuration on a fresh display.
+ */
+/***************************************************************************/
+
+static void runWorkload(const std::vector<ECD_SegmentModel>& t_models, const std::vector<SweepFrame>& t_frames,
+                        SweepResult& t_result)
+{
+  int               segments = (int)t_models.size();
+  std::vector<int>  pins(segments);
+  YNV_ECD_Simulator sim;
+
+  for (int i = 0; i < segments; i++) {
+    pins[i] = i + 1;
+    sim.setSegmentModel(i, t_models[i]);
+    sim.setSegmentCharge(i, t_models[i].restCharge);
+  }
+
+  YNV_ECD display(segments, pins.data());
+  display.attachSimulator(&sim);
+  display.setConfig(t_result.cfg);
+  display.begin();
+  display.resetStats();
+  sim.resetChargeDelivered();
+
+  t_result.contrastVoltage = 10.0f;
+  for (const SweepFrame& frame : t_frames) {
+    for (int i = 0; i < segments; i++) {
+      display.setSegmentState(i, (frame.states & ((ecdSegmentMask_t)1 << i)) != 0);
+    }
+    display.executeDisplay();
+    sim.advanceTime(frame.holdMs);
+    display.executeDisplay();                                       // Periodic refresh after the hold
+    t_result.contrastVoltage = std::min(t_result.contrastVoltage, frameContrast(sim, segments, frame.states));
+  }
+
+  t_result.driveTimeMs        = display.getStats().driveTimeMs;
+  t_result.refreshRetries     = display.getStats().refreshRetries;
+  t_result.refreshFailures    = display.getStats().refreshFailures;
+  t_result.chargeMilliCoulomb = sim.getChargeDelivered() * 1000.0f;
+  display.attachSimulator(nullptr);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Score of a result for an objective, lower is better.
+ */
+/***************************************************************************/
+
+static float objectiveScore(const SweepResult& t_result, uint8_t t_objective)
+{
+  switch (t_objective) {
+    case SWEEP_OBJECTIVE_LATENCY:  return (float)t_result.driveTimeMs;
+    case SWEEP_OBJECTIVE_ENERGY:   return t_result.chargeMilliCoulomb;
+    case SWEEP_OBJECTIVE_RETRIES:  return (float)t_result.refreshRetries;
+    default:                       return -t_result.contrastVoltage;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Check if a is at least as good as b on every score and strictly
+ * better on at least one.
+ */
+/***************************************************************************/
+
+static bool dominates(const SweepResult& t_a, const SweepResult& t_b)
+{
+  bool noWorse = true;
+  bool better  = false;
+
+  for (uint8_t objective = 0; objective < SWEEP_NUM_OBJECTIVES; objective++) {
+    noWorse = noWorse && objectiveScore(t_a, objective) <= objectiveScore(t_b, objective);
+    better  = better  || objectiveScore(t_a, objective) <  objectiveScore(t_b, objective);
+  }
+  return noWorse && better;
+}
+
+
+/***************************************************************************/
+/********************************* OUTPUT **********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Print the Pareto front as a header of constexpr profiles.
+ */
+/***************************************************************************/
+
+static void printProfiles(const std::vector<SweepResult>& t_front, size_t t_frontSize, uint8_t t_objective,
+                          const char* t_modelPath, int t_segments, const char* t_framesPath, size_t t_frames)
+{
+  printf("// ECD_Config Pareto profiles for %d segments (%s), objective \"%s\", best %u of %u\n",
+         t_segments, t_modelPath, sweepObjectiveNames[t_objective], (unsigned)t_front.size(), (unsigned)t_frontSize);
+  printf("// Generated by extras/ConfigSweep: %u frames (%s)\n\n", (unsigned)t_frames, t_framesPath);
+  printf("#pragma once\n\n#include \"YnvisibleECD.h\"\n\n");
+  printf("struct ecdSweepProfile_t {\n");
+  printf("    int   coloringTime;                 // (ms)\n");
+  printf("    int   bleachingTime;                // (ms)\n");
+  printf("    int   refreshColorPulseTime;        // (ms)\n");
+  printf("    int   refreshBleachPulseTime;       // (ms)\n");
+  printf("    float refreshColorLimitHVoltage;    // (V)\n");
+  printf("    float refreshColorLimitLVoltage;    // (V)\n");
+  printf("    float refreshBleachLimitHVoltage;   // (V)\n");
+  printf("    float refreshBleachLimitLVoltage;   // (V)\n");
+  printf("};\n\n");
+  printf("constexpr unsigned int ecdSweepNumProfiles = %u;\n\n", (unsigned)t_front.size());
+  printf("constexpr ecdSweepProfile_t ecdSweepProfiles[ecdSweepNumProfiles] = {\n");
+  for (size_t i = 0; i < t_front.size(); i++) {
+    const SweepResult& r = t_front[i];
+    printf("    { %d, %d, %d, %d, %.2ff, %.2ff, %.2ff, %.2ff }%s   // %u: drive %lu ms, charge %.1f mC, retries %lu, contrast %.3f V\n",
+           r.cfg.coloringTime, r.cfg.bleachingTime, r.cfg.refreshColorPulseTime, r.cfg.refreshBleachPulseTime,
+           r.cfg.refreshColorLimitHVoltage, r.cfg.refreshColorLimitLVoltage,
+           r.cfg.refreshBleachLimitHVoltage, r.cfg.refreshBleachLimitLVoltage,
+           (i + 1 < t_front.size()) ? "," : " ", (unsigned)i, r.driveTimeMs, r.chargeMilliCoulomb,
+           r.refreshRetries, r.contrastVoltage);
+  }
+  printf("};\n\n");
+  printf("inline ECD_Config ecdSweepConfig(unsigned int t_profile)\n{\n");
+  printf("    ECD_Config cfg;\n");
+  printf("    const ecdSweepProfile_t& p = ecdSweepProfiles[t_profile < ecdSweepNumProfiles ? t_profile : 0];\n");
+  printf("    cfg.coloringTime               = p.coloringTime;\n");
+  printf("    cfg.bleachingTime              = p.bleachingTime;\n");
+  printf("    cfg.refreshColorPulseTime      = p.refreshColorPulseTime;\n");
+  printf("    cfg.refreshBleachPulseTime     = p.refreshBleachPulseTime;\n");
+  printf("    cfg.refreshColorLimitHVoltage  = p.refreshColorLimitHVoltage;\n");
+  printf("    cfg.refreshColorLimitLVoltage  = p.refreshColorLimitLVoltage;\n");
+  printf("    cfg.refreshBleachLimitHVoltage = p.refreshBleachLimitHVoltage;\n");
+  printf("    cfg.refreshBleachLimitLVoltage = p.refreshBleachLimitLVoltage;\n");
+  printf("    return cfg;\n}\n");
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  uint8_t objective = SWEEP_NUM_OBJECTIVES;
+  for (uint8_t o = 0; argc > 1 && o < SWEEP_NUM_OBJECTIVES; o++) {
+    if (strcmp(argv[1], sweepObjectiveNames[o]) == 0) {
+      objective = o;
+    }
+  }
+  if (objective == SWEEP_NUM_OBJECTIVES) {
+    fprintf(stderr, "Usage: %s <latency|energy|retries|contrast> [model.txt|-] [frames.txt|-] [threads]\n", argv[0]);
+    return 1;
+  }
+
+  const char*                   modelPath = (argc > 2) ? argv[2] : "-";
+  std::vector<ECD_SegmentModel> models;
+  if (strcmp(modelPath, "-") == 0) {
+    models.resize(SWEEP_DEFAULT_SEGMENTS);
+    modelPath = "default model";
+  } else if (!loadModels(modelPath, models)) {
+    fprintf(stderr, "No setSegmentModel() block found in %s\n", modelPath);
+    return 1;
+  }
+
+  const char*             framesPath = (argc > 3) ? argv[3] : "-";
+  std::vector<SweepFrame> frames;
+  if (strcmp(framesPath, "-") == 0) {
+    barGraphFrames((int)models.size(), frames);
+    framesPath = "bar graph";
+  } else if (!loadFrames(framesPath, (int)models.size(), frames)) {
+    fprintf(stderr, "No valid frame list in %s\n", framesPath);
+    return 1;
+  }
+
+  // Grid, in the order of the pulse time and limit tables
+  std::vector<SweepResult> results;
+  for (int c : coloringTimes)
+  for (int b : bleachingTimes)
+  for (int rc : refreshColorPulseTimes)
+  for (int rb : refreshBleachPulseTimes)
+  for (float ch : refreshColorLimitHVoltages)
+  for (float cl : refreshColorLimitLVoltages)
+  for (float bh : refreshBleachLimitHVoltages)
+  for (float bl : refreshBleachLimitLVoltages) {
+    SweepResult candidate;
+    candidate.cfg.coloringTime               = c;
+    candidate.cfg.bleachingTime              = b;
+    candidate.cfg.refreshColorPulseTime      = rc;
+    candidate.cfg.refreshBleachPulseTime     = rb;
+    candidate.cfg.refreshColorLimitHVoltage  = ch;
+    candidate.cfg.refreshColorLimitLVoltage  = cl;
+    candidate.cfg.refreshBleachLimitHVoltage = bh;
+    candidate.cfg.refreshBleachLimitLVoltage = bl;
+    results.push_back(candidate);
+  }
+
+  // One display and simulator per candidate: workers pick the next one
+  std::atomic<unsigned int> nextCandidate(0);
+  unsigned int numThreads = (argc > 4) ? strtoul(argv[4], nullptr, 10) : std::thread::hardware_concurrency();
+  numThreads = constrain(numThreads, 1u, (unsigned int)SWEEP_NUM_CANDIDATES);
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < numThreads; t++) {
+    workers.emplace_back([&]() {
+      for (unsigned int i = nextCandidate++; i < results.size(); i = nextCandidate++) {
+        runWorkload(models, frames, results[i]);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<SweepResult> front;
+  for (const SweepResult& candidate : results) {
+    bool dominated = candidate.refreshFailures > 0;
+    for (size_t j = 0; j < results.size() && !dominated; j++) {
+      dominated = results[j].refreshFailures == 0 && dominates(results[j], candidate);
+    }
+    if (!dominated) {
+      front.push_back(candidate);
+    }
+  }
+  if (front.empty()) {
+    fprintf(stderr, "Every configuration of the grid hit MAX_REFRESH_RETRIES on the workload\n");
+    return 1;
+  }
+
+  std::stable_sort(front.begin(), front.end(), [objective](const SweepResult& t_a, const SweepResult& t_b) {
+    return objectiveScore(t_a, objective) < objectiveScore(t_b, objective);
+  });
+  size_t frontSize = front.size();
+  front.resize(std::min(frontSize, (size_t)SWEEP_MAX_PROFILES));
+  printProfiles(front, frontSize, objective, modelPath, (int)models.size(), framesPath, frames.size());
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,424 @@
+/**
+ * @file YnvisibleFleet.cpp
+ * @brief Host fleet simulation of many independent Driver v5 boards.
+ *
+ * Simulates N boards, each a 7-segment display with dot driven by its own
+ * YNV_ECD and YNV_ECD_Simulator (own virtual clock), and aggregates what the
+ * fleet experiences over FLEET days of operation.
+ *
+ * Per board:
+ *  - Parameter spread: a board nominal drawn around the default segment
+ *    model (charge capacity, self-discharge time, age in cycles with the
+ *    aging model of examples/Lifetime), then per-segment manufacturing
+ *    spread with applySegmentSpread().
+ *  - Usage pattern and update trace: a clock (new digit every
+ *    FLEET_CLOCK_PERIOD_MS), a sign (Poisson updates, mean
+ *    FLEET_SIGN_MEAN_MS) or a status indicator (a few changes per day),
+ *    generated from the board seed. Between updates executeDisplay() polls
+ *    the refresh every FLEET_POLL_MS, as an application loop would.
+ *
+ * Scheduling:
+ *  - Boards are dealt round-robin to per-worker deques. A worker takes its
+ *    own boards from the back and, once its deque is empty, steals from the
+ *    front of the others, so clock boards (many updates) do not leave the
+ *    workers that drew them running long after the rest are idle.
+ *
+ * Output: one JSON line with the distributions (min, p50, p90, p99, max,
+ * mean) of the update latency (all updates of all boards), refresh rounds
+ * per day, energy per day and refresh failures per board, the failure
+ * counts, and the pool statistics.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -pthread -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleFleet.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_fleet
+ *
+ * Usage:
+ *   ynv_fleet [boards] [days] [threads] [seed]
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define FLEET_NUM_SEGMENTS          8           // 7-segment display with dot
+#define FLEET_DOT_SEGMENT           3           // Dot (status boards: the indicator)
+#define FLEET_DEFAULT_BOARDS        200         // Simulated boards
+#define FLEET_DEFAULT_DAYS          7           // Days of operation per board
+#define FLEET_DAY_MS                86400000UL  // (ms) One day
+#define FLEET_POLL_MS               1800000UL   // (ms) executeDisplay() period without an update
+#define FLEET_CLOCK_PERIOD_MS       600000UL    // (ms) Clock boards: new digit period
+#define FLEET_SIGN_MEAN_MS          14400000.0  // (ms) Sign boards: mean time between updates
+#define FLEET_STATUS_PER_DAY        3           // Status boards: indicator changes per day
+#define FLEET_MAX_AGE_CYCLES        30000.0f    // Boards are aged 0..FLEET_MAX_AGE_CYCLES full cycles
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Usage pattern of a board.
+ */
+enum fleetUsage_e {
+    FLEET_USAGE_CLOCK   = 0,
+    FLEET_USAGE_SIGN    = 1,
+    FLEET_USAGE_STATUS  = 2,
+    FLEET_NUM_USAGES    = 3
+};
+
+/**
+ * @brief One entry of a board update trace.
+ */
+struct FleetUpdate {
+
+    unsigned long    timeMs;                                        // (ms) Board time of the update
+    ecdSegmentMask_t states;                                        // Requested frame (bit i: 1 = color)
+};
+
+/**
+ * @brief Results of one board.
+ */
+struct FleetBoardResult {
+
+    uint8_t              usage            { FLEET_USAGE_CLOCK };
+    std::vector<float>   latencyMs;                                 // (ms) executeDisplay() time of each update
+    double               refreshPerDay    { 0.0 };                  // Refresh rounds per day
+    double               energyPerDay     { 0.0 };                  // (mC) Charge delivered per day
+    unsigned long        refreshFailures  { 0 };                    // Rounds ended by MAX_REFRESH_RETRIES
+    unsigned long        wrongChecks      { 0 };                    // executeDisplay() calls leaving a segment visibly wrong
+    unsigned int         safetyViolations { 0 };
+};
+
+/**
+ * @brief Work-stealing pool state: one deque of board indices per worker.
+ */
+struct FleetWorker {
+
+    std::mutex                lock;
+    std::deque<unsigned int>  jobs;
+    unsigned long             ran         { 0 };                    // Boards simulated by this worker
+    unsigned long             stolen      { 0 };                    // Of which taken from another worker
+};
+
+static int fleetPinList[FLEET_NUM_SEGMENTS] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+static const bool fleetDigits[10][7] = {                            // Segments a..g, around the dot
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+
+/***************************************************************************/
+/********************************* HELPERS *********************************/
+/***************************************************************************/
+
+static ecdSegmentMask_t digitFrame(int t_digit, bool t_dot)
+{
+  ecdSegmentMask_t frame = t_dot ? (ecdSegmentMask_t)1 << FLEET_DOT_SEGMENT : 0;
+
+  for (int i = 0, s = 0; i < FLEET_NUM_SEGMENTS; i++) {
+    if (i != FLEET_DOT_SEGMENT) {
+      frame |= (ecdSegmentMask_t)fleetDigits[t_digit][s++] << i;
+    }
+  }
+  return frame;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Update trace of one board over t_days, from its usage pattern.
+ */
+/***************************************************************************/
+
+static std::vector<FleetUpdate> buildTrace(uint8_t t_usage, unsigned int t_days, std::mt19937& t_rng)
+{
+  std::vector<FleetUpdate> trace;
+  unsigned long            endMs = t_days * FLEET_DAY_MS;
+  std::uniform_int_distribution<int> digit(0, 9);
+
+  if (t_usage == FLEET_USAGE_CLOCK) {
+    int value = digit(t_rng);
+    for (unsigned long t = FLEET_CLOCK_PERIOD_MS; t < endMs; t += FLEET_CLOCK_PERIOD_MS) {
+      value = (value + 1) % 10;
+      trace.push_back({ t, digitFrame(value, false) });
+    }
+  } else if (t_usage == FLEET_USAGE_SIGN) {
+    std::exponential_distribution<double> gap(1.0 / FLEET_SIGN_MEAN_MS);
+    for (double t = gap(t_rng); t < endMs; t += gap(t_rng)) {
+      trace.push_back({ (unsigned long)t, digitFrame(digit(t_rng), false) });
+    }
+  } else {
+    std::uniform_int_distribution<unsigned long> when(0, FLEET_DAY_MS - 1);
+    for (unsigned int day = 0; day < t_days; day++) {
+      std::vector<unsigned long> times;
+      for (int n = 0; n < FLEET_STATUS_PER_DAY; n++) {
+        times.push_back(day * FLEET_DAY_MS + when(t_rng));
+      }
+      std::sort(times.begin(), times.end());
+      for (unsigned long t : times) {
+        bool alarm = trace.empty() ? true : (trace.back().states & ((ecdSegmentMask_t)1 << FLEET_DOT_SEGMENT)) == 0;
+        trace.push_back({ t, digitFrame(alarm ? 1 : 0, alarm) });
+      }
+    }
+  }
+  return trace;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulate one board: own display, own simulator, own clock.
+ */
+/***************************************************************************/
+
+static FleetBoardResult runBoard(unsigned int t_board, unsigned int t_days, uint32_t t_seed)
+{
+  std::mt19937            rng(t_seed * 7919u + t_board);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+  FleetBoardResult  result;
+  YNV_ECD           display(FLEET_NUM_SEGMENTS, fleetPinList);
+  YNV_ECD_Simulator sim;
+  ECD_SegmentModel  nominal;
+  ECD_SegmentSpread spread;
+
+  result.usage = (uint8_t)(rng() % FLEET_NUM_USAGES);
+
+  // Board nominal: production lot and age
+  nominal.chargeCapacity     *= std::max(0.5f, 1.0f + 0.1f * normal(rng));
+  nominal.selfDischargeTime  *= exp(0.4f * normal(rng));
+  nominal.capacityFade        = 5.0e-6f;
+  nominal.kineticsAging       = 1.0e-4f;
+  nominal.selfDischargeAging  = 2.0e-4f;
+
+  display.attachSimulator(&sim);
+  sim.applySegmentSpread(nominal, spread, rng());
+  float age = FLEET_MAX_AGE_CYCLES * unit(rng);
+  for (int i = 0; i < FLEET_NUM_SEGMENTS; i++) {
+    sim.setSegmentCycles(i, age);
+  }
+  display.begin();
+  display.resetStats();
+  sim.resetChargeDelivered();
+  sim.resetSafetyViolations();
+
+  std::vector<FleetUpdate> trace = buildTrace(result.usage, t_days, rng);
+  unsigned long    startMs = sim.millis();
+  unsigned long    endMs   = startMs + t_days * FLEET_DAY_MS;
+  unsigned long    nextPoll = startMs + FLEET_POLL_MS;
+  ecdSegmentMask_t frame    = 0;
+  size_t           next     = 0;
+
+  while (sim.millis() < endMs) {
+    bool          update = next < trace.size() && startMs + trace[next].timeMs <= nextPoll;
+    unsigned long due    = update ? startMs + trace[next].timeMs : nextPoll;
+
+    if (due >= endMs) {
+      break;
+    }
+    if (due > sim.millis()) {
+      sim.advanceTime(due - sim.millis());
+    }
+    if (update) {
+      frame = trace[next++].states;
+      for (int i = 0; i < FLEET_NUM_SEGMENTS; i++) {
+        display.setSegmentState(i, (frame >> i) & 1);
+      }
+    }
+
+    unsigned long before = sim.millis();
+    display.executeDisplay();
+    if (update) {
+      result.latencyMs.push_back((float)(sim.millis() - before));
+    } else {
+      nextPoll += FLEET_POLL_MS;
+    }
+    if (sim.millis() > nextPoll) {
+      nextPoll = sim.millis();
+    }
+
+    for (int i = 0; i < FLEET_NUM_SEGMENTS; i++) {
+      if (sim.isSegmentVisiblyColored(i) != (((frame >> i) & 1) != 0)) {
+        result.wrongChecks++;
+        break;
+      }
+    }
+  }
+
+  const ECD_Stats& stats = display.getStats();
+  result.refreshPerDay    = (double)stats.refreshRounds / t_days;
+  result.energyPerDay     = sim.getChargeDelivered() * 1.0e3 / t_days;
+  result.refreshFailures  = stats.refreshFailures;
+  result.safetyViolations = sim.getSafetyViolations();
+  display.attachSimulator(nullptr);
+  return result;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Next board for a worker: own deque first (back), then steal from
+ * the front of the others.
+ *
+ * @return false once every deque is empty (no board is ever added later)
+ */
+/***************************************************************************/
+
+static bool nextJob(std::vector<FleetWorker>& t_workers, unsigned int t_self, unsigned int& t_job)
+{
+  {
+    std::lock_guard<std::mutex> guard(t_workers[t_self].lock);
+    if (!t_workers[t_self].jobs.empty()) {
+      t_job = t_workers[t_self].jobs.back();
+      t_workers[t_self].jobs.pop_back();
+      return true;
+    }
+  }
+  for (unsigned int k = 1; k < t_workers.size(); k++) {
+    FleetWorker& victim = t_workers[(t_self + k) % t_workers.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.jobs.empty()) {
+      t_job = victim.jobs.front();
+      victim.jobs.pop_front();
+      t_workers[t_self].stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/***************************************************************************/
+/********************************* OUTPUT **********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Print a distribution as {"min","p50","p90","p99","max","mean"}.
+ */
+/***************************************************************************/
+
+static void printDistribution(const char* t_name, std::vector<double> t_values, bool t_last = false)
+{
+  printf("\"%s\":", t_name);
+  if (t_values.empty()) {
+    printf("null%s", t_last ? "" : ",");
+    return;
+  }
+  std::sort(t_values.begin(), t_values.end());
+
+  double sum = 0.0;
+  for (double v : t_values) {
+    sum += v;
+  }
+  auto percentile = [&](double t_fraction) {
+    size_t index = (size_t)(t_fraction * (t_values.size() - 1) + 0.5);
+    return t_values[index];
+  };
+  printf("{\"min\":%.3g,\"p50\":%.3g,\"p90\":%.3g,\"p99\":%.3g,\"max\":%.3g,\"mean\":%.3g}%s",
+         t_values.front(), percentile(0.50), percentile(0.90), percentile(0.99), t_values.back(),
+         sum / t_values.size(), t_last ? "" : ",");
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  unsigned int boards  = (argc > 1) ? strtoul(argv[1], nullptr, 10) : FLEET_DEFAULT_BOARDS;
+  unsigned int days    = (argc > 2) ? strtoul(argv[2], nullptr, 10) : FLEET_DEFAULT_DAYS;
+  unsigned int threads = (argc > 3) ? strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+  uint32_t     seed    = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+
+  boards  = std::max(boards, 1u);
+  days    = std::max(days, 1u);
+  threads = constrain(threads, 1u, boards);
+
+  std::vector<FleetBoardResult> results(boards);
+  std::vector<FleetWorker>      workers(threads);
+  std::vector<std::thread>      pool;
+
+  for (unsigned int b = 0; b < boards; b++) {                       // Deal the boards round-robin
+    workers[b % threads].jobs.push_back(b);
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  for (unsigned int t = 0; t < threads; t++) {
+    pool.emplace_back([&, t]() {
+      unsigned int job;
+      while (nextJob(workers, t, job)) {
+        results[job] = runBoard(job, days, seed);
+        workers[t].ran++;
+      }
+    });
+  }
+  for (std::thread& worker : pool) {
+    worker.join();
+  }
+  auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart).count();
+
+  std::vector<double> latency, refresh, energy, failures;
+  unsigned int  usageCount[FLEET_NUM_USAGES] = {0, 0, 0};
+  unsigned int  failedBoards = 0, wrongBoards = 0, unsafeBoards = 0;
+  unsigned long failureTotal = 0, wrongTotal = 0, steals = 0, minRan = boards, maxRan = 0;
+
+  for (const FleetBoardResult& r : results) {
+    latency.insert(latency.end(), r.latencyMs.begin(), r.latencyMs.end());
+    refresh.push_back(r.refreshPerDay);
+    energy.push_back(r.energyPerDay);
+    failures.push_back((double)r.refreshFailures);
+    usageCount[r.usage]++;
+    failedBoards += (r.refreshFailures > 0);
+    wrongBoards  += (r.wrongChecks > 0);
+    unsafeBoards += (r.safetyViolations > 0);
+    failureTotal += r.refreshFailures;
+    wrongTotal   += r.wrongChecks;
+  }
+  for (const FleetWorker& w : workers) {
+    steals += w.stolen;
+    minRan  = std::min(minRan, w.ran);
+    maxRan  = std::max(maxRan, w.ran);
+  }
+
+  printf("{\"boards\":%u,\"days\":%u,\"seed\":%lu,\"usage\":{\"clock\":%u,\"sign\":%u,\"status\":%u},\"updates\":%lu,",
+         boards, days, (unsigned long)seed, usageCount[FLEET_USAGE_CLOCK], usageCount[FLEET_USAGE_SIGN],
+         usageCount[FLEET_USAGE_STATUS], (unsigned long)latency.size());
+  printDistribution("update_latency_ms", latency);
+  printDistribution("refresh_rounds_per_day", refresh);
+  printDistribution("energy_mC_per_day", energy);
+  printDistribution("refresh_failures_per_board", failures);
+  printf("\"failures\":{\"refresh_failures\":%lu,\"boards_with_refresh_failure\":%u,\"wrong_state_checks\":%lu,"
+         "\"boards_with_wrong_state\":%u,\"boards_with_safety_violation\":%u},",
+         failureTotal, failedBoards, wrongTotal, wrongBoards, unsafeBoards);
+  printf("\"pool\":{\"threads\":%u,\"steals\":%lu,\"min_boards_per_thread\":%lu,\"max_boards_per_thread\":%lu,\"wall_ms\":%ld}}\n",
+         threads, steals, minRan, maxRan, (long)wallMs);
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,136 @@
+#!/bin/sh
+#
+# footprint.sh - RAM/flash footprint of the library per feature toggle
+#
+# Compiles every library source (no linking) for each target and each
+# feature configuration, then reports as JSON lines:
+#   - per configuration : total flash (text + rodata + data) and static RAM
+#                         (data + bss) of the library objects, sizeof(YNV_ECD)
+#   - per feature       : flash/RAM delta of enabling it (vs. compiled out)
+#   - per symbol        : size of the YNV_ECD instances and other globals of
+#                         the Eval Kit, and of the Driver v5 LED tables
+#
+# Targets:
+#   host      HOST_CXX (default g++) with HOST_FLAGS; HOST_INCLUDES must point
+#             to an Arduino host core providing Arduino.h
+#   embedded  EMBEDDED_CXX (default arm-none-eabi-g++) with EMBEDDED_FLAGS
+#             (default: Cortex-M0+, -Os, the 48 MHz class of the Driver v5);
+#             EMBEDDED_INCLUDES must point to the Arduino core and variant of
+#             the board (Arduino.h, PIN_CE, PIN_SEG_n, LED_n)
+#   A target whose compiler or includes are missing is skipped.
+#
+# Features (FEATURES below: name and the flags that compile it out):
+#   stats   ECD_Stats counters           (YNV_ECD_NO_STATS)
+#   phase   driver phase tracking        (YNV_ECD_NO_PHASE)
+#   Simulator support (YNV_ECD_SIMULATOR) is reported for the host only.
+#
+# Usage:
+#   HOST_INCLUDES="-I<host core>" EMBEDDED_INCLUDES="-I<core> -I<variant> ..." \
+#       sh footprint.sh > footprint.jsonl
+#
+# Created by Ynvisible (Oct 2026)
+#
+
+SRC_DIR=$(cd "$(dirname "$0")/../../src" && pwd)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+HOST_CXX=${HOST_CXX:-g++}
+HOST_FLAGS=${HOST_FLAGS:-"-std=gnu++11 -Os -ffunction-sections -fdata-sections"}
+EMBEDDED_CXX=${EMBEDDED_CXX:-arm-none-eabi-g++}
+EMBEDDED_FLAGS=${EMBEDDED_FLAGS:-"-std=gnu++11 -mcpu=cortex-m0plus -mthumb -Os -ffunction-sections -fdata-sections -fno-exceptions -fno-rtti -DF_CPU=48000000L"}
+
+FEATURES="stats:-DYNV_ECD_NO_STATS phase:-DYNV_ECD_NO_PHASE"
+ALL_OFF="-DYNV_ECD_NO_STATS -DYNV_ECD_NO_PHASE"
+
+# Symbols reported one by one (nm names, demangled)
+SYMBOL_PATTERN='ecdEvalKit|evalKit|display15Seg|greenLEDs'
+
+
+# build <target> <config name> <flags...>: compile all sources into $WORK_DIR/<target>/<config>
+build() {
+  target=$1; config=$2; shift 2
+  out="$WORK_DIR/$target/$config"
+  mkdir -p "$out"
+
+  if [ "$target" = host ]; then
+    cxx=$HOST_CXX; flags="$HOST_FLAGS $HOST_INCLUDES"
+  else
+    cxx=$EMBEDDED_CXX; flags="$EMBEDDED_FLAGS $EMBEDDED_INCLUDES"
+  fi
+
+  printf '#include "YnvisibleECD.h"\nchar ynvFootprintSizeofECD[sizeof(YNV_ECD)];\n' > "$out/sizeof_probe.cpp"
+  for src in "$SRC_DIR"/*.cpp "$out/sizeof_probe.cpp"; do
+    case "$src" in
+      *YnvisibleECDSimulator.cpp) case " $* " in *" -DYNV_ECD_SIMULATOR "*) ;; *) continue ;; esac ;;
+    esac
+    $cxx $flags -I"$SRC_DIR" "$@" -c "$src" -o "$out/$(basename "$src" .cpp).o" || return 1
+  done
+}
+
+# totals <target> <config>: prints "flash ram" of the library objects (probe excluded)
+totals() {
+  objects=$(ls "$WORK_DIR/$1/$2"/*.o | grep -v sizeof_probe)
+  $SIZE -B $objects | awk 'NR > 1 { flash += $1 + $2; ram += $2 + $3 } END { print flash, ram }'
+}
+
+# sizeof_ecd <target> <config>: size of the probe array, i.e. sizeof(YNV_ECD)
+sizeof_ecd() {
+  $NM -S -t d "$WORK_DIR/$1/$2/sizeof_probe.o" | awk '/ynvFootprintSizeofECD/ { print $2 + 0 }'
+}
+
+report_target() {
+  target=$1
+
+  build "$target" all_on || { echo "{\"target\":\"$target\",\"error\":\"build failed\"}"; return; }
+  build "$target" all_off $ALL_OFF || return
+  configs="all_on all_off"
+  for feature in $FEATURES; do
+    name=${feature%%:*}
+    build "$target" "no_$name" ${feature#*:} || return
+    configs="$configs no_$name"
+  done
+  if [ "$target" = host ]; then
+    build "$target" simulator -DYNV_ECD_SIMULATOR || return
+    configs="$configs simulator"
+  fi
+
+  for config in $configs; do
+    set -- $(totals "$target" "$config")
+    echo "{\"target\":\"$target\",\"config\":\"$config\",\"flash\":$1,\"ram\":$2,\"sizeof_YNV_ECD\":$(sizeof_ecd "$target" "$config")}"
+  done
+
+  set -- $(totals "$target" all_on); onFlash=$1; onRam=$2
+  for feature in $FEATURES; do
+    name=${feature%%:*}
+    set -- $(totals "$target" "no_$name")
+    echo "{\"target\":\"$target\",\"feature\":\"$name\",\"flash_delta\":$((onFlash - $1)),\"ram_delta\":$((onRam - $2)),\"sizeof_delta\":$(( $(sizeof_ecd "$target" all_on) - $(sizeof_ecd "$target" "no_$name") ))}"
+  done
+  if [ "$target" = host ]; then
+    set -- $(totals "$target" simulator)
+    echo "{\"target\":\"$target\",\"feature\":\"simulator\",\"flash_delta\":$(($1 - onFlash)),\"ram_delta\":$(($2 - onRam)),\"sizeof_delta\":$(( $(sizeof_ecd "$target" simulator) - $(sizeof_ecd "$target" all_on) ))}"
+  fi
+
+  # Per symbol, all features on: type d/b = RAM, r/t = flash
+  $NM -S -C -t d --size-sort "$WORK_DIR/$target/all_on"/*.o 2>/dev/null | grep -E "$SYMBOL_PATTERN" |
+    awk -v target="$target" 'NF >= 4 {
+      type = tolower($3); memory = (type == "d" || type == "b") ? "ram" : "flash"
+      name = $4; for (i = 5; i <= NF; i++) name = name " " $i
+      printf "{\"target\":\"%s\",\"symbol\":\"%s\",\"memory\":\"%s\",\"size\":%d}\n", target, name, memory, $2 + 0
+    }'
+}
+
+
+if [ -n "$HOST_INCLUDES" ] && command -v "$HOST_CXX" > /dev/null; then
+  SIZE=size; NM=nm
+  report_target host
+else
+  echo "{\"target\":\"host\",\"skipped\":\"set HOST_INCLUDES to an Arduino host core\"}"
+fi
+
+if [ -n "$EMBEDDED_INCLUDES" ] && command -v "$EMBEDDED_CXX" > /dev/null; then
+  SIZE=${EMBEDDED_CXX%g++}size; NM=${EMBEDDED_CXX%g++}nm
+  report_target embedded
+else
+  echo "{\"target\":\"embedded\",\"skipped\":\"$EMBEDDED_CXX or EMBEDDED_INCLUDES not available\"}"
+fi
@@ -0,0 +1,374 @@
+
+/**
+ * @file YnvisibleMicroBench.cpp
+ * @brief Host micro-benchmarks of the CPU-side work of the driving engine.
+ *
+ * The library is built with YNV_ECD_NOOP_HAL: pin, DAC, ADC and delay calls
+ * of the engine return at once, so only the bookkeeping is timed:
+ *  - setSegmentState() over a full frame
+ *  - setConfig() (updateRefreshLimits())
+ *  - executeDisplay() without changes (check_refresh() classification only),
+ *    with a full transition, and with both refresh loops at MAX_REFRESH_RETRIES
+ *  - Evaluation Kit helpers (digit/number to segment mask rendering + update)
+ *  - Scaling with the display size: the three executeDisplay() cases on
+ *    YNV_ECD_Sized displays of 1 to MAX_NUMBER_OF_SEGMENTS segments
+ *    (names ending in _n<segments>)
+ *
+ * Each benchmark is calibrated to run for at least BENCH_MIN_TIME_MS, then
+ * repeated BENCH_REPETITIONS times; the median is reported. One JSON line is
+ * printed per benchmark:
+ *  - ns_per_op    : host CPU time per operation
+ *  - instr_per_op : retired user-space instructions per operation (Linux perf
+ *                   counters; null when not available, e.g. in containers)
+ *  - delta_pct    : change of ns_per_op against a baseline run, if given
+ *
+ * Host ns/op are not MCU cycles, but instruction counts and relative deltas
+ * carry over to the 48 MHz targets.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h; the engine
+ * constructors still call pinMode() once):
+ *   g++ -std=gnu++11 -O2 -DYNV_ECD_NOOP_HAL -I<host core> -I../../src YnvisibleMicroBench.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleEvaluationKit.cpp -o ynv_microbench
+ *
+ * Usage:
+ *   ynv_microbench > baseline.jsonl
+ *   ynv_microbench baseline.jsonl       Compare with a previous run
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleEvaluationKit.h"
+
+#ifndef YNV_ECD_NOOP_HAL
+#error "Build the micro-benchmarks with -DYNV_ECD_NOOP_HAL"
+#endif
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define BENCH_MIN_TIME_MS           100         // (ms) Minimum duration of one repetition
+#define BENCH_REPETITIONS           5           // Repetitions per benchmark (median reported)
+#define BENCH_NUM_SEGMENTS          15          // Segments of the fixed benchmark display (Eval Kit 15-seg)
+#define BENCH_READING_QUIET         0           // (LSB) ADC code: bleached segments in range, no refresh
+#define BENCH_READING_REFRESH       (ADC_DAC_MAX_LSB / 2) // (LSB) ADC code: every segment needs refresh
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief One micro-benchmark.
+ */
+struct benchmark_t {
+    const char* name;
+    void        (*setup)(void);                                     // Untimed preparation (may be nullptr)
+    void        (*run)(void);                                       // One operation
+};
+
+/**
+ * @brief Result of a previous run.
+ */
+struct BenchBaseline {
+    std::string name;
+    double      nsPerOp;
+};
+
+
+/***************************************************************************/
+/*************************** PERFORMANCE COUNTER ***************************/
+/***************************************************************************/
+
+static int s_instructionCounter = -1;
+
+/***************************************************************************/
+/**
+ * @brief Open the retired-instructions counter of this thread, if allowed.
+ */
+/***************************************************************************/
+
+static void openInstructionCounter()
+{
+#ifdef __linux__
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled       = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  s_instructionCounter = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/***************************************************************************/
+/**
+ * @brief Start counting; returns false if no counter is available.
+ */
+/***************************************************************************/
+
+static bool startInstructionCounter()
+{
+#ifdef __linux__
+  if (s_instructionCounter >= 0) {
+    ioctl(s_instructionCounter, PERF_EVENT_IOC_RESET, 0);
+    ioctl(s_instructionCounter, PERF_EVENT_IOC_ENABLE, 0);
+    return true;
+  }
+#endif
+  return false;
+}
+
+/***************************************************************************/
+/**
+ * @brief Stop counting and return the instructions retired since the start.
+ */
+/***************************************************************************/
+
+static long long stopInstructionCounter()
+{
+  long long count = 0;
+#ifdef __linux__
+  ioctl(s_instructionCounter, PERF_EVENT_IOC_DISABLE, 0);
+  if (read(s_instructionCounter, &count, sizeof(count)) != sizeof(count)) {
+    count = 0;
+  }
+#endif
+  return count;
+}
+
+
+/***************************************************************************/
+/******************************* BENCHMARKS ********************************/
+/***************************************************************************/
+
+static int     s_benchPinList[MAX_NUMBER_OF_SEGMENTS];   // WE pins (values unused by the no-op HAL)
+static YNV_ECD s_benchDisplay(BENCH_NUM_SEGMENTS, s_benchPinList);
+static ECD_Config s_benchConfig;
+static bool    s_benchToggle  = false;
+static unsigned int s_benchNumber = 0;
+
+static void setupBleached() {
+  ynvNoopHalReading = BENCH_READING_QUIET;
+  s_benchDisplay.setAllSegmentsBleach();
+  s_benchDisplay.executeDisplay();
+}
+
+static void setupRefresh() {
+  setupBleached();
+  for (int i = 0; i < BENCH_NUM_SEGMENTS; i += 2) {         // Half colored, half bleached
+    s_benchDisplay.setSegmentState(i, true);
+  }
+  s_benchDisplay.executeDisplay();
+  ynvNoopHalReading = BENCH_READING_REFRESH;
+}
+
+static void setupEvalKit() {
+  ynvNoopHalReading = BENCH_READING_QUIET;
+}
+
+static void benchSetSegmentFrame() {
+  s_benchToggle = !s_benchToggle;
+  for (int i = 0; i < BENCH_NUM_SEGMENTS; i++) {
+    s_benchDisplay.setSegmentState(i, s_benchToggle ^ (i & 1));
+  }
+}
+
+static void benchSetConfig()         { s_benchConfig.coloringVoltage += 1.0e-6f; s_benchDisplay.setConfig(s_benchConfig); }
+static void benchExecuteNoChange()   { s_benchDisplay.executeDisplay(); }
+static void benchExecuteTransition() { benchSetSegmentFrame(); s_benchDisplay.executeDisplay(); }
+static void benchExecuteRefresh()    { s_benchDisplay.executeDisplay(); }
+static void bench7SegDigit()         { display7SegDotRun(s_benchNumber++ % 10, false); }
+static void bench15SegNumber()       { display15SegNegRun(s_benchNumber++ % 100, false); }
+static void bench7BarsLevel()        { unsigned int n = s_benchNumber++; display7BarsSet(n % EVAL_KIT_7BARS_NUM_SEGMENTS, n & 8); }
+
+/**
+ * @brief executeDisplay() cases on a display of exactly Segments segments.
+ */
+template <int Segments>
+struct BenchScale {
+    static YNV_ECD_Sized<Segments> display;
+
+    static void setupBleached() {
+      ynvNoopHalReading = BENCH_READING_QUIET;
+      display.setAllSegmentsBleach();
+      display.executeDisplay();
+    }
+
+    static void setupRefresh() {
+      setupBleached();
+      for (int i = 0; i < Segments; i += 2) {               // Half colored, half bleached
+        display.setSegmentState(i, true);
+      }
+      display.executeDisplay();
+      ynvNoopHalReading = BENCH_READING_REFRESH;
+    }
+
+    static void executeNoChange() { display.executeDisplay(); }
+
+    static void executeTransition() {
+      s_benchToggle = !s_benchToggle;
+      for (int i = 0; i < Segments; i++) {
+        display.setSegmentState(i, s_benchToggle ^ (i & 1));
+      }
+      display.executeDisplay();
+    }
+};
+
+template <int Segments>
+YNV_ECD_Sized<Segments> BenchScale<Segments>::display(Segments, s_benchPinList);
+
+#define BENCH_SCALE(t_segments) \
+  { "execute_no_change_n" #t_segments,         BenchScale<t_segments>::setupBleached, BenchScale<t_segments>::executeNoChange   }, \
+  { "execute_transition_n" #t_segments,        BenchScale<t_segments>::setupBleached, BenchScale<t_segments>::executeTransition }, \
+  { "execute_refresh_max_retry_n" #t_segments, BenchScale<t_segments>::setupRefresh,  BenchScale<t_segments>::executeNoChange   }
+
+static const benchmark_t benchmarks[] = {
+  { "set_segment_state_frame",   nullptr,        benchSetSegmentFrame   },
+  { "set_config_refresh_limits", nullptr,        benchSetConfig         },
+  { "execute_no_change",         setupBleached,  benchExecuteNoChange   },
+  { "execute_transition",        setupBleached,  benchExecuteTransition },
+  { "execute_refresh_max_retry", setupRefresh,   benchExecuteRefresh    },
+  { "evalkit_7seg_digit",        setupEvalKit,   bench7SegDigit         },
+  { "evalkit_15seg_number",      setupEvalKit,   bench15SegNumber       },
+  { "evalkit_7bars_set",         setupEvalKit,   bench7BarsLevel        },
+  BENCH_SCALE(1),
+  BENCH_SCALE(8),
+  BENCH_SCALE(16),
+#if MAX_NUMBER_OF_SEGMENTS >= 32
+  BENCH_SCALE(32),
+#endif
+#if MAX_NUMBER_OF_SEGMENTS >= 64
+  BENCH_SCALE(64),
+#endif
+};
+
+
+/***************************************************************************/
+/********************************* RUNNER **********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Time a number of iterations of a benchmark.
+ * @return (ns) Elapsed host time.
+ */
+/***************************************************************************/
+
+static double timeIterations(const benchmark_t& t_bench, unsigned long t_iterations)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < t_iterations; i++) {
+    t_bench.run();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/***************************************************************************/
+/**
+ * @brief Load the ns/op of a previous run; lines not matching are skipped.
+ */
+/***************************************************************************/
+
+static std::vector<BenchBaseline> loadBaseline(const char* t_path)
+{
+  std::vector<BenchBaseline> baseline;
+  FILE* file = fopen(t_path, "r");
+  if (file == nullptr) {
+    fprintf(stderr, "Cannot open baseline %s\n", t_path);
+    return baseline;
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    char   name[64];
+    double nsPerOp;
+
+    if (sscanf(line, "{\"bench\":\"%63[^\"]\",\"ns_per_op\":%lf", name, &nsPerOp) == 2) {
+      baseline.push_back({ name, nsPerOp });
+    }
+  }
+  fclose(file);
+  return baseline;
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  std::vector<BenchBaseline> baseline;
+  if (argc > 1) {
+    baseline = loadBaseline(argv[1]);
+  }
+
+  evaluationKitInit();
+  openInstructionCounter();
+
+  for (const benchmark_t& bench : benchmarks) {
+    if (bench.setup != nullptr) {
+      bench.setup();
+    }
+
+    // Calibration: grow the batch until it lasts BENCH_MIN_TIME_MS
+    unsigned long iterations = 1;
+    while (timeIterations(bench, iterations) < BENCH_MIN_TIME_MS * 1.0e6) {
+      iterations *= 2;
+    }
+
+    std::vector<double> nsPerOp;
+    for (int r = 0; r < BENCH_REPETITIONS; r++) {
+      nsPerOp.push_back(timeIterations(bench, iterations) / iterations);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    double median = nsPerOp[BENCH_REPETITIONS / 2];
+
+    bool counting = startInstructionCounter();
+    for (unsigned long i = 0; i < iterations; i++) {
+      bench.run();
+    }
+    long long instructions = counting ? stopInstructionCounter() : 0;
+
+    printf("{\"bench\":\"%s\",\"ns_per_op\":%.1f,\"iterations\":%lu,\"instr_per_op\":", bench.name, median, iterations);
+    if (counting && instructions > 0) {
+      printf("%.0f", (double)instructions / iterations);
+    } else {
+      printf("null");
+    }
+    for (const BenchBaseline& reference : baseline) {
+      if (reference.name == bench.name && reference.nsPerOp > 0.0) {
+        printf(",\"baseline_ns_per_op\":%.1f,\"delta_pct\":%.1f", reference.nsPerOp,
+               100.0 * (median - reference.nsPerOp) / reference.nsPerOp);
+      }
+    }
+    printf("}\n");
+  }
+
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
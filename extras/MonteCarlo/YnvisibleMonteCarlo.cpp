@@ -0,0 +1,290 @@
+/**
+ * @file YnvisibleMonteCarlo.cpp
+ * @brief Host tool measuring the robustness of an ECD_Config against panel spread.
+ *
+ * Draws the segment parameters of simulated 7-segment displays (with dot)
+ * from a spread profile, runs a standard workload on each panel and reports
+ * the tail behaviour of the configuration under test.
+ *
+ * Responsibilities:
+ *  - Draw each panel from its own seed: per-segment ECD_SegmentSpread on the
+ *    nominal model and, in the stress profile, a panel age with the aging
+ *    model of examples/Lifetime and ADC noise on the readings.
+ *  - Run the workload (count 0..9, each digit held MC_HOLD_TIME, repeated
+ *    MC_NUM_CYCLES times) and record the time of every update, the refresh
+ *    rounds that reached MAX_REFRESH_RETRIES and the updates that left a
+ *    segment visibly in the wrong state.
+ *  - Run the panels in parallel, one display and simulator per thread.
+ *  - Print one JSON line: update time percentiles and the probabilities of
+ *    a refresh failure and of a wrong state per panel, with 95 % Wilson
+ *    intervals.
+ *
+ * Notes:
+ *  - "nominal" is the default ECD_SegmentSpread on new panels: a sound
+ *    configuration shows no failure there, and only an upper bound of the
+ *    probabilities can be read from it.
+ *  - "stress" widens every sigma, spreads the panel age up to
+ *    MC_STRESS_MAX_CYCLES and adds MC_STRESS_ADC_NOISE, so weak panels reach
+ *    MAX_REFRESH_RETRIES or end an update visibly wrong, and the tail numbers
+ *    compare configurations.
+ *  - Results only depend on the profile, the trial count and the seed, not
+ *    on the number of threads.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -pthread -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleMonteCarlo.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_monte_carlo
+ *
+ * Usage:
+ *   ynv_monte_carlo [nominal|stress] [trials] [threads] [seed]
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define MC_NUM_SEGMENTS             8           // 7-segment display with dot
+#define MC_DOT_SEGMENT              3           // Dot, kept bleached
+#define MC_DEFAULT_TRIALS           2000        // Simulated panels
+#define MC_HOLD_TIME                900000UL    // (ms) Time each digit is held (self-discharge)
+#define MC_NUM_CYCLES               3           // Times the 0..9 count is repeated per panel
+#define MC_STRESS_MAX_CYCLES        5000.0f     // Stress: panels aged 0..MC_STRESS_MAX_CYCLES full cycles
+#define MC_STRESS_ADC_NOISE         4.0f        // (LSB rms) Stress: noise on the segment readings
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Panel population.
+ */
+struct McProfile {
+
+    const char*       name;
+    ECD_SegmentModel  nominal;
+    ECD_SegmentSpread spread;
+    float             maxCycles         { 0.0f };                   // Panel age drawn in 0..maxCycles
+    float             adcNoise          { 0.0f };                   // (LSB rms)
+};
+
+/**
+ * @brief Results of one panel.
+ */
+struct McTrial {
+
+    std::vector<unsigned long> updateTimeMs;                        // (ms) Drive time of each update
+    unsigned long              refreshFailures  { 0 };
+    unsigned int               wrongUpdates     { 0 };              // Updates leaving a segment visibly wrong
+};
+
+static int mcPinList[MC_NUM_SEGMENTS] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+// Same layout as the Eval Kit 7-segment masks; the dot (index 3) stays OFF
+static const bool mcDigitMasks[10][7] = {
+  {1,1,1,1,1,1,0}, {0,1,1,0,0,0,0}, {1,1,0,1,1,0,1}, {1,1,1,1,0,0,1}, {0,1,1,0,0,1,1},
+  {1,0,1,1,0,1,1}, {1,0,1,1,1,1,1}, {1,1,1,0,0,0,0}, {1,1,1,1,1,1,1}, {1,1,1,1,0,1,1}
+};
+
+
+/***************************************************************************/
+/********************************* HELPERS *********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Panel population of a profile name.
+ *
+ * @return false if the name is unknown
+ */
+/***************************************************************************/
+
+static bool selectProfile(const char* t_name, McProfile& t_profile)
+{
+  t_profile = McProfile();
+  if (strcmp(t_name, "nominal") == 0) {
+    t_profile.name = "nominal";
+    return true;
+  }
+  if (strcmp(t_name, "stress") != 0) {
+    return false;
+  }
+
+  t_profile.name                            = "stress";
+  t_profile.spread.seriesResistance         = 0.4f;
+  t_profile.spread.chargeTransferResistance = 0.5f;
+  t_profile.spread.doubleLayerCapacitance   = 0.3f;
+  t_profile.spread.chargeCapacity           = 0.5f;
+  t_profile.spread.coloredPotential         = 0.1f;
+  t_profile.spread.bleachedPotential        = 0.1f;
+  t_profile.spread.selfDischargeTime        = 0.5f;
+  t_profile.nominal.capacityFade            = 5.0e-6f;          // Aging rates of examples/Lifetime
+  t_profile.nominal.kineticsAging           = 1.0e-4f;
+  t_profile.nominal.selfDischargeAging      = 2.0e-4f;
+  t_profile.maxCycles                       = MC_STRESS_MAX_CYCLES;
+  t_profile.adcNoise                        = MC_STRESS_ADC_NOISE;
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulate one panel drawn from the profile.
+ */
+/***************************************************************************/
+
+static McTrial runTrial(const McProfile& t_profile, const ECD_Config& t_config, uint32_t t_seed)
+{
+  McTrial           trial;
+  YNV_ECD           display(MC_NUM_SEGMENTS, mcPinList);
+  YNV_ECD_Simulator sim;
+
+  display.attachSimulator(&sim);
+  display.setConfig(t_config);
+  sim.applySegmentSpread(t_profile.nominal, t_profile.spread, t_seed);
+
+  uint32_t ageState = t_seed * 2654435761u + 1;                    // Age drawn apart from the spread stream
+  ageState ^= ageState >> 15;
+  float age = t_profile.maxCycles * (float)(ageState % 10000) / 10000.0f;
+  for (int i = 0; i < MC_NUM_SEGMENTS; i++) {
+    sim.setSegmentCycles(i, age);
+    sim.setSegmentCharge(i, 0.0f);
+  }
+  sim.setAdcNoise(t_profile.adcNoise, t_seed);
+
+  display.begin();
+  display.resetStats();
+
+  for (int cycle = 0; cycle < MC_NUM_CYCLES; cycle++) {
+    for (unsigned int digit = 0; digit <= 9; digit++) {
+      bool frame[MC_NUM_SEGMENTS];
+      for (int i = 0, s = 0; i < MC_NUM_SEGMENTS; i++) {
+        frame[i] = (i == MC_DOT_SEGMENT) ? false : mcDigitMasks[digit][s++];
+        display.setSegmentState(i, frame[i]);
+      }
+
+      unsigned long driveTimeBefore = display.getStats().driveTimeMs;
+      display.executeDisplay();
+      trial.updateTimeMs.push_back(display.getStats().driveTimeMs - driveTimeBefore);
+
+      for (int i = 0; i < MC_NUM_SEGMENTS; i++) {
+        if (sim.isSegmentVisiblyColored(i) != frame[i]) {
+          trial.wrongUpdates++;
+          break;
+        }
+      }
+      sim.advanceTime(MC_HOLD_TIME);
+    }
+  }
+
+  trial.refreshFailures = display.getStats().refreshFailures;
+  display.attachSimulator(nullptr);
+  return trial;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief 95 % Wilson score interval of a proportion.
+ */
+/***************************************************************************/
+
+static void wilsonInterval(unsigned int t_hits, unsigned int t_trials, double& t_low, double& t_high)
+{
+  const double z      = 1.96;
+  double       p      = (double)t_hits / t_trials;
+  double       denom  = 1.0 + z * z / t_trials;
+  double       centre = (p + z * z / (2.0 * t_trials)) / denom;
+  double       half   = z * sqrt(p * (1.0 - p) / t_trials + z * z / (4.0 * t_trials * t_trials)) / denom;
+
+  t_low  = std::max(0.0, centre - half);
+  t_high = std::min(1.0, centre + half);
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  McProfile profile;
+  if (!selectProfile((argc > 1) ? argv[1] : "nominal", profile)) {
+    fprintf(stderr, "Usage: %s [nominal|stress] [trials] [threads] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned int trials     = (argc > 2) ? strtoul(argv[2], nullptr, 10) : MC_DEFAULT_TRIALS;
+  unsigned int numThreads = (argc > 3) ? strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+  uint32_t     seed       = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+  ECD_Config   config;                                              // Configuration under test
+
+  trials     = std::max(trials, 1u);
+  numThreads = constrain(numThreads, 1u, trials);
+
+  // One display and simulator per panel: workers pick the next trial
+  std::vector<McTrial>      results(trials);
+  std::atomic<unsigned int> nextTrial(0);
+  std::vector<std::thread>  workers;
+
+  for (unsigned int t = 0; t < numThreads; t++) {
+    workers.emplace_back([&]() {
+      for (unsigned int i = nextTrial++; i < trials; i = nextTrial++) {
+        results[i] = runTrial(profile, config, seed * 1000003u + i + 1);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<unsigned long> updateTimes;
+  unsigned int  panelsWithFailure = 0, panelsWithWrongState = 0;
+  unsigned long failureRounds = 0, wrongUpdates = 0;
+
+  for (const McTrial& trial : results) {
+    updateTimes.insert(updateTimes.end(), trial.updateTimeMs.begin(), trial.updateTimeMs.end());
+    panelsWithFailure    += (trial.refreshFailures > 0);
+    panelsWithWrongState += (trial.wrongUpdates > 0);
+    failureRounds        += trial.refreshFailures;
+    wrongUpdates         += trial.wrongUpdates;
+  }
+  std::sort(updateTimes.begin(), updateTimes.end());
+
+  auto percentile = [&](double t_fraction) {
+    return updateTimes[(size_t)(t_fraction * (updateTimes.size() - 1) + 0.5)];
+  };
+  double failureLow, failureHigh, wrongLow, wrongHigh;
+  wilsonInterval(panelsWithFailure, trials, failureLow, failureHigh);
+  wilsonInterval(panelsWithWrongState, trials, wrongLow, wrongHigh);
+
+  printf("{\"profile\":\"%s\",\"trials\":%u,\"updates\":%lu,\"p50_update_ms\":%lu,\"p99_update_ms\":%lu,"
+         "\"p999_update_ms\":%lu,\"max_update_ms\":%lu,",
+         profile.name, trials, (unsigned long)updateTimes.size(), percentile(0.50), percentile(0.99),
+         percentile(0.999), updateTimes.back());
+  printf("\"p_refresh_failure\":%.4f,\"p_refresh_failure_95\":[%.4f,%.4f],\"refresh_failure_rounds\":%lu,",
+         (double)panelsWithFailure / trials, failureLow, failureHigh, failureRounds);
+  printf("\"p_wrong_state\":%.4f,\"p_wrong_state_95\":[%.4f,%.4f],\"wrong_state_updates\":%lu,\"threads\":%u}\n",
+         (double)panelsWithWrongState / trials, wrongLow, wrongHigh, wrongUpdates, numThreads);
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
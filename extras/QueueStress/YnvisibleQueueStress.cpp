@@ -0,0 +1,301 @@
+/**
+ * @file YnvisibleQueueStress.cpp
+ * @brief Host stress test of ECD_CommandQueue with many producer threads.
+ *
+ * One owner thread drives a simulated 7-segment board through an
+ * ECD_CommandQueue; producer threads post frames, partial frames (some
+ * segments staged with SEGMENT_PRIORITY_HIGH), staged segments and updates,
+ * cancel at random and poll the status and the engine phase. The owner
+ * stalls for a moment at a random time inside each update, so cancels land in
+ * the middle of pulses as well as between commands.
+ *
+ * Invariants:
+ *  - Commands are reported in posting order, each accepted id exactly once,
+ *    always from the owner thread.
+ *  - After every command no WE pin is driven, the CE is released and the
+ *    simulator recorded no CE change while a WE was driven.
+ *  - A FRAME reported completed left every selected segment in the state it
+ *    requested.
+ *  - Queue counters: posted = executed + cancelled, depth never above the
+ *    capacity.
+ *
+ * A violated invariant prints a message and aborts.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -pthread -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleQueueStress.cpp \
+ *       ../../src/YnvisibleECDQueue.cpp ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_queuestress
+ *
+ * Build with ThreadSanitizer (data races between producers and the owner):
+ *   clang++ -std=gnu++11 -g -O1 -fsanitize=thread -DYNV_ECD_SIMULATOR -I<host core> -I../../src \
+ *       YnvisibleQueueStress.cpp ../../src/YnvisibleECDQueue.cpp ../../src/YnvisibleECD.cpp \
+ *       ../../src/YnvisibleECDSimulator.cpp -o ynv_queuestress_tsan
+ *
+ * Usage:
+ *   ynv_queuestress [producers] [commands per producer] [seed]
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDQueue.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define STRESS_NUM_SEGMENTS         7           // Segments of the simulated display
+#define STRESS_QUEUE_CAPACITY       8           // Commands in the queue
+#define STRESS_DEFAULT_PRODUCERS    8           // Producer threads
+#define STRESS_DEFAULT_COMMANDS     2000        // Commands posted per producer
+#define STRESS_STALL_US             50          // (us) Owner stall inside an update (cancel window)
+#define STRESS_MAX_STALL_MS         800         // (ms) Latest device time of the stall after the update start
+#define STRESS_WAIT_MS              5           // (ms) Owner wait for work / producer wait for completion
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Shared state of one stress run.
+ */
+struct StressRun {
+
+    YNV_ECD_Simulator              sim;
+    YNV_ECD*                       display        { nullptr };
+    ECD_CommandQueue*              queue          { nullptr };
+    std::thread::id                owner;
+    std::vector<uint8_t>           reports;                              // Reports per command id (owner only)
+    uint32_t                       lastReported   { 0 };                 // Owner only
+    unsigned long                  completedFrames{ 0 };                 // Owner only
+    unsigned long                  stoppedRunning { 0 };                 // Owner only: cancels that hit a running command
+    std::atomic<unsigned long>     accepted       { 0 };
+    std::atomic<unsigned long>     cancels        { 0 };
+    std::atomic<bool>              producersDone  { false };
+};
+
+static int stressPinList[STRESS_NUM_SEGMENTS] = {1, 2, 3, 4, 5, 6, 7};
+
+
+/***************************************************************************/
+/********************************* HELPERS *********************************/
+/***************************************************************************/
+
+static void stressFail(const char* t_invariant, uint32_t t_id)
+{
+  fprintf(stderr, "Invariant violated: %s (command %lu)\n", t_invariant, (unsigned long)t_id);
+  abort();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Owner stall inside an update, as a slow pulse would (simulated ISR).
+ */
+/***************************************************************************/
+
+static void stallHandler(void* t_context)
+{
+  (void)t_context;
+  std::this_thread::sleep_for(std::chrono::microseconds(STRESS_STALL_US));
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Completion callback: ordering, idle hardware and frame checks.
+ */
+/***************************************************************************/
+
+static void commandDone(const ECD_Command& t_command, bool t_completed, void* t_context)
+{
+  StressRun* run = (StressRun*)t_context;
+
+  if (std::this_thread::get_id() != run->owner) {
+    stressFail("command reported outside the owner thread", t_command.id);
+  }
+  if (t_command.id <= run->lastReported) {
+    stressFail("command reported out of posting order", t_command.id);
+  }
+  run->lastReported = t_command.id;
+  if (t_command.id >= run->reports.size() || ++run->reports[t_command.id] != 1) {
+    stressFail("command reported more than once", t_command.id);
+  }
+
+  if (run->sim.anySegmentDriven()) {
+    stressFail("WE pin left in OUTPUT", t_command.id);
+  }
+  if (run->sim.isCounterElectrodeEnabled()) {
+    stressFail("CE not released", t_command.id);
+  }
+  if (run->sim.getSafetyViolations() > 0) {
+    stressFail("CE changed or released while a WE was driven", t_command.id);
+  }
+
+  if (!t_completed && !t_command.cancelled) {
+    run->stoppedRunning++;
+  }
+  if (t_completed && t_command.type == ECD_CMD_FRAME) {
+    for (int i = 0; i < STRESS_NUM_SEGMENTS; i++) {
+      if ((t_command.select >> i) & 1) {
+        int expected = ((t_command.states >> i) & 1) ? SEGMENT_STATE_COLOR : SEGMENT_STATE_BLEACH;
+        if (run->display->getSegmentState(i) != expected) {
+          stressFail("completed frame not shown", t_command.id);
+        }
+      }
+    }
+    run->completedFrames++;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Owner thread: the only user of the display and the simulator.
+ */
+/***************************************************************************/
+
+static void ownerThread(StressRun* t_run, uint32_t t_seed)
+{
+  std::mt19937 generator(t_seed);
+
+  t_run->owner = std::this_thread::get_id();
+  while (!t_run->producersDone || t_run->queue->getDepth() > 0) {
+    if (!t_run->queue->waitForWork(STRESS_WAIT_MS)) {
+      continue;
+    }
+    t_run->sim.scheduleInterrupt(t_run->sim.millis() + generator() % STRESS_MAX_STALL_MS, stallHandler, nullptr);
+    t_run->queue->process();
+    t_run->sim.scheduleInterrupt(0, nullptr, nullptr);          // Drop the stall if the command ended first
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Producer thread: random posts, cancels and status polls.
+ */
+/***************************************************************************/
+
+static void producerThread(StressRun* t_run, unsigned long t_commands, uint32_t t_seed)
+{
+  std::mt19937     generator(t_seed);
+  ecdSegmentMask_t all = ((ecdSegmentMask_t)1 << STRESS_NUM_SEGMENTS) - 1;
+
+  for (unsigned long n = 0; n < t_commands; n++) {
+    uint32_t action = generator() % 100;
+    uint32_t id     = 0;
+
+    if (action < 5) {
+      t_run->queue->cancel();
+      t_run->cancels++;
+      continue;
+    }
+
+    while (id == 0) {                                             // Full queue: retry
+      if (action < 65) {
+        id = t_run->queue->postFrame(generator() & all);
+      } else if (action < 80) {
+        id = t_run->queue->postFrame(generator() & all, generator() & all, generator() & all);
+      } else if (action < 92) {
+        id = t_run->queue->postSegment(generator() % STRESS_NUM_SEGMENTS, generator() & 1);
+      } else {
+        id = t_run->queue->postExecute();
+      }
+      if (id == 0) {
+        std::this_thread::yield();
+      }
+    }
+    t_run->accepted++;
+
+    if (t_run->display->getPhase() > DRIVER_PHASE_DIRECT_DRIVE) {
+      stressFail("phase out of range", id);
+    }
+    uint8_t status = t_run->queue->getStatus(id);
+    if (status == ECD_CMD_STATUS_UNKNOWN) {
+      stressFail("accepted command unknown to the queue", id);
+    }
+    if (action % 10 == 0) {                                       // Wait for some commands to finish
+      t_run->queue->waitForCompletion(id, STRESS_WAIT_MS);
+    }
+    if (t_run->queue->getDepth() > t_run->queue->getCapacity()) {
+      stressFail("queue depth above capacity", id);
+    }
+  }
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  unsigned long producers = (argc > 1) ? strtoul(argv[1], nullptr, 10) : STRESS_DEFAULT_PRODUCERS;
+  unsigned long commands  = (argc > 2) ? strtoul(argv[2], nullptr, 10) : STRESS_DEFAULT_COMMANDS;
+  unsigned long seed      = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 1;
+
+  StressRun run;
+  YNV_ECD display(STRESS_NUM_SEGMENTS, stressPinList);
+  ECD_CommandQueueSized<STRESS_QUEUE_CAPACITY> queue(display);
+
+  auto wallStart = std::chrono::steady_clock::now();
+
+  run.display = &display;
+  run.queue   = &queue;
+  run.reports.assign(producers * commands + 2, 0);
+  display.attachSimulator(&run.sim);
+  queue.setCallback(commandDone, &run);
+  if (queue.postBegin() == 0) {
+    stressFail("begin rejected by an empty queue", 0);
+  }
+  run.accepted++;
+
+  std::thread owner(ownerThread, &run, (uint32_t)seed);
+  std::vector<std::thread> threads;
+  for (unsigned long p = 0; p < producers; p++) {
+    threads.push_back(std::thread(producerThread, &run, commands, (uint32_t)(seed * 1000 + p)));
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  run.producersDone = true;
+  owner.join();
+
+  ECD_QueueStats stats = queue.getStats();
+  if (stats.posted != run.accepted || stats.posted != stats.executed + stats.cancelled) {
+    stressFail("queue counters do not add up", queue.getCompletedId());
+  }
+  for (uint32_t id = 1; id <= stats.posted; id++) {
+    if (run.reports[id] != 1) {
+      stressFail("accepted command never reported", id);
+    }
+  }
+  if (stats.maxDepth > STRESS_QUEUE_CAPACITY) {
+    stressFail("queue depth above capacity", 0);
+  }
+
+  auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart).count();
+
+  printf("{\"producers\":%lu,\"posted\":%lu,\"executed\":%lu,\"cancelled\":%lu,\"rejected\":%lu,"
+         "\"cancel_calls\":%lu,\"stopped_running\":%lu,\"frames_checked\":%lu,\"max_depth\":%u,\"wall_ms\":%ld,\"result\":\"pass\"}\n",
+         producers, stats.posted, stats.executed, stats.cancelled, stats.rejected,
+         run.cancels.load(), run.stoppedRunning, run.completedFrames, stats.maxDepth, (long)wallMs);
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,376 @@
+
+/**
+ * @file YnvisibleStateFuzz.cpp
+ * @brief Host property test of the YNV_ECD segment state machine.
+ *
+ * Decodes a byte string into a sequence of engine operations and runs it on
+ * a simulated 7-segment board:
+ *  - setSegmentState() with in-range and out-of-range indices
+ *  - setAllSegmentsBleach(), executeDisplay(), directDriveAll()
+ *  - executeDisplay() with a cancel request (stop flag set from a simulated
+ *    interrupt) at any time during the update, i.e. in the middle of a pulse
+ *  - stop flag set/cleared between updates, long holds (self-discharge)
+ *  - forced segment charge states (disturbed panel), which reach the color
+ *    and bleach refresh paths quickly
+ *
+ * Invariants checked after every operation:
+ *  - No WE pin left in OUTPUT and the CE released (High-Z).
+ *  - No CE change or release while a WE was driven (simulator safety check).
+ *  - After an executeDisplay() that completed without a stop request, the
+ *    state of every segment matches the last commanded frame.
+ *  - Every executeDisplay() ends within FUZZ_MAX_UPDATE_MS of device time,
+ *    and the whole sequence within FUZZ_MAX_WALL_MS of host time.
+ *
+ * A violated invariant prints the failing operation sequence and aborts.
+ *
+ * Build the deterministic random runner (host, with an Arduino host core
+ * providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleStateFuzz.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_statefuzz
+ *
+ * Build for libFuzzer (the runner main() is left out):
+ *   clang++ -std=gnu++11 -g -O1 -fsanitize=fuzzer,address,undefined -DYNV_STATEFUZZ_LIBFUZZER \
+ *       -DYNV_ECD_SIMULATOR -I<host core> -I../../src YnvisibleStateFuzz.cpp \
+ *       ../../src/YnvisibleECD.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_statefuzz_lf
+ *
+ * Usage:
+ *   ynv_statefuzz [iterations] [seed]   Random sequences, reproducible from the seed
+ *   ynv_statefuzz <input file>          Replay one input (e.g. a libFuzzer crash file)
+ *   ynv_statefuzz_lf [corpus dir]       libFuzzer
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define FUZZ_NUM_SEGMENTS           7           // Segments of the simulated display
+#define FUZZ_MAX_OPERATIONS         64          // Operations decoded per input
+#define FUZZ_CANCEL_STEP_MS         4           // (ms) Cancel time resolution (x input byte)
+#define FUZZ_HOLD_STEP_MS           60000UL     // (ms) Hold time resolution (x input byte)
+#define FUZZ_MAX_WALL_MS            2000        // (ms) Host time allowed for one input
+#define FUZZ_DEFAULT_ITERATIONS     20000       // Random sequences run by default
+#define FUZZ_MAX_INPUT_LENGTH       256         // Bytes per random sequence
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Operations decoded from the input bytes.
+ */
+enum fuzzOperation_e {
+    FUZZ_OP_SET_SEGMENT     = 0,    // setSegmentState(index byte, state byte)
+    FUZZ_OP_ALL_BLEACH      = 1,    // setAllSegmentsBleach()
+    FUZZ_OP_EXECUTE         = 2,    // executeDisplay()
+    FUZZ_OP_EXECUTE_CANCEL  = 3,    // executeDisplay(), stop request after (byte x FUZZ_CANCEL_STEP_MS)
+    FUZZ_OP_STOP            = 4,    // setStopDrivingFlag()
+    FUZZ_OP_CLEAR_STOP      = 5,    // clearStopDriving()
+    FUZZ_OP_HOLD            = 6,    // advanceTime(byte x FUZZ_HOLD_STEP_MS)
+    FUZZ_OP_DIRECT_DRIVE    = 7,    // directDriveAll(state byte, Vsupply/2, byte ms)
+    FUZZ_OP_DISTURB         = 8,    // Simulator: setSegmentCharge(index byte, byte / 255)
+    FUZZ_NUM_OPERATIONS     = 9
+};
+
+/**
+ * @brief One fuzzed run: board, display and commanded frame.
+ */
+struct FuzzRun {
+
+    YNV_ECD_Simulator sim;
+    YNV_ECD*          display         { nullptr };
+    int               commanded       [FUZZ_NUM_SEGMENTS];      // Last state commanded per segment
+    bool              stopRequested   { false };                // Stop flag set since the last clear
+    unsigned long     maxUpdateMs     { 0 };                    // (ms) Device time bound of one update
+    std::string       log;                                      // Operations run so far
+};
+
+static int fuzzPinList[FUZZ_NUM_SEGMENTS] = {1, 2, 3, 4, 5, 6, 7};
+
+
+/***************************************************************************/
+/********************************* HELPERS *********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Report a violated invariant with the operations that led to it.
+ */
+/***************************************************************************/
+
+static void fuzzFail(const FuzzRun& t_run, const char* t_invariant)
+{
+  fprintf(stderr, "Invariant violated: %s\nOperations:\n%s", t_invariant, t_run.log.c_str());
+  abort();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Check the invariants that hold between any two operations.
+ */
+/***************************************************************************/
+
+static void checkIdle(const FuzzRun& t_run)
+{
+  if (t_run.sim.anySegmentDriven()) {
+    fuzzFail(t_run, "WE pin left in OUTPUT");
+  }
+  if (t_run.sim.isCounterElectrodeEnabled()) {
+    fuzzFail(t_run, "CE not released");
+  }
+  if (t_run.sim.getSafetyViolations() > 0) {
+    fuzzFail(t_run, "CE changed or released while a WE was driven");
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated ISR of a cancel request (as the Eval Kit button).
+ */
+/***************************************************************************/
+
+static void cancelHandler(void* t_context)
+{
+  FuzzRun* run = (FuzzRun*)t_context;
+
+  run->display->setStopDrivingFlag();
+  run->stopRequested = true;
+  run->log += "    <stop request>\n";
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Run executeDisplay() and check its duration and resulting frame.
+ */
+/***************************************************************************/
+
+static void runExecute(FuzzRun& t_run)
+{
+  unsigned long start = t_run.sim.millis();
+  t_run.display->executeDisplay();
+
+  if (t_run.sim.millis() - start > t_run.maxUpdateMs) {
+    fuzzFail(t_run, "executeDisplay() exceeded its device time bound");
+  }
+  if (t_run.stopRequested) {                                // Interrupted update: frame may be partial
+    return;
+  }
+  for (int i = 0; i < FUZZ_NUM_SEGMENTS; i++) {
+    if (t_run.commanded[i] != SEGMENT_STATE_UNDEFINED && t_run.display->getSegmentState(i) != t_run.commanded[i]) {
+      fuzzFail(t_run, "segment state differs from the last commanded frame");
+    }
+  }
+}
+
+
+/***************************************************************************/
+/***************************** PROPERTY TEST *******************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Decode and run one operation sequence, checking all invariants.
+ */
+/***************************************************************************/
+
+static void runSequence(const uint8_t* t_data, size_t t_size)
+{
+  FuzzRun run;
+  YNV_ECD display(FUZZ_NUM_SEGMENTS, fuzzPinList);
+  ECD_Config config;
+
+  auto wallStart = std::chrono::steady_clock::now();
+
+  run.display = &display;
+  display.attachSimulator(&run.sim);
+  display.begin();
+  for (int i = 0; i < FUZZ_NUM_SEGMENTS; i++) {
+    run.commanded[i] = SEGMENT_STATE_BLEACH;
+  }
+
+  // Worst case update: 5 CE settles, both transitions, all refresh retries
+  run.maxUpdateMs = 5 * 50 + config.bleachingTime + config.coloringTime +
+                    MAX_REFRESH_RETRIES * (config.refreshBleachPulseTime + config.refreshColorPulseTime);
+  run.log = "begin\n";
+  checkIdle(run);
+
+  size_t position = 0;
+  auto nextByte = [&]() -> uint8_t { return (position < t_size) ? t_data[position++] : 0; };
+
+  for (int n = 0; n < FUZZ_MAX_OPERATIONS && position < t_size; n++) {
+    uint8_t operation = nextByte() % FUZZ_NUM_OPERATIONS;
+    char    line[80];
+
+    switch (operation) {
+      case FUZZ_OP_SET_SEGMENT: {
+        int  segment = (int)(nextByte() % (FUZZ_NUM_SEGMENTS + 4)) - 2;    // Includes invalid indices
+        bool state   = nextByte() & 1;
+
+        snprintf(line, sizeof(line), "setSegmentState(%d, %d)\n", segment, state);
+        run.log += line;
+        display.setSegmentState(segment, state);
+        if (segment >= 0 && segment < FUZZ_NUM_SEGMENTS) {
+          run.commanded[segment] = state ? SEGMENT_STATE_COLOR : SEGMENT_STATE_BLEACH;
+        }
+        break;
+      }
+
+      case FUZZ_OP_ALL_BLEACH:
+        run.log += "setAllSegmentsBleach()\n";
+        display.setAllSegmentsBleach();
+        for (int i = 0; i < FUZZ_NUM_SEGMENTS; i++) {
+          run.commanded[i] = SEGMENT_STATE_BLEACH;
+        }
+        break;
+
+      case FUZZ_OP_EXECUTE:
+        run.log += "executeDisplay()\n";
+        runExecute(run);
+        break;
+
+      case FUZZ_OP_EXECUTE_CANCEL: {
+        unsigned long cancelMs = (unsigned long)nextByte() * FUZZ_CANCEL_STEP_MS;
+
+        snprintf(line, sizeof(line), "executeDisplay() with stop request at +%lu ms\n", cancelMs);
+        run.log += line;
+        run.sim.scheduleInterrupt(run.sim.millis() + cancelMs, cancelHandler, &run);
+        runExecute(run);
+        run.sim.scheduleInterrupt(0, nullptr, nullptr);     // Drop the request if the update ended first
+        break;
+      }
+
+      case FUZZ_OP_STOP:
+        run.log += "setStopDrivingFlag()\n";
+        display.setStopDrivingFlag();
+        run.stopRequested = true;
+        break;
+
+      case FUZZ_OP_CLEAR_STOP:
+        run.log += "clearStopDriving()\n";
+        display.clearStopDriving();
+        run.stopRequested = false;
+        break;
+
+      case FUZZ_OP_HOLD: {
+        unsigned long holdMs = (unsigned long)nextByte() * FUZZ_HOLD_STEP_MS;
+
+        snprintf(line, sizeof(line), "hold %lu ms\n", holdMs);
+        run.log += line;
+        run.sim.advanceTime(holdMs);
+        break;
+      }
+
+      case FUZZ_OP_DIRECT_DRIVE: {
+        bool          state   = nextByte() & 1;
+        unsigned long driveMs = nextByte();
+
+        snprintf(line, sizeof(line), "directDriveAll(%d, Vsupply/2, %lu)\n", state, driveMs);
+        run.log += line;
+        display.directDriveAll(state, SUPPLY_VOLTAGE / 2, driveMs);
+        break;
+      }
+
+      case FUZZ_OP_DISTURB: {
+        int   segment = nextByte() % FUZZ_NUM_SEGMENTS;
+        float charge  = nextByte() / 255.0f;
+
+        snprintf(line, sizeof(line), "disturb segment %d to charge %.2f\n", segment, charge);
+        run.log += line;
+        run.sim.setSegmentCharge(segment, charge);
+        break;
+      }
+    }
+
+    checkIdle(run);
+  }
+
+  auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart).count();
+  if (wallMs > FUZZ_MAX_WALL_MS) {
+    fuzzFail(run, "sequence exceeded its host time bound");
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief libFuzzer entry point.
+ */
+/***************************************************************************/
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* t_data, size_t t_size)
+{
+  runSequence(t_data, t_size);
+  return 0;
+}
+
+
+#ifndef YNV_STATEFUZZ_LIBFUZZER
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  // Replay of a single input file
+  if (argc == 2 && (argv[1][0] < '0' || argv[1][0] > '9')) {
+    FILE* file = fopen(argv[1], "rb");
+    if (file == nullptr) {
+      fprintf(stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+    }
+    std::vector<uint8_t> input;
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+      input.push_back((uint8_t)c);
+    }
+    fclose(file);
+
+    runSequence(input.data(), input.size());
+    printf("{\"input\":\"%s\",\"bytes\":%u,\"result\":\"pass\"}\n", argv[1], (unsigned int)input.size());
+    return 0;
+  }
+
+  // Deterministic random runner: sequence i uses seed + i
+  unsigned long iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : FUZZ_DEFAULT_ITERATIONS;
+  unsigned long seed       = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1;
+
+  std::vector<uint8_t> input(FUZZ_MAX_INPUT_LENGTH);
+  for (unsigned long i = 0; i < iterations; i++) {
+    std::mt19937 generator((uint32_t)(seed + i));
+    size_t length = 1 + generator() % FUZZ_MAX_INPUT_LENGTH;
+
+    for (size_t b = 0; b < length; b++) {
+      input[b] = (uint8_t)generator();
+    }
+    fprintf(stderr, "\rsequence %lu (seed %lu)", i, seed + i);
+    runSequence(input.data(), length);
+  }
+
+  printf("\n{\"sequences\":%lu,\"seed\":%lu,\"result\":\"pass\"}\n", iterations, seed);
+  return 0;
+}
+
+#endif
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,519 @@
+
+/**
+ * @file YnvisibleSystemId.cpp
+ * @brief Host tool fitting segment equivalent-circuit parameters to recorded traces.
+ *
+ * Reads a recorded I/O trace (one "time,type,pin,value" line per event, as
+ * printed by YNV_ECD_Simulator::printTraceEvent()) and fits, for every
+ * segment, the ECD_SegmentModel parameters that best reproduce the recorded
+ * OCP readings.
+ *
+ * Responsibilities:
+ *  - Parse the trace and find the CE pin (DAC writes) and the segment pins.
+ *  - For a candidate model, replay the recorded drive actions (CE DAC code,
+ *    WE pin modes/levels, elapsed time) on a single-segment simulator and
+ *    compare the simulated High-Z WE voltage with every recorded analogRead()
+ *    (transitions, refresh checks and idle decay alike).
+ *  - Minimise the squared residuals with Levenberg-Marquardt (finite
+ *    difference Jacobian, log-scaled resistances, capacitances and times).
+ *  - Fit the segments in parallel, one simulator instance per thread.
+ *  - Print the results as ECD_SegmentModel profiles for the simulator and as
+ *    self-discharge seeds (time constant, rest OCP) for an on-device decay
+ *    model.
+ *
+ * Notes:
+ *  - Segments share nothing but the CE in the model, so each one is fitted
+ *    independently of the others.
+ *  - The trace must start from power-up (segments bleached, e.g. begin()),
+ *    which is the initial state of the simulator.
+ *  - Fitted values are only as good as the excitation: a trace without long
+ *    holds cannot identify the self-discharge time, and parameters with no
+ *    effect on the readings stay near their defaults.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h):
+ *   g++ -std=gnu++11 -O2 -pthread -DYNV_ECD_SIMULATOR -I<host core> -I../../src \
+ *       YnvisibleSystemId.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_sysid
+ *
+ * Usage:
+ *   ynv_sysid <trace.csv> [supply voltage (V)]
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECDSimulator.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define SYSID_NUM_PARAMS            8           // Fitted parameters per segment
+#define SYSID_MAX_ITERATIONS        60          // Levenberg-Marquardt iterations
+#define SYSID_MAX_LAMBDA            1.0e10      // Damping at which the fit gives up
+#define SYSID_TOLERANCE             1.0e-9      // Relative cost improvement to stop
+#define SYSID_LOG_STEP              0.01        // Finite difference step on log parameters and rest charge
+#define SYSID_POTENTIAL_STEP        0.005       // (V) Finite difference step on potentials
+
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Recorded trace and the board configuration found in it.
+ */
+struct SysIdTrace {
+
+    std::vector<ECD_SimEvent> events;
+    std::vector<int>          segmentPins;                          // In order of first appearance
+    int                       counterElectrodePin { -1 };
+    float                     supplyVoltage       { SUPPLY_VOLTAGE };
+};
+
+/**
+ * @brief Fit result of one segment.
+ */
+struct SysIdResult {
+
+    ECD_SegmentModel model;
+    unsigned int     samples      { 0 };                            // Recorded OCP readings used
+    double           rmsResidual  { 0.0 };                          // (V)
+    int              iterations   { 0 };
+};
+
+
+/***************************************************************************/
+/*************************** TRACE AND MODEL I/O ***************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Load a trace file; lines that are not "time,type,pin,value" are skipped.
+ */
+/***************************************************************************/
+
+static bool loadTrace(const char* t_path, SysIdTrace& t_trace)
+{
+  FILE* file = fopen(t_path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    unsigned long time;
+    int type, pin, value;
+
+    if (sscanf(line, "%lu,%d,%d,%d", &time, &type, &pin, &value) != 4 ||
+        type < ECD_SIM_EVENT_PIN_MODE || type > ECD_SIM_EVENT_PHASE) {
+      continue;
+    }
+
+    ECD_SimEvent event;
+    event.timeMs = time;
+    event.type   = (ECD_SimEventType)type;
+    event.pin    = (uint8_t)pin;
+    event.value  = value;
+    t_trace.events.push_back(event);
+
+    if (event.type == ECD_SIM_EVENT_ANALOG_WRITE) {
+      t_trace.counterElectrodePin = pin;
+    }
+  }
+  fclose(file);
+
+  // Every other pin configured or read by the engine is a segment (WE)
+  for (const ECD_SimEvent& event : t_trace.events) {
+    bool segmentAccess = event.type == ECD_SIM_EVENT_PIN_MODE || event.type == ECD_SIM_EVENT_ANALOG_READ;
+    bool known         = event.pin == t_trace.counterElectrodePin;
+
+    for (int pin : t_trace.segmentPins) {
+      known |= (pin == event.pin);
+    }
+    if (segmentAccess && !known) {
+      t_trace.segmentPins.push_back(event.pin);
+    }
+  }
+
+  return t_trace.counterElectrodePin >= 0 && !t_trace.segmentPins.empty();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Convert between an ECD_SegmentModel and the fitted parameter vector.
+ *
+ * Positive quantities are fitted in log scale so they can never change sign
+ * and steps are relative.
+ */
+/***************************************************************************/
+
+static void modelToParams(const ECD_SegmentModel& t_model, double* t_params)
+{
+  t_params[0] = log(t_model.seriesResistance);
+  t_params[1] = log(t_model.chargeTransferResistance);
+  t_params[2] = log(t_model.doubleLayerCapacitance);
+  t_params[3] = log(t_model.chargeCapacity);
+  t_params[4] = log(t_model.selfDischargeTime);
+  t_params[5] = t_model.bleachedPotential;
+  t_params[6] = t_model.coloredPotential;
+  t_params[7] = t_model.restCharge;
+}
+
+static void paramsToModel(const double* t_params, ECD_SegmentModel& t_model)
+{
+  t_model.seriesResistance         = (float)exp(t_params[0]);
+  t_model.chargeTransferResistance = (float)exp(t_params[1]);
+  t_model.doubleLayerCapacitance   = (float)exp(t_params[2]);
+  t_model.chargeCapacity           = (float)exp(t_params[3]);
+  t_model.selfDischargeTime        = (float)exp(t_params[4]);
+  t_model.bleachedPotential        = (float)t_params[5];
+  t_model.coloredPotential         = (float)t_params[6];
+  t_model.restCharge               = (float)constrain(t_params[7], 0.0, 1.0);
+}
+
+
+/***************************************************************************/
+/********************************* FITTING *********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Residuals of a candidate model against the recorded OCP readings.
+ *
+ * Replays the drive actions of the trace on a single-segment simulator. For
+ * every recorded analogRead() of the segment while its WE is High-Z, the
+ * residual is the simulated WE voltage (CE + OCP + double layer) minus the
+ * recorded one, in volts. Reads of a driven WE carry no information and are
+ * skipped.
+ */
+/***************************************************************************/
+
+static void computeResiduals(const SysIdTrace& t_trace, int t_pin, const ECD_SegmentModel& t_model,
+                             std::vector<double>& t_residuals)
+{
+  const double lsbVoltage = t_trace.supplyVoltage / ADC_DAC_MAX_LSB;
+
+  YNV_ECD_Simulator sim;
+  sim.setCounterElectrodePin(t_trace.counterElectrodePin);
+  sim.setSupplyVoltage(t_trace.supplyVoltage);
+  sim.addSegment(t_pin);
+  sim.setSegmentModel(0, t_model);
+
+  int  counterElectrodeLSB = ADC_DAC_MAX_LSB / 2;
+  bool segmentDriven       = false;
+
+  t_residuals.clear();
+
+  for (const ECD_SimEvent& event : t_trace.events) {
+
+    if (event.timeMs > sim.millis()) {
+      sim.advanceTime(event.timeMs - sim.millis());
+    }
+
+    if (event.pin != t_pin && event.pin != t_trace.counterElectrodePin) {
+      continue;                                             // Other segments do not affect this one
+    }
+
+    switch (event.type) {
+      case ECD_SIM_EVENT_PIN_MODE:
+        sim.pinMode(event.pin, event.value);
+        if (event.pin == t_pin) {
+          segmentDriven = (event.value == OUTPUT);
+        }
+        break;
+
+      case ECD_SIM_EVENT_DIGITAL_WRITE:
+        sim.digitalWrite(event.pin, event.value);
+        break;
+
+      case ECD_SIM_EVENT_ANALOG_WRITE:
+        sim.analogWrite(event.pin, event.value);
+        counterElectrodeLSB = event.value;
+        break;
+
+      case ECD_SIM_EVENT_ANALOG_READ:
+        if (event.pin == t_pin && !segmentDriven) {
+          double simulated = counterElectrodeLSB * lsbVoltage + sim.getSegmentOcp(0);
+          t_residuals.push_back(simulated - event.value * lsbVoltage);
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Solve the dense linear system A·x = b (Gaussian elimination, partial pivoting).
+ *
+ * @return false if A is singular.
+ */
+/***************************************************************************/
+
+static bool solveLinearSystem(double t_a[SYSID_NUM_PARAMS][SYSID_NUM_PARAMS], double* t_b, double* t_x)
+{
+  const int n = SYSID_NUM_PARAMS;
+
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < n; row++) {
+      if (fabs(t_a[row][col]) > fabs(t_a[pivot][col])) {
+        pivot = row;
+      }
+    }
+    if (fabs(t_a[pivot][col]) < 1.0e-300) {
+      return false;
+    }
+    for (int k = 0; k < n; k++) {
+      double tmp = t_a[col][k]; t_a[col][k] = t_a[pivot][k]; t_a[pivot][k] = tmp;
+    }
+    double tmp = t_b[col]; t_b[col] = t_b[pivot]; t_b[pivot] = tmp;
+
+    for (int row = col + 1; row < n; row++) {
+      double factor = t_a[row][col] / t_a[col][col];
+      for (int k = col; k < n; k++) {
+        t_a[row][k] -= factor * t_a[col][k];
+      }
+      t_b[row] -= factor * t_b[col];
+    }
+  }
+
+  for (int row = n - 1; row >= 0; row--) {
+    double sum = t_b[row];
+    for (int k = row + 1; k < n; k++) {
+      sum -= t_a[row][k] * t_x[k];
+    }
+    t_x[row] = sum / t_a[row][row];
+  }
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Sum of squared residuals.
+ */
+/***************************************************************************/
+
+static double sumOfSquares(const std::vector<double>& t_residuals)
+{
+  double sum = 0.0;
+  for (double r : t_residuals) {
+    sum += r * r;
+  }
+  return sum;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Fit one segment with Levenberg-Marquardt, starting from the defaults.
+ */
+/***************************************************************************/
+
+static SysIdResult fitSegment(const SysIdTrace& t_trace, int t_pin)
+{
+  const int n = SYSID_NUM_PARAMS;
+
+  SysIdResult      result;
+  ECD_SegmentModel model;
+  double           params[SYSID_NUM_PARAMS];
+  double           trial[SYSID_NUM_PARAMS];
+  double           lambda = 1.0e-3;
+
+  std::vector<double> residuals, trialResiduals;
+  std::vector<double> jacobian[SYSID_NUM_PARAMS];
+
+  modelToParams(model, params);
+  computeResiduals(t_trace, t_pin, model, residuals);
+  double cost = sumOfSquares(residuals);
+
+  for (result.iterations = 0; result.iterations < SYSID_MAX_ITERATIONS && !residuals.empty(); result.iterations++) {
+
+    // Forward difference Jacobian, one column per parameter
+    for (int j = 0; j < n; j++) {
+      double step = (j == 5 || j == 6) ? SYSID_POTENTIAL_STEP : SYSID_LOG_STEP;
+      for (int k = 0; k < n; k++) {
+        trial[k] = params[k];
+      }
+      trial[j] += step;
+      paramsToModel(trial, model);
+      computeResiduals(t_trace, t_pin, model, trialResiduals);
+
+      jacobian[j].resize(residuals.size());
+      for (size_t i = 0; i < residuals.size(); i++) {
+        jacobian[j][i] = (trialResiduals[i] - residuals[i]) / step;
+      }
+    }
+
+    // Normal equations: (JᵀJ + λ·diag(JᵀJ))·δ = -Jᵀr
+    double jtj[SYSID_NUM_PARAMS][SYSID_NUM_PARAMS];
+    double jtr[SYSID_NUM_PARAMS];
+    for (int a = 0; a < n; a++) {
+      jtr[a] = 0.0;
+      for (size_t i = 0; i < residuals.size(); i++) {
+        jtr[a] -= jacobian[a][i] * residuals[i];
+      }
+      for (int b = 0; b < n; b++) {
+        jtj[a][b] = 0.0;
+        for (size_t i = 0; i < residuals.size(); i++) {
+          jtj[a][b] += jacobian[a][i] * jacobian[b][i];
+        }
+      }
+    }
+
+    bool improved = false;
+    while (!improved && lambda < SYSID_MAX_LAMBDA) {
+      double system[SYSID_NUM_PARAMS][SYSID_NUM_PARAMS];
+      double rhs[SYSID_NUM_PARAMS];
+      double delta[SYSID_NUM_PARAMS];
+
+      for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+          system[a][b] = jtj[a][b];
+        }
+        system[a][a] += lambda * jtj[a][a] + 1.0e-12;       // Keeps unobservable parameters in place
+        rhs[a]        = jtr[a];
+      }
+
+      if (solveLinearSystem(system, rhs, delta)) {
+        for (int k = 0; k < n; k++) {
+          trial[k] = params[k] + delta[k];
+        }
+        paramsToModel(trial, model);
+        computeResiduals(t_trace, t_pin, model, trialResiduals);
+        double trialCost = sumOfSquares(trialResiduals);
+
+        if (trialCost < cost) {
+          improved = (cost - trialCost) > SYSID_TOLERANCE * cost;
+          for (int k = 0; k < n; k++) {
+            params[k] = trial[k];
+          }
+          residuals.swap(trialResiduals);
+          cost    = trialCost;
+          lambda /= 10.0;
+          if (!improved) {
+            lambda = SYSID_MAX_LAMBDA;                      // Converged
+          }
+          break;
+        }
+      }
+      lambda *= 10.0;
+    }
+
+    if (!improved) {
+      break;
+    }
+  }
+
+  paramsToModel(params, result.model);
+  result.samples     = residuals.size();
+  result.rmsResidual = residuals.empty() ? 0.0 : sqrt(cost / residuals.size());
+  return result;
+}
+
+
+/***************************************************************************/
+/********************************* OUTPUT **********************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Print the fitted models as simulator profiles and decay seeds.
+ */
+/***************************************************************************/
+
+static void printResults(const SysIdTrace& t_trace, const std::vector<SysIdResult>& t_results)
+{
+  printf("// Simulator profiles, in YNV_ECD_Simulator segment order\n");
+  for (size_t i = 0; i < t_results.size(); i++) {
+    const ECD_SegmentModel& m = t_results[i].model;
+
+    printf("// Segment %u (pin %d): %u OCP samples, RMS residual %.1f mV, %d iterations\n",
+           (unsigned)i, t_trace.segmentPins[i], t_results[i].samples,
+           t_results[i].rmsResidual * 1000.0, t_results[i].iterations);
+    printf("{\n");
+    printf("  ECD_SegmentModel model;\n");
+    printf("  model.seriesResistance         = %.1ff;   // (Ohm)\n", m.seriesResistance);
+    printf("  model.chargeTransferResistance = %.1ff;   // (Ohm)\n", m.chargeTransferResistance);
+    printf("  model.doubleLayerCapacitance   = %.3ef;   // (F)\n", m.doubleLayerCapacitance);
+    printf("  model.chargeCapacity           = %.3ef;   // (C)\n", m.chargeCapacity);
+    printf("  model.bleachedPotential        = %.3ff;   // (V)\n", m.bleachedPotential);
+    printf("  model.coloredPotential         = %.3ff;   // (V)\n", m.coloredPotential);
+    printf("  model.restCharge               = %.3ff;\n", m.restCharge);
+    printf("  model.selfDischargeTime        = %.1ff;   // (ms)\n", m.selfDischargeTime);
+    printf("  simBoard.setSegmentModel(%u, model);\n", (unsigned)i);
+    printf("}\n");
+  }
+
+  printf("\n// Decay model seeds: { self-discharge time constant (ms), rest OCP (V) } per segment\n");
+  printf("const float decayModelSeeds[%u][2] = {\n", (unsigned)t_results.size());
+  for (size_t i = 0; i < t_results.size(); i++) {
+    const ECD_SegmentModel& m = t_results[i].model;
+    float restPotential = m.bleachedPotential + m.restCharge * (m.coloredPotential - m.bleachedPotential);
+
+    printf("  { %.1ff, %.3ff }%s  // pin %d\n", m.selfDischargeTime, restPotential,
+           (i + 1 < t_results.size()) ? "," : " ", t_trace.segmentPins[i]);
+  }
+  printf("};\n");
+}
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <trace.csv> [supply voltage (V)]\n", argv[0]);
+    return 1;
+  }
+
+  SysIdTrace trace;
+  if (argc > 2) {
+    trace.supplyVoltage = (float)atof(argv[2]);
+  }
+  if (!loadTrace(argv[1], trace)) {
+    fprintf(stderr, "No CE DAC writes or segment reads found in %s\n", argv[1]);
+    return 1;
+  }
+
+  // One simulator per thread: workers pick the next unfitted segment
+  std::vector<SysIdResult> results(trace.segmentPins.size());
+  std::atomic<unsigned int> nextSegment(0);
+  unsigned int numThreads = std::thread::hardware_concurrency();
+  numThreads = constrain(numThreads, 1u, (unsigned int)trace.segmentPins.size());
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < numThreads; t++) {
+    workers.emplace_back([&]() {
+      for (unsigned int i = nextSegment++; i < trace.segmentPins.size(); i = nextSegment++) {
+        results[i] = fitSegment(trace, trace.segmentPins[i]);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  printResults(trace, results);
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
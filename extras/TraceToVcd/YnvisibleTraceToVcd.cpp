@@ -0,0 +1,89 @@
+
+/**
+ * @file YnvisibleTraceToVcd.cpp
+ * @brief Host tool converting recorded I/O traces to VCD waveforms.
+ *
+ * Reads a recorded I/O trace (one "time,type,pin,value" line per event, as
+ * printed by YNV_ECD_Simulator::printTraceEvent() on the simulator or
+ * captured from a board) and writes it as a Value Change Dump for GTKWave or
+ * any other waveform viewer, using YNV_ECD_Simulator::writeTraceVcd().
+ *
+ * Notes:
+ *  - Times are shifted so that the first event is at 0 ms.
+ *  - Engine phase changes (ECD_SIM_EVENT_PHASE) are only present in traces
+ *    recorded by the simulator; the phase signal stays idle otherwise.
+ *
+ * Build (host, with an Arduino host core providing Arduino.h and a Serial
+ * writing to standard output):
+ *   g++ -std=gnu++11 -O2 -DYNV_ECD_SIMULATOR -I<host core> -I../../src \
+ *       YnvisibleTraceToVcd.cpp ../../src/YnvisibleECDSimulator.cpp -o ynv_trace2vcd
+ *
+ * Usage:
+ *   ynv_trace2vcd <trace.csv> > trace.vcd
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "Arduino.h"
+#include "YnvisibleECDSimulator.h"
+
+
+/***************************************************************************/
+/*********************************** MAIN **********************************/
+/***************************************************************************/
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <trace.csv>\n", argv[0]);
+    return 1;
+  }
+
+  FILE* file = fopen(argv[1], "r");
+  if (file == nullptr) {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  // Lines that are not "time,type,pin,value" are skipped
+  std::vector<ECD_SimEvent> events;
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    unsigned long time;
+    int type, pin, value;
+
+    if (sscanf(line, "%lu,%d,%d,%d", &time, &type, &pin, &value) != 4 ||
+        type < ECD_SIM_EVENT_PIN_MODE || type > ECD_SIM_EVENT_PHASE) {
+      continue;
+    }
+
+    ECD_SimEvent event;
+    event.timeMs = time;
+    event.type   = (ECD_SimEventType)type;
+    event.pin    = (uint8_t)pin;
+    event.value  = value;
+    events.push_back(event);
+  }
+  fclose(file);
+
+  if (events.empty()) {
+    fprintf(stderr, "No events found in %s\n", argv[1]);
+    return 1;
+  }
+
+  unsigned long start = events.front().timeMs;
+  for (ECD_SimEvent& event : events) {
+    event.timeMs -= start;
+  }
+
+  YNV_ECD_Simulator::writeTraceVcd(Serial, events.data(), (unsigned int)events.size());
+  return 0;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -38,44 +38,163 @@
 #include "Arduino.h"
 #include "YnvisibleECD.h"
 
+#ifdef YNV_ECD_SIMULATOR
+#include "YnvisibleECDSimulator.h"
+#endif
+
+#ifdef YNV_ECD_NOOP_HAL
+int ynvNoopHalReading = 0;                                // ADC code returned by ECD_NoopHal
+#endif
+
+#ifdef YNV_ECD_NO_STATS
+#define ECD_STATS_ADD(t_field, t_value)
+#else
+#define ECD_STATS_ADD(t_field, t_value)     (m_stats.t_field += (t_value))   // Driving statistics counter update
+#endif
+
+#define ECD_SEGMENT_BIT(t_segment)          ((ecdSegmentMask_t)1 << (t_segment))  // Mask of one segment
+
+
+/**
+ * @brief Copy of a segment pin list, for displays that own their storage.
+ */
+static const int* copyPinList(const int* t_segments, int t_numberOfSegments)
+{
+  int  count = constrain(t_numberOfSegments, 0, MAX_NUMBER_OF_SEGMENTS);
+  int* pins  = new int[count];
+
+  for (int i = 0; i < count; i++) {
+    pins[i] = t_segments[i];
+  }
+  return pins;
+}
+
+
+#ifndef YNV_ECD_NO_STATS
+/**
+ * @brief Number of segments in a mask.
+ */
+static int countSegments(ecdSegmentMask_t t_mask)
+{
+  int count = 0;
+
+  for (; t_mask != 0; t_mask &= t_mask - 1) {
+    count++;
+  }
+  return count;
+}
+#endif
+
 
 /***************************************************************************/
 /**************************** PUBLIC FUNCTIONS *****************************/
 /***************************************************************************/
 
+/***************************************************************************/
+/**
+ * @brief Add the counters of another ECD_Stats (totals over displays).
+ *
+ * A counter added to ECD_Stats must be added here too: the size check
+ * below fails to compile until it is.
+ */
+/***************************************************************************/
+
+ECD_Stats& ECD_Stats::operator+=(const ECD_Stats& t_other)
+{
+  static_assert(sizeof(ECD_Stats) == 15 * sizeof(unsigned long), "ECD_Stats::operator+= must add every counter");
+
+  executeCount      += t_other.executeCount;
+  driveTimeMs       += t_other.driveTimeMs;
+  ceSettles         += t_other.ceSettles;
+  colorPulses       += t_other.colorPulses;
+  bleachPulses      += t_other.bleachPulses;
+  refreshRetries    += t_other.refreshRetries;
+  refreshFailures   += t_other.refreshFailures;
+  priorityPhases    += t_other.priorityPhases;
+  refreshTriggers   += t_other.refreshTriggers;
+  refreshRounds     += t_other.refreshRounds;
+  marginalJoins     += t_other.marginalJoins;
+  hysteresisHolds   += t_other.hysteresisHolds;
+  deferredRefreshes += t_other.deferredRefreshes;
+  watchConversions  += t_other.watchConversions;
+  watchEvents       += t_other.watchEvents;
+  return *this;
+}
+
+
 /***************************************************************************/
 /**
  * @brief Ynvisible's Electrochromic Display driver
  * 
  * @param t_numberOfSegments display's number of segments
  * @param t_segments array of segments' pins
+ * @param t_counterElectrodePin Counter Electrode (DAC) pin, PIN_CE on the Driver v5
+ *
+ * @note No state is shared between objects, so several independent boards
+ *       (e.g. simulated ones) can be driven from the same program.
+ * @note The per-segment storage is allocated once here; use the storage
+ *       constructor or YNV_ECD_Sized to avoid the heap.
+ */
+/***************************************************************************/
+
+ YNV_ECD::YNV_ECD(int t_numberOfSegments, int t_segments[], int t_counterElectrodePin)
+  : YNV_ECD(t_numberOfSegments, copyPinList(t_segments, t_numberOfSegments), t_counterElectrodePin,
+            new uint16_t[constrain(t_numberOfSegments, 0, MAX_NUMBER_OF_SEGMENTS)])
+{
+  m_ownsStorage = true;                                           // Released by the destructor
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Ynvisible's Electrochromic Display driver on caller storage
+ *
+ * @param t_numberOfSegments display's number of segments (up to MAX_NUMBER_OF_SEGMENTS)
+ * @param t_segments array of segments' pins, referenced (not copied) for the lifetime of the object
+ * @param t_counterElectrodePin Counter Electrode (DAC) pin, PIN_CE on the Driver v5
+ * @param t_ocpStorage t_numberOfSegments OCP readings, kept for the lifetime of the object
  */
 /***************************************************************************/
 
- YNV_ECD::YNV_ECD(int t_numberOfSegments, int t_segments[])       // Constructor - Display Initialization
+ YNV_ECD::YNV_ECD(int t_numberOfSegments, const int t_segments[], int t_counterElectrodePin, uint16_t* t_ocpStorage)       // Constructor - Display Initialization
 {
-  m_counterElectrodePin = PIN_CE;                                 // Configuration of Counter Electrode Pin
-  pinMode(m_counterElectrodePin, INPUT);                          // Keep CE in High-Z until driving is active
+  m_counterElectrodePin = t_counterElectrodePin;                  // Configuration of Counter Electrode Pin
+  m_hal.releaseCounterElectrode(m_counterElectrodePin);           // Keep CE in High-Z until driving is active
 
-  analogReadResolution(ADC_DAC_RESOLUTION);                       // Set ADC and DAC resolution to 10 bits operation
-  analogWriteResolution(ADC_DAC_RESOLUTION);
+  m_hal.begin(ADC_DAC_RESOLUTION);                                // Set ADC and DAC resolution to 10 bits operation
 
-  m_numberOfSegments          = t_numberOfSegments;
+  m_numberOfSegments          = constrain(t_numberOfSegments, 0, MAX_NUMBER_OF_SEGMENTS);
+  m_segmentPinsList           = t_segments;
+  m_ocpReadings               = t_ocpStorage;
 
   for (int i = 0; i < m_numberOfSegments; i++)                    // Initialyze driving variables for each segment
   {
-    pinMode(t_segments[i], INPUT);                                // Keep WE (working Electrodes) in High-Z until driving is active 
-    m_refreshSegmentNeeded[i] = false;                            // Initialyze segment state
-    m_segmentPinsList[i]      = t_segments[i];                        
-    m_currentState[i]         = SEGMENT_STATE_UNDEFINED;              
-    m_nextState[i]            = SEGMENT_STATE_UNDEFINED;
-  }
+    m_hal.pinMode(t_segments[i], INPUT);                          // Keep WE (working Electrodes) in High-Z until driving is active 
+    m_ocpReadings[i]          = 0;
+  }                                                               // Segment states start UNDEFINED (all masks clear)
 
   m_minBleachOcpLSB           = 0;                                // Variable to store the most negative OCP for bleached segments
   m_bleachRequiredFlag        = false;					                  // Use this flag to indicate that bleaching is required
 	m_colorRequiredFlag         = false;					                  // Use this flag to indicate that coloring is required
   m_refresh_color_needed      = false;                            // Flag to enable refresh colored segments routine
   m_refresh_bleach_needed     = false;                            // Flag to enable refresh bleached segments routine
+
+  updateRefreshLimits();                                          // Thresholds for the default configuration
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Release the storage allocated by the three-argument constructor.
+ */
+/***************************************************************************/
+
+YNV_ECD::~YNV_ECD()
+{
+  if (m_ownsStorage) {
+    delete[] m_segmentPinsList;
+    delete[] m_ocpReadings;
+  }
 }
 
 
@@ -122,33 +241,155 @@ void YNV_ECD::updateSupplyVoltage(int t_supplyVoltage) {
 
 void YNV_ECD::executeDisplay()
 {
+  unsigned long    startMs = m_hal.millis();
+  ecdSegmentMask_t changes = pendingChanges();
+  ecdSegmentMask_t urgent  = changes & (m_prioritySegments | m_urgentChanges);
+
+  m_settleSpentMs = 0;
+
+  m_timeToVisible[SEGMENT_PRIORITY_NORMAL] = 0;
+  m_timeToVisible[SEGMENT_PRIORITY_HIGH]   = 0;
+  if (urgent) {
+    execute_priority();                                     // High-priority changes first, before the bulk update
+    if ((pendingChanges() & urgent) == 0) {
+      m_timeToVisible[SEGMENT_PRIORITY_HIGH] = m_hal.millis() - startMs;
+    }
+  }
   execute_bleach();                                         // Execute state transition to Bleach
   execute_color();                                          // Execute state transition to Color
+  if ((changes & ~urgent) != 0 && (pendingChanges() & changes & ~urgent) == 0) {
+    m_timeToVisible[SEGMENT_PRIORITY_NORMAL] = m_hal.millis() - startMs;
+  }
   check_refresh();                                          // Check if refresh is needed
   execute_refresh();                                        // Execute refresh if necessary
-  disableCounterElectrode();                                // Set CE to High-Z for bi-stability
+  if (m_watchActive) {
+    armRefreshWatch();                                      // Refresh watch: CE back to the check level
+  } else {
+    disableCounterElectrode();                              // Set CE to High-Z for bi-stability
+  }
+  setPhase(DRIVER_PHASE_IDLE);
+
+  ECD_STATS_ADD(executeCount, 1);
+  ECD_STATS_ADD(driveTimeMs, m_hal.millis() - startMs);
 }
 
 
 /***************************************************************************/
 /**
  * @brief Set the state of a segment before execution.
- * @param t_segment Segment index.
+ * @param t_segment Segment index (invalid indices are ignored).
  * @param t_state New state of the Segment (t_segment): SEGMENT_STATE_BLEACH (false) or SEGMENT_STATE_COLOR (true)
 */
 /***************************************************************************/
 
 void YNV_ECD::setSegmentState(int t_segment, bool t_state)
 {
-  if (m_currentState[t_segment] != t_state){                // Check if the state of the segment is diferent from previous state
-    m_nextState[t_segment] = t_state;                       // If positive, allow segment state change
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {   // Ignore invalid segment indices
+    return;
+  }
 
-    if(t_state){                                            // Segment to be changed to Color
-      m_colorRequiredFlag      = true;                      // Enable flag to indicate that a color change is required
-    }else{                                                  // Segment to be changed to Bleach
-      m_bleachRequiredFlag     = true;                      // Enable flag to indicate that a bleach change is required  
-    }
+  ecdSegmentMask_t bit = ECD_SEGMENT_BIT(t_segment);
+
+  m_urgentChanges &= ~bit;                                  // The priority of a change goes with the request
+  if(t_state){                                              // Always overwrite: a later request cancels a pending one
+    m_nextColor  |=  bit;
+    m_nextBleach &= ~bit;
+  }else{
+    m_nextBleach |=  bit;
+    m_nextColor  &= ~bit;
+  }
+  m_colorRequiredFlag  = (m_nextColor & ~m_currentColor) != 0;   // Recomputed: a reverted request leaves no change pending
+  m_bleachRequiredFlag = (m_nextBleach & ~m_currentBleach) != 0;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set the state of a segment with a priority for this change only.
+ * A SEGMENT_PRIORITY_HIGH change is applied by the latency-first phase of
+ * the next executeDisplay(), whatever the priority of the segment.
+ * @param t_segment  Segment index (invalid indices are ignored).
+ * @param t_state    SEGMENT_STATE_BLEACH (false) or SEGMENT_STATE_COLOR (true)
+ * @param t_priority ecdSegmentPriority_e of this change.
+ */
+/***************************************************************************/
+
+void YNV_ECD::setSegmentState(int t_segment, bool t_state, uint8_t t_priority)
+{
+  setSegmentState(t_segment, t_state);
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return;
+  }
+  ecdSegmentMask_t bit = ECD_SEGMENT_BIT(t_segment);
+  if (t_priority == SEGMENT_PRIORITY_HIGH && (pendingChanges() & bit)) {
+    m_urgentChanges |= bit;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set the priority of all later changes of a segment.
+ * @param t_segment  Segment index (invalid indices are ignored).
+ * @param t_priority ecdSegmentPriority_e (e.g. SEGMENT_PRIORITY_HIGH for an
+ *                   alarm icon or a minus sign).
+ */
+/***************************************************************************/
+
+void YNV_ECD::setSegmentPriority(int t_segment, uint8_t t_priority)
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return;
+  }
+  if (t_priority == SEGMENT_PRIORITY_HIGH) {
+    m_prioritySegments |=  ECD_SEGMENT_BIT(t_segment);
+  } else {
+    m_prioritySegments &= ~ECD_SEGMENT_BIT(t_segment);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Time-to-visible of one priority in the last executeDisplay().
+ * @param t_priority ecdSegmentPriority_e.
+ * @return (ms) From the start of executeDisplay() to the end of the pulse
+ *         that applied the last change of that priority; 0 if it changed
+ *         no segment of that priority (or was stopped before).
+ */
+/***************************************************************************/
+
+unsigned long YNV_ECD::getTimeToVisible(uint8_t t_priority) const
+{
+  if (t_priority > SEGMENT_PRIORITY_HIGH) {
+    return 0;
   }
+  return m_timeToVisible[t_priority];
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Get the current state of a segment (state applied by the last
+ * transition, not the pending one).
+ * @param t_segment Segment index.
+ * @return SEGMENT_STATE_BLEACH, SEGMENT_STATE_COLOR, or SEGMENT_STATE_UNDEFINED
+ *         before the first transition or for an invalid index.
+ */
+/***************************************************************************/
+
+int YNV_ECD::getSegmentState(int t_segment) const
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return SEGMENT_STATE_UNDEFINED;
+  }
+  if (m_currentColor & ECD_SEGMENT_BIT(t_segment)) {
+    return SEGMENT_STATE_COLOR;
+  }
+  if (m_currentBleach & ECD_SEGMENT_BIT(t_segment)) {
+    return SEGMENT_STATE_BLEACH;
+  }
+  return SEGMENT_STATE_UNDEFINED;
 }
 
 
@@ -198,8 +439,10 @@ void YNV_ECD::clearStopDriving() {m_stopDrivingFlag = false;}
 
 void YNV_ECD::enableCounterElectrode(float t_voltage) {
   
-  analogWrite(m_counterElectrodePin, int(ADC_DAC_MAX_LSB*(t_voltage/m_supplyVoltage)));
-  delay(50);
+  m_counterElectrodeLSB = int(ADC_DAC_MAX_LSB*(t_voltage/m_supplyVoltage));
+  m_hal.writeCounterElectrode(m_counterElectrodePin, m_counterElectrodeLSB);
+  m_hal.delay(50);
+  ECD_STATS_ADD(ceSettles, 1);
 }
 
 
@@ -212,10 +455,307 @@ void YNV_ECD::enableCounterElectrode(float t_voltage) {
 /***************************************************************************/
 void YNV_ECD::disableCounterElectrode() //Set counter electrode in High-Z.
 {
-  pinMode(m_counterElectrodePin, INPUT);
+  m_hal.releaseCounterElectrode(m_counterElectrodePin);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Drive all segments directly for a fixed time.
+ *
+ * Bypasses the segment state machine, OCP checks and refresh logic: all WE
+ * pins are forced to the same level with the CE at a fixed voltage, then
+ * everything is returned to High-Z. Segment states are not updated.
+ *
+ * @param t_state     WE level (true = HIGH, false = LOW).
+ * @param t_ceVoltage (V) CE voltage applied during the drive.
+ * @param t_driveTime (ms) Duration of the drive.
+ */
+/***************************************************************************/
+
+void YNV_ECD::directDriveAll(bool t_state, float t_ceVoltage, unsigned long t_driveTime) {
+
+  setPhase(DRIVER_PHASE_DIRECT_DRIVE);
+  enableCounterElectrode(t_ceVoltage);
+  m_hal.delay(10);                                          // Short settling time for CE and DAC
+
+  unsigned long pulseStart = m_hal.millis();
+  m_hal.drivePins(m_segmentPinsList, allSegments(), m_numberOfSegments, t_state); // Force all segments to the requested state
+  m_hal.waitUntil(pulseStart + t_driveTime);                // Hold state for requested time
+  if (t_state) {
+    ECD_STATS_ADD(colorPulses, 1);
+  } else {
+    ECD_STATS_ADD(bleachPulses, 1);
+  }
+  disableAllSegments();                                     // Return all segments to High-Z
+  markDriven(allSegments());
+  disableCounterElectrode();                                // Release CE to High-Z
+  m_watchActive    = false;                                 // Segment states no longer match the charge: no watch
+  m_refreshPending = 0;
+  m_segmentDue      = 0;                                    // Classes no longer match the charge
+  m_segmentMarginal = 0;
+  m_hal.delay(10);                                          // Small guard delay after disabling CE
+  setPhase(DRIVER_PHASE_IDLE);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Start the event-driven refresh (refresh watch).
+ *
+ * The CE is settled once at the check level (Vsupply/2) and held there
+ * between updates, with every WE in High-Z, so a segment OCP can be compared
+ * at any time without a CE settle. executeDisplay() keeps the CE at this
+ * level instead of releasing it until stopRefreshWatch().
+ */
+/***************************************************************************/
+
+void YNV_ECD::startRefreshWatch() {
+  m_watchActive  = true;
+  m_watchSegment = -1;
+  armRefreshWatch();
+  setPhase(DRIVER_PHASE_IDLE);
 }
 
 
+/***************************************************************************/
+/**
+ * @brief Stop the refresh watch and release the CE (polled refresh).
+ */
+/***************************************************************************/
+
+void YNV_ECD::stopRefreshWatch() {
+  m_watchActive    = false;
+  m_refreshPending = 0;
+  disableCounterElectrode();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief One step of the background scan of the refresh watch.
+ *
+ * The next colored or bleached segment (round robin) is converted once
+ * against its refresh band, the window that check_refresh() accepts without
+ * a refresh: above the Color low limit for a colored segment, below the
+ * Bleach high limit for a bleached one. A segment outside its band is added
+ * to the pending refresh and skipped by later steps.
+ *
+ * Call it at a low rate from the driving context (e.g. one segment per
+ * second from loop()); each step is a single ADC conversion.
+ *
+ * @return true if the segment left its band (refresh pending).
+ */
+/***************************************************************************/
+
+bool YNV_ECD::refreshWatchStep() {
+
+  ecdSegmentMask_t watched = (m_currentColor | m_currentBleach) & ~m_refreshPending;
+  int              value   = 0;
+  int              low, high;
+
+  if (!m_watchActive || watched == 0) {
+    return false;
+  }
+
+  do {                                                      // Next watched segment after the last one
+    m_watchSegment = (m_watchSegment + 1 < m_numberOfSegments) ? m_watchSegment + 1 : 0;
+  } while ((watched & ECD_SEGMENT_BIT(m_watchSegment)) == 0);
+
+  ecdSegmentMask_t bit = ECD_SEGMENT_BIT(m_watchSegment);
+
+  if (m_currentColor & bit) {                               // Colored: refresh below m_refreshColorLimitL
+    low  = (int)ceilf(m_refreshColorLimitL);
+    high = ADC_DAC_MAX_LSB;
+  } else {                                                  // Bleached: refresh above m_refreshBleachLimitH
+    low  = 0;
+    high = (int)floorf(m_refreshBleachLimitH);
+  }
+
+  bool outside = m_hal.compareAdc(m_segmentPinsList[m_watchSegment], low, high, value);
+  m_ocpReadings[m_watchSegment] = (uint16_t)value;
+  ECD_STATS_ADD(watchConversions, 1);
+
+  if (outside) {
+    m_refreshPending |= bit;
+    ECD_STATS_ADD(watchEvents, 1);
+  }
+  return outside;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Refresh after a refresh watch event.
+ *
+ * All segments are read again at the held check level (conversions only, no
+ * CE settle) and sorted as by check_refresh(): a refresh runs only if a
+ * segment is still out of its band, and takes along the segments past half
+ * of their band. The CE then returns to the check level.
+ */
+/***************************************************************************/
+
+void YNV_ECD::executePendingRefresh() {
+
+  if (!m_watchActive || m_refreshPending == 0 || m_stopDrivingFlag) {
+    return;
+  }
+
+#ifndef YNV_ECD_NO_STATS
+  unsigned long startMs = m_hal.millis();
+#endif
+
+  m_minBleachOcpLSB       = 1024;
+  m_refresh_color_needed  = false;
+  m_refresh_bleach_needed = false;
+  m_settleSpentMs         = 0;
+
+  setPhase(DRIVER_PHASE_CHECK);
+  measureOcp(m_currentColor | m_currentBleach);
+  correctCrosstalk(m_currentColor | m_currentBleach);
+  classifyRefresh();
+
+  if (m_refresh_color_needed || m_refresh_bleach_needed) {
+    execute_refresh();
+    armRefreshWatch();                                      // CE back to the check level after the refresh pulses
+  }
+  m_refreshPending = 0;                                     // Events not confirmed were noise
+  setPhase(DRIVER_PHASE_IDLE);
+
+  ECD_STATS_ADD(driveTimeMs, m_hal.millis() - startMs);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Learn the crosstalk gains of the segments (commissioning).
+ *
+ * Starting from all segments bleached, the segments are colored one
+ * independent set at a time (no two neighbours together), then bleached
+ * again. After each step, once the pulses settled, all segments are read at
+ * the check level: the change read on a bleached segment, whose own charge
+ * did not move, against the sum of the changes of its colored neighbours
+ * gives its gain (least squares over all sets).
+ *
+ * Ends with all segments bleached; needs setNeighbours() and
+ * setCrosstalkGains(). Call it after begin(), before showing content.
+ */
+/***************************************************************************/
+
+void YNV_ECD::learnCrosstalk() {
+
+  uint16_t         baseline[MAX_NUMBER_OF_SEGMENTS];      // Readings before the set is colored
+  float            weight[MAX_NUMBER_OF_SEGMENTS];        // Sum of the squared neighbour changes
+  ecdSegmentMask_t remaining = allSegments();
+
+  if (m_neighbours == nullptr || m_crosstalkGains == nullptr) {
+    return;
+  }
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    m_crosstalkGains[i] = 0.0f;                             // Numerator of the fit until the end
+    weight[i]           = 0.0f;
+  }
+  setAllSegmentsBleach();
+  execute_bleach();
+
+  while (remaining != 0 && !m_stopDrivingFlag) {
+
+    ecdSegmentMask_t set = 0, blocked = 0;
+
+    for (int i = 0; i < m_numberOfSegments; i++) {          // Greedy independent set of the remaining segments
+      ecdSegmentMask_t bit = ECD_SEGMENT_BIT(i);
+      if ((remaining & bit) && !(blocked & bit) && !(m_neighbours[i] & set)) {
+        set     |= bit;
+        blocked |= m_neighbours[i];
+      }
+    }
+    remaining &= ~set;
+
+    setPhase(DRIVER_PHASE_CHECK);
+    enableCounterElectrode(m_supplyVoltage / 2);
+    m_hal.delay(CROSSTALK_LEARN_SETTLE_TIME);
+    m_hal.scanAdc(m_segmentPinsList, allSegments(), m_numberOfSegments, baseline);
+
+    for (int i = 0; i < m_numberOfSegments; i++) {
+      if (set & ECD_SEGMENT_BIT(i)) {
+        setSegmentState(i, true);
+      }
+    }
+    execute_color();
+
+    setPhase(DRIVER_PHASE_CHECK);
+    enableCounterElectrode(m_supplyVoltage / 2);
+    m_hal.delay(CROSSTALK_LEARN_SETTLE_TIME);
+    m_hal.scanAdc(m_segmentPinsList, allSegments(), m_numberOfSegments, m_ocpReadings);
+
+    for (int i = 0; i < m_numberOfSegments; i++) {
+      ecdSegmentMask_t neighbours = m_neighbours[i] & set;
+      float            change     = 0.0f;
+
+      if ((set & ECD_SEGMENT_BIT(i)) || neighbours == 0) {
+        continue;
+      }
+      for (int j = 0; neighbours != 0; j++, neighbours >>= 1) {
+        if (neighbours & 1) {
+          change += (float)m_ocpReadings[j] - (float)baseline[j];
+        }
+      }
+      m_crosstalkGains[i] += ((float)m_ocpReadings[i] - (float)baseline[i]) * change;
+      weight[i]           += change * change;
+    }
+
+    for (int i = 0; i < m_numberOfSegments; i++) {
+      if (set & ECD_SEGMENT_BIT(i)) {
+        setSegmentState(i, false);
+      }
+    }
+    execute_bleach();
+  }
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    m_crosstalkGains[i] = (weight[i] > 0.0f && remaining == 0) ? m_crosstalkGains[i] / weight[i] : 0.0f;
+  }
+
+  if (m_watchActive) {
+    armRefreshWatch();
+  } else {
+    disableCounterElectrode();
+  }
+  setPhase(DRIVER_PHASE_IDLE);
+}
+
+
+#ifdef YNV_ECD_SIMULATOR
+/***************************************************************************/
+/**
+ * @brief Route all CE/WE I/O of this display to a simulated board.
+ *
+ * Registers every segment pin and the CE pin in the simulator. Pass nullptr
+ * to return to the Arduino core I/O functions.
+ *
+ * @param t_simulator Simulated board, or nullptr.
+ */
+/***************************************************************************/
+
+void YNV_ECD::attachSimulator(YNV_ECD_Simulator* t_simulator)
+{
+  m_hal.attach(t_simulator);
+
+  if (t_simulator == nullptr) {
+    return;
+  }
+
+  t_simulator->setCounterElectrodePin(m_counterElectrodePin);
+  t_simulator->setSupplyVoltage(m_supplyVoltage);
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    t_simulator->addSegment(m_segmentPinsList[i]);
+  }
+}
+#endif
+
+
 /***************************************************************************/
 /************************** END PUBLIC FUNCTIONS ***************************/
 /***************************************************************************/
@@ -227,10 +767,12 @@ void YNV_ECD::disableCounterElectrode() //Set counter electrode in High-Z.
 /***************************************************************************/
 /**
  * @brief Routine Block to change Segments state to Bleach
+ * @param t_select Segments the pulse may change (the pending changes
+ *                 outside it stay pending).
  */
 /***************************************************************************/
 
-void YNV_ECD::execute_bleach() {
+void YNV_ECD::execute_bleach(ecdSegmentMask_t t_select) {
 
   if(m_bleachRequiredFlag){
 
@@ -238,21 +780,28 @@ void YNV_ECD::execute_bleach() {
       return;
     } 
 
+    ecdSegmentMask_t drive = m_nextBleach & ~m_currentBleach & t_select; // Segments whose state is to change to bleach
+    if(drive == 0){                                           // Nothing to change in this selection: no CE settle, no pulse
+      return;
+    }
+
+    setPhase(DRIVER_PHASE_BLEACH);
     // Set Virtual ground voltage at CE to provide the Bleach Amplitude Voltage
     enableCounterElectrode(m_cfg.bleachingVoltage);             
 
-    for (int i = 0; i < m_numberOfSegments; i++) {    
-      // If the segment state is to change to bleach
-      if(m_nextState[i] != m_currentState[i] && m_nextState[i] == SEGMENT_STATE_BLEACH)
-      {
-        digitalWrite(m_segmentPinsList[i], LOW);              // Drive the segments to Bleach state
-        pinMode(m_segmentPinsList[i], OUTPUT);                 
-        m_currentState[i] = m_nextState[i];                   // Update current segment state (Bleached / Off) 
-      }
-    }
-    delay(m_cfg.bleachingTime);                               // Execute the defined pulse time for Bleach Transition
+    m_currentBleach |=  drive;                                // Update current segment state (Bleached / Off)
+    m_currentColor  &= ~drive;
+    m_segmentDue      &= ~drive;                              // New state: classified again by the next check
+    m_segmentMarginal &= ~drive;
+
+    unsigned long pulseStart = m_hal.millis();
+    m_hal.drivePins(m_segmentPinsList, drive, m_numberOfSegments, LOW); // Drive the segments to Bleach state
+    m_hal.waitUntil(pulseStart + m_cfg.bleachingTime);        // Execute the defined pulse time for Bleach Transition
+    ECD_STATS_ADD(bleachPulses, 1);
     disableAllSegments();                                     // Place all segments in High-Z
-    m_bleachRequiredFlag = false;                             // Disable Flag to change the state of segment to Bleach state
+    markDriven(drive);
+    m_urgentChanges &= ~drive;
+    m_bleachRequiredFlag = (m_nextBleach & ~m_currentBleach) != 0; // Clear the flag once no Bleach change is left
   }
 }
 
@@ -260,10 +809,12 @@ void YNV_ECD::execute_bleach() {
 /***************************************************************************/
 /**
  * @brief Routine Block to change Segments state to Color state
+ * @param t_select Segments the pulse may change (the pending changes
+ *                 outside it stay pending).
  */
 /***************************************************************************/
 
-void YNV_ECD::execute_color() {
+void YNV_ECD::execute_color(ecdSegmentMask_t t_select) {
 
   if(m_colorRequiredFlag){
 
@@ -271,25 +822,71 @@ void YNV_ECD::execute_color() {
       return;
     }  
 
+    ecdSegmentMask_t drive = m_nextColor & ~m_currentColor & t_select; // Segments whose state is to change to color
+    if(drive == 0){                                         // Nothing to change in this selection: no CE settle, no pulse
+      return;
+    }
+
+    setPhase(DRIVER_PHASE_COLOR);
     // Set Virtual ground voltage at CE to provide the Color Amplitude Voltage
     enableCounterElectrode(m_supplyVoltage - m_cfg.coloringVoltage);                                  
 
-    for (int i = 0; i < m_numberOfSegments; i++) {
-      // If the segment state is to change to color
-      if(m_nextState[i] != m_currentState[i] && m_nextState[i] == SEGMENT_STATE_COLOR)
-      {
-        digitalWrite(m_segmentPinsList[i], HIGH);           // Drive the segments to Color state
-        pinMode(m_segmentPinsList[i], OUTPUT);
-        m_currentState[i] = m_nextState[i];                 // Update current segment state (Colored / On)
-      }
-    }
-    delay(m_cfg.coloringTime);                              // Execute the defined pulse time for Color Transition
+    m_currentColor  |=  drive;                              // Update current segment state (Colored / On)
+    m_currentBleach &= ~drive;
+    m_segmentDue      &= ~drive;                            // New state: classified again by the next check
+    m_segmentMarginal &= ~drive;
+
+    unsigned long pulseStart = m_hal.millis();
+    m_hal.drivePins(m_segmentPinsList, drive, m_numberOfSegments, HIGH); // Drive the segments to Color state
+    m_hal.waitUntil(pulseStart + m_cfg.coloringTime);       // Execute the defined pulse time for Color Transition
+    ECD_STATS_ADD(colorPulses, 1);
     disableAllSegments();                                   // Place all segments in High-Z
-    m_colorRequiredFlag = false;                            // Disable Flag to change the state of segment to Color state
+    markDriven(drive);
+    m_urgentChanges &= ~drive;
+    m_colorRequiredFlag = (m_nextColor & ~m_currentColor) != 0; // Clear the flag once no Color change is left
   }
 }
 
 
+/***************************************************************************/
+/**
+ * @brief Latency-first phase: the pending high-priority changes get a Color
+ * pulse, then a Bleach pulse, of their own (a segment that appears carries
+ * the news, so Color goes first). Skipped polarities cost no CE settle.
+ */
+/***************************************************************************/
+
+void YNV_ECD::execute_priority() {
+
+  ecdSegmentMask_t urgent = m_prioritySegments | m_urgentChanges;
+  bool color  = (m_nextColor  & ~m_currentColor  & urgent) != 0;
+  bool bleach = (m_nextBleach & ~m_currentBleach & urgent) != 0;
+
+  if ((!color && !bleach) || m_stopDrivingFlag == true) {
+    return;
+  }
+
+  ECD_STATS_ADD(priorityPhases, 1);
+  if (color) {
+    execute_color(urgent);
+  }
+  if (bleach) {
+    execute_bleach(urgent);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Segments whose requested state is not applied yet.
+ */
+/***************************************************************************/
+
+ecdSegmentMask_t YNV_ECD::pendingChanges() const {
+  return (m_nextColor & ~m_currentColor) | (m_nextBleach & ~m_currentBleach);
+}
+
+
 /***************************************************************************/
 /**
  * @brief Meaure the OCP (Open Circuit Voltage) of the segments and verify 
@@ -302,55 +899,133 @@ void YNV_ECD::check_refresh() {
   m_minBleachOcpLSB     = 1024;
   m_refresh_color_needed  = false;
   m_refresh_bleach_needed = false;
-  int analog_val          = 0;
-  // Convert Bleach half amplitude (LSB) to absolute WE threshold (LSB) for check logic
-  int bleachHalfAbsLSB    = ((ADC_DAC_MAX_LSB / 2) - (int)m_refreshBleachHalf);
   
   if(m_stopDrivingFlag == true){                          // Verify if a driving interruption was requested
     return;
   }
 
+  setPhase(DRIVER_PHASE_CHECK);
   enableCounterElectrode(m_supplyVoltage / 2);            // Set CE for half voltage scale to measure color and bleach segments at same reference level
 
-  for (int i = 0; i < m_numberOfSegments; i++) {          // Measure the OCP off all active segments
+  measureOcp(allSegments());                              // Measure the OCP off all active segments
+  correctCrosstalk(allSegments());
+  classifyRefresh();                                      // Build the refresh list from the readings
+  disableAllSegments();   // Place all segments in High-Z
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Classify the segments from the OCP readings (taken at CE =
+ * Vsupply/2) and build the refresh list.
+ *
+ * Per segment, with a margin on the way into each class and hysteresis on
+ * the way out:
+ *  - due:      past its refresh limit by m_refreshEntryMargin, or due before
+ *              and not recovered by m_refreshHysteresis;
+ *  - marginal: past half of its band (by m_refreshEntryMargin unless listed
+ *              before), or marginal / due before and not recovered by
+ *              m_refreshHysteresis;
+ *  - OK:       otherwise.
+ * Due and marginal segments form the refresh list; a refresh round of one
+ * polarity runs only for a due segment of that polarity, once
+ * minRefreshInterval has passed since the previous round.
+ */
+/***************************************************************************/
+
+void YNV_ECD::classifyRefresh() {
+
+  int analog_val          = 0;
+  // Convert Bleach half amplitude (LSB) to absolute WE threshold (LSB) for check logic
+  int bleachHalfAbsLSB    = ((ADC_DAC_MAX_LSB / 2) - (int)m_refreshBleachHalf);
+  ecdSegmentMask_t due      = 0;
+  ecdSegmentMask_t marginal = 0;
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
   
-    analog_val = analogRead(m_segmentPinsList[i]);
+    ecdSegmentMask_t bit = ECD_SEGMENT_BIT(i);
+    bool wasDue          = (m_segmentDue & bit) != 0;
+    bool wasListed       = ((m_segmentDue | m_segmentMarginal) & bit) != 0;
+    float dueEntry       = wasDue    ? 0.0f : m_refreshEntryMargin;
+    float listEntry      = wasListed ? 0.0f : m_refreshEntryMargin;
+    analog_val = m_ocpReadings[i];
   
-    if (m_currentState[i] == SEGMENT_STATE_COLOR) {       // Check for Color Segments
+    if (m_currentColor & bit) {                           // Check for Color Segments
 
-      if (analog_val > m_refreshColorHalf) {              // No refresh required
-        m_refreshSegmentNeeded[i] = false;
+      if (analog_val < m_refreshColorLimitL - dueEntry) { // analog_val < m_refreshColorLimitL (- entry margin) -> Needs refresh
+        due |= bit;
       }
-      else if (analog_val >= m_refreshColorLimitL) {      // Place in the refesh List in case another segment needs refresh, this one will also be refreshed
-        m_refreshSegmentNeeded[i] = true;
+      else if (wasDue && analog_val < m_refreshColorLimitL + m_refreshHysteresis) {
+        due |= bit;                                       // Not recovered: stays due
+        ECD_STATS_ADD(hysteresisHolds, 1);
       }
-      else {                                              // analog_val <= m_refreshColorLimit -> Needs refresh
-        m_refreshSegmentNeeded[i] = true;
-        m_refresh_color_needed    = true;
-      }  
+      else if (analog_val <= m_refreshColorHalf - listEntry) { // Place in the refesh List in case another segment needs refresh, this one will also be refreshed
+        marginal |= bit;
+      }
+      else if (wasListed && analog_val <= m_refreshColorHalf + m_refreshHysteresis) {
+        marginal |= bit;                                  // Not recovered: stays marginal
+        ECD_STATS_ADD(hysteresisHolds, 1);
+      }
+      // analog_val > m_refreshColorHalf (+ hysteresis) -> No refresh required
     }
-    else if (m_currentState[i] == SEGMENT_STATE_BLEACH) { // Check for Bleached Segments
+    else if (m_currentBleach & bit) {                     // Check for Bleached Segments
 
       if(analog_val <  m_minBleachOcpLSB) {               // Stores lowest OCP value of bleached segments
         m_minBleachOcpLSB = analog_val;
       }
 
-      if (analog_val > m_refreshBleachLimitH) {           // Needs refresh (closest to CE, smallest amplitude)
-        m_refreshSegmentNeeded[i] = true;
-        m_refresh_bleach_needed   = true;
+      if (analog_val > m_refreshBleachLimitH + dueEntry) { // Needs refresh (closest to CE, smallest amplitude)
+        due |= bit;
+      }
+      else if (wasDue && analog_val > m_refreshBleachLimitH - m_refreshHysteresis) {
+        due |= bit;                                       // Not recovered: stays due
+        ECD_STATS_ADD(hysteresisHolds, 1);
       }
-      else if (analog_val >= bleachHalfAbsLSB) {          // Place in the refesh List in case another segment needs refresh, this one will also be refreshed
-        m_refreshSegmentNeeded[i] = true;
+      else if (analog_val >= bleachHalfAbsLSB + listEntry) { // Place in the refesh List in case another segment needs refresh, this one will also be refreshed
+        marginal |= bit;
       }
-      else {                                              // analog_val <= bleachHalfAbsLSB -> No refresh required
-        m_refreshSegmentNeeded[i] = false;
-      }    
+      else if (wasListed && analog_val >= bleachHalfAbsLSB - m_refreshHysteresis) {
+        marginal |= bit;                                  // Not recovered: stays marginal
+        ECD_STATS_ADD(hysteresisHolds, 1);
+      }
+      // analog_val < bleachHalfAbsLSB (- hysteresis) -> No refresh required
     }
-    else {                                                // UNDEFINED OR OTHER STATE
-      m_refreshSegmentNeeded[i] = false;
+  }
+
+  m_segmentDue      = due;
+  m_segmentMarginal = marginal;
+  m_refreshNeeded   = due | marginal;                     // UNDEFINED segments are never refreshed
+
+  unsigned long nowMs = m_hal.millis();
+
+  if (due & m_currentColor) {
+    m_refresh_color_needed = refreshRoundAllowed(true, nowMs);
+    if (!m_refresh_color_needed) {
+      ECD_STATS_ADD(deferredRefreshes, 1);
     }
   }
-  disableAllSegments();   // Place all segments in High-Z
+  if (due & m_currentBleach) {
+    m_refresh_bleach_needed = refreshRoundAllowed(false, nowMs);
+    if (!m_refresh_bleach_needed) {
+      ECD_STATS_ADD(deferredRefreshes, 1);
+    }
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief True if a refresh round of this polarity may start:
+ * minRefreshInterval has passed since the end of the previous one.
+ */
+/***************************************************************************/
+
+bool YNV_ECD::refreshRoundAllowed(bool t_colorRound, unsigned long t_nowMs) const {
+
+  if (t_colorRound) {
+    return !m_colorRoundDone || (t_nowMs - m_lastColorRoundMs) >= m_cfg.minRefreshInterval;
+  }
+  return !m_bleachRoundDone || (t_nowMs - m_lastBleachRoundMs) >= m_cfg.minRefreshInterval;
 }
 
 
@@ -362,6 +1037,10 @@ void YNV_ECD::check_refresh() {
 
 void YNV_ECD::execute_refresh() {
   
+  if (m_refresh_color_needed || m_refresh_bleach_needed) {
+    ECD_STATS_ADD(refreshTriggers, 1);
+  }
+
   if (m_refresh_color_needed) {     // Handle COLOR refresh if required
     refreshColor();
   }
@@ -377,7 +1056,7 @@ void YNV_ECD::execute_refresh() {
  * @brief Executes the BLEACH refresh routine.
  *
  * Drives CE to a safe refresh voltage based on m_minBleachOcpLSB and
- * applies low pulses to bleached segments marked in m_refreshSegmentNeeded[].
+ * applies low pulses to bleached segments marked in m_refreshNeeded.
  * After each pulse, segments are re-checked against m_refreshBleachLimitL
  * until the target is reached or MAX_REFRESH_RETRIES is exceeded.
  */
@@ -385,7 +1064,6 @@ void YNV_ECD::execute_refresh() {
 
 void YNV_ECD::refreshBleach() {       
   
-  int   analog_val      = 0;
   int   retries         = 0;
   float counterElecVal  = 0;
 
@@ -406,6 +1084,12 @@ void YNV_ECD::refreshBleach() {
     counterElecVal = m_cfg.refreshBleachingVoltage;
   }
 
+  ecdSegmentMask_t round = m_currentBleach & m_refreshNeeded; // Due segments + marginal ones taken along
+
+  ECD_STATS_ADD(refreshRounds, 1);
+  ECD_STATS_ADD(marginalJoins, countSegments(round & m_segmentMarginal));
+
+  setPhase(DRIVER_PHASE_REFRESH_BLEACH);
   enableCounterElectrode(counterElecVal);
 
   while (m_refresh_bleach_needed && (retries < MAX_REFRESH_RETRIES)) {
@@ -414,35 +1098,44 @@ void YNV_ECD::refreshBleach() {
       return;
     }
       
-    for (int i = 0; i < m_numberOfSegments; i++) {        // Refresh the necessary segments
+    ecdSegmentMask_t refreshList = m_currentBleach & m_refreshNeeded; // Refresh the necessary segments
 
-      if (m_currentState[i] == SEGMENT_STATE_BLEACH && m_refreshSegmentNeeded[i] == true) {
-        digitalWrite(m_segmentPinsList[i], LOW);
-        pinMode(m_segmentPinsList[i], OUTPUT);
-      }      
-    }
-
-    delay(m_cfg.refreshBleachPulseTime);
+    unsigned long pulseStart = m_hal.millis();
+    m_hal.drivePins(m_segmentPinsList, refreshList, m_numberOfSegments, LOW);
+    m_hal.waitUntil(pulseStart + m_cfg.refreshBleachPulseTime);
+    ECD_STATS_ADD(bleachPulses, 1);
     disableAllSegments();
+    markDriven(refreshList);
     m_refresh_bleach_needed = false;
     
-    for (int i = 0; i < m_numberOfSegments; i++) {        // check if segments still need refresh 
+    m_hal.scanAdc(m_segmentPinsList, refreshList, m_numberOfSegments, m_ocpReadings); // Re-check at once: only the check sweeps settle
+
+    for (int i = 0; refreshList != 0; i++, refreshList >>= 1) { // check if segments still need refresh 
 
-      if (m_currentState[i] == SEGMENT_STATE_BLEACH && m_refreshSegmentNeeded[i] == true) {
-        
-        analog_val = analogRead(m_segmentPinsList[i]);
+      if (refreshList & 1) {
 
-        if (analog_val > m_refreshBleachLimitL) {
+        if (m_ocpReadings[i] > m_refreshBleachLimitL) {
           m_refresh_bleach_needed   = true;
         } 
         else {
-          m_refreshSegmentNeeded[i] = false;              // Segment reached target OCP, no more refresh required
+          m_refreshNeeded &= ~ECD_SEGMENT_BIT(i);         // Segment reached target OCP, no more refresh required
         }
       }
     }
 
     retries++;
+    ECD_STATS_ADD(refreshRetries, 1);
   }
+
+  if (m_refresh_bleach_needed) {                          // MAX_REFRESH_RETRIES reached before the target
+    ECD_STATS_ADD(refreshFailures, 1);
+  }
+
+  round             &= ~m_refreshNeeded;                  // Segments that reached the target are OK again
+  m_segmentDue      &= ~round;
+  m_segmentMarginal &= ~round;
+  m_lastBleachRoundMs = m_hal.millis();
+  m_bleachRoundDone   = true;
 }
 
 
@@ -451,14 +1144,13 @@ void YNV_ECD::refreshBleach() {
  * @brief Executes the COLOR refresh routine.
  *
  * Drives CE to the configured refresh coloring voltage and applies high
- * pulses to colored segments marked in m_refreshSegmentNeeded[]. After each
+ * pulses to colored segments marked in m_refreshNeeded. After each
  * pulse, segments are re-checked against m_refreshColorLimitH until the
  * target is reached or MAX_REFRESH_RETRIES is exceeded.
  */
 /***************************************************************************/
 void YNV_ECD::refreshColor()
 {
-  int   analog_val     = 0;
   int   retries        = 0;
   float counterElecVal = 0.0f;
 
@@ -468,6 +1160,12 @@ void YNV_ECD::refreshColor()
 
   counterElecVal = (m_supplyVoltage - m_cfg.refreshColoringVoltage); // CE value for Color refresh:
 
+  ecdSegmentMask_t round = m_currentColor & m_refreshNeeded; // Due segments + marginal ones taken along
+
+  ECD_STATS_ADD(refreshRounds, 1);
+  ECD_STATS_ADD(marginalJoins, countSegments(round & m_segmentMarginal));
+
+  setPhase(DRIVER_PHASE_REFRESH_COLOR);
   enableCounterElectrode(counterElecVal);
 
   while (m_refresh_color_needed && (retries < MAX_REFRESH_RETRIES)) {
@@ -477,39 +1175,49 @@ void YNV_ECD::refreshColor()
     }
 
     // Apply refresh pulse to all colored segments that still need refresh
-    for (int i = 0; i < m_numberOfSegments; i++) {
-      if ((m_currentState[i] == SEGMENT_STATE_COLOR) && (m_refreshSegmentNeeded[i] == true)) {
-        digitalWrite(m_segmentPinsList[i], HIGH);
-        pinMode(m_segmentPinsList[i], OUTPUT);
-      }
-    }
+    ecdSegmentMask_t refreshList = m_currentColor & m_refreshNeeded;
 
-    delay(m_cfg.refreshColorPulseTime);
+    unsigned long pulseStart = m_hal.millis();
+    m_hal.drivePins(m_segmentPinsList, refreshList, m_numberOfSegments, HIGH);
+    m_hal.waitUntil(pulseStart + m_cfg.refreshColorPulseTime);
+    ECD_STATS_ADD(colorPulses, 1);
+    disableAllSegments();
+    markDriven(refreshList);
 
     if (m_stopDrivingFlag) {                              // Verify if a driving interruption was requested
       return;
     }
 
-    disableAllSegments();
     m_refresh_color_needed = false;
 
-    // Check which segments still need color refresh
-    for (int i = 0; i < m_numberOfSegments; i++) {
+    // Check which segments still need color refresh (at once: only the check sweeps settle)
+    m_hal.scanAdc(m_segmentPinsList, refreshList, m_numberOfSegments, m_ocpReadings);
+
+    for (int i = 0; refreshList != 0; i++, refreshList >>= 1) {
 
-      if (m_currentState[i] == SEGMENT_STATE_COLOR && m_refreshSegmentNeeded[i] == true) {
-        analog_val = analogRead(m_segmentPinsList[i]);
+      if (refreshList & 1) {
 
-        if (analog_val < m_refreshColorLimitH) {          // Segment OCP is still below target → needs more refresh
-          m_refreshSegmentNeeded[i] = true;
+        if (m_ocpReadings[i] < m_refreshColorLimitH) {    // Segment OCP is still below target → needs more refresh
           m_refresh_color_needed    = true;
         } 
         else {
-          m_refreshSegmentNeeded[i] = false;              // Segment reached target OCP → remove from refresh list
+          m_refreshNeeded &= ~ECD_SEGMENT_BIT(i);         // Segment reached target OCP → remove from refresh list
         }
       }
     }
     retries++;
+    ECD_STATS_ADD(refreshRetries, 1);
+  }
+
+  if (m_refresh_color_needed) {                           // MAX_REFRESH_RETRIES reached before the target
+    ECD_STATS_ADD(refreshFailures, 1);
   }
+
+  round             &= ~m_refreshNeeded;                  // Segments that reached the target are OK again
+  m_segmentDue      &= ~round;
+  m_segmentMarginal &= ~round;
+  m_lastColorRoundMs = m_hal.millis();
+  m_colorRoundDone   = true;
 }
 
 
@@ -529,6 +1237,8 @@ void YNV_ECD::updateRefreshLimits(void) {
 
   m_refreshBleachLimitH = (m_supplyVoltage/2 - m_cfg.refreshBleachLimitHVoltage) * (ADC_DAC_MAX_LSB / m_supplyVoltage);
   m_refreshBleachLimitL = (m_cfg.refreshBleachingVoltage - m_cfg.refreshBleachLimitLVoltage) * (ADC_DAC_MAX_LSB / m_supplyVoltage);
+  m_refreshHysteresis   = m_cfg.refreshHysteresisVoltage * (ADC_DAC_MAX_LSB / m_supplyVoltage);
+  m_refreshEntryMargin  = m_cfg.refreshEntryMarginVoltage * (ADC_DAC_MAX_LSB / m_supplyVoltage);
 
   // Compute CE levels in LSB
   int CE_check_lsb   = (ADC_DAC_MAX_LSB / 2);  // CE = Vsupply / 2
@@ -554,10 +1264,159 @@ void YNV_ECD::updateRefreshLimits(void) {
 
 void YNV_ECD::disableAllSegments() { 
   
-  for (int i = 0; i < m_numberOfSegments; i++)
-  {
-    pinMode(m_segmentPinsList[i], INPUT);       // Set all work electrodes to High-Z mode.
+  m_hal.releasePins(m_segmentPinsList, m_numberOfSegments);   // Set all work electrodes to High-Z mode.
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Mask of all the segments of the display.
+ */
+/***************************************************************************/
+
+ecdSegmentMask_t YNV_ECD::allSegments() const {
+  if (m_numberOfSegments == 0) {
+    return 0;
   }
+  return (ecdSegmentMask_t)~(ecdSegmentMask_t)0 >> (8 * sizeof(ecdSegmentMask_t) - m_numberOfSegments);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Settle the CE at the check level for the refresh watch and clear
+ * the pending events (the segments were just checked or refreshed).
+ */
+/***************************************************************************/
+
+void YNV_ECD::armRefreshWatch(void) {
+  enableCounterElectrode(m_supplyVoltage / 2);
+  m_refreshPending = 0;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief A pulse on t_driven just ended (WE pins High-Z): these segments and
+ * their neighbours are disturbed until ECD_Config::ocpSettleTime has passed.
+ */
+/***************************************************************************/
+
+void YNV_ECD::markDriven(ecdSegmentMask_t t_driven) {
+  m_recentlyDriven |= t_driven;
+  m_settledMs       = m_hal.millis() + m_cfg.ocpSettleTime;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Read the OCP of the selected segments into m_ocpReadings.
+ *
+ * Without adjacency map and settle time, one sweep in pin order. Otherwise
+ * the segments undisturbed by the last pulses are read first, at once; the
+ * wait for the settle deadline runs only before the disturbed ones, which
+ * are read last: the neighbours of the pulsed segments, then the pulsed
+ * segments themselves. Used by the OCP check sweeps only; the re-checks
+ * between refresh pulses read at once.
+ */
+/***************************************************************************/
+
+void YNV_ECD::measureOcp(ecdSegmentMask_t t_select) {
+
+  if (m_neighbours == nullptr && m_cfg.ocpSettleTime <= 0) {
+    m_hal.scanAdc(m_segmentPinsList, t_select, m_numberOfSegments, m_ocpReadings);
+    m_recentlyDriven = 0;
+    return;
+  }
+
+  ecdSegmentMask_t driven    = m_recentlyDriven & t_select;
+  ecdSegmentMask_t disturbed = m_recentlyDriven;
+
+  if (m_neighbours != nullptr) {
+    ecdSegmentMask_t pulsed = m_recentlyDriven;
+    for (int i = 0; pulsed != 0; i++, pulsed >>= 1) {
+      if (pulsed & 1) {
+        disturbed |= m_neighbours[i];
+      }
+    }
+  }
+  disturbed &= t_select;
+
+  m_hal.scanAdc(m_segmentPinsList, t_select & ~disturbed, m_numberOfSegments, m_ocpReadings);
+  if (disturbed != 0) {
+    unsigned long deadline = m_settledMs;
+    if (m_cfg.ocpSettleBudget > 0) {                        // Wait only what is left of the update budget
+      long wait = max(0L, (long)(m_settledMs - m_hal.millis()));
+      wait            = min(wait, (long)(m_cfg.ocpSettleBudget - m_settleSpentMs));
+      m_settleSpentMs += (int)wait;
+      deadline        = m_hal.millis() + wait;
+    }
+    m_hal.waitUntil(deadline);
+    m_hal.scanAdc(m_segmentPinsList, disturbed & ~driven, m_numberOfSegments, m_ocpReadings);
+    m_hal.scanAdc(m_segmentPinsList, driven, m_numberOfSegments, m_ocpReadings);
+  }
+  if ((long)(m_hal.millis() - m_settledMs) >= 0) {
+    m_recentlyDriven = 0;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Remove the learned crosstalk from the selected readings.
+ *
+ * Each reading loses its gain times the sum of the potentials (relative to
+ * the CE) of its neighbours read in the same sweep. Used on the check
+ * sweeps, where every segment is read at the same CE level.
+ */
+/***************************************************************************/
+
+void YNV_ECD::correctCrosstalk(ecdSegmentMask_t t_select) {
+
+  int correction[MAX_NUMBER_OF_SEGMENTS];                   // From the uncorrected readings
+
+  if (m_neighbours == nullptr || m_crosstalkGains == nullptr) {
+    return;
+  }
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    ecdSegmentMask_t neighbours = m_neighbours[i] & t_select;
+    long             sum        = 0;
+
+    correction[i] = 0;
+    if (!(t_select & ECD_SEGMENT_BIT(i)) || m_crosstalkGains[i] == 0.0f) {
+      continue;
+    }
+    for (int j = 0; neighbours != 0; j++, neighbours >>= 1) {
+      if (neighbours & 1) {
+        sum += (long)m_ocpReadings[j] - m_counterElectrodeLSB;
+      }
+    }
+    float value   = m_crosstalkGains[i] * sum;
+    correction[i] = (int)(value + ((value >= 0.0f) ? 0.5f : -0.5f));
+  }
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    if (correction[i] != 0) {
+      m_ocpReadings[i] = (uint16_t)constrain((int)m_ocpReadings[i] - correction[i], 0, ADC_DAC_MAX_LSB);
+    }
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Enter a driving phase (getPhase(), simulator traces).
+ */
+/***************************************************************************/
+
+void YNV_ECD::setPhase(ecdDriverPhase_e t_phase) {
+#ifndef YNV_ECD_NO_PHASE
+  m_phase = t_phase;
+#else
+  (void)t_phase;
+#endif
+  m_hal.setPhase(t_phase);
 }
 
 
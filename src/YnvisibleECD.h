@@ -28,13 +28,28 @@
 #define _YNVISIBLE_ECD
 
 #include "Arduino.h"
+#include "YnvisibleECDHal.h"
 
+#ifdef YNV_ECD_SIMULATOR
+class YNV_ECD_Simulator;
+#endif
 
 // ---------------------------------------------------------------------------
 // Static Configuration Macros
 // ---------------------------------------------------------------------------
 
-#define MAX_NUMBER_OF_SEGMENTS              15            // Max number of segment pins supported by the driver
+// Optional build flags (-D compiler options):
+//  YNV_ECD_SIMULATOR   Host builds: engine I/O can be routed to a YNV_ECD_Simulator
+//  YNV_ECD_NOOP_HAL    Host micro-benchmarks: engine I/O does nothing
+//  YNV_ECD_HAL_DRIVER_V5  Driver v5 HAL: WE groups switched through PORT registers (SAMD)
+//  YNV_ECD_HAL_EXPANDER   WE pins on GPIO expanders (ECD_EXPANDER_PIN(), YnvisibleECDExpander.h)
+//  YNV_ECD_NO_STATS    ECD_Stats counters compiled out (getStats() returns zeros)
+//  YNV_ECD_NO_PHASE    Phase tracking compiled out (getPhase() returns DRIVER_PHASE_IDLE)
+//  MAX_NUMBER_OF_SEGMENTS=n  Segment limit per display (default 64; up to 32 uses 32-bit segment masks)
+
+#ifndef MAX_NUMBER_OF_SEGMENTS
+#define MAX_NUMBER_OF_SEGMENTS              64            // Max number of segment pins supported by the driver
+#endif
 #define MAX_REFRESH_RETRIES                 30            // Max number of refresh attempts before refresh is considered failed
 
 #define SUPPLY_VOLTAGE                      3.0           // (V) MCU supply voltage used for DAC/ADC scaling
@@ -58,6 +73,36 @@
 #define BLEACHING_TIME                      350           // (ms) Duration of Bleach transition pulse
 #define REFRESH_BLEACH_PULSE_TIME           10            // (ms) Duration of Bleach refresh pulse
 
+#define REFRESH_HYSTERESIS_VOLTAGE          0.0           // (V) Margin a segment must recover before leaving the due / marginal class
+#define REFRESH_ENTRY_MARGIN_VOLTAGE        0.0           // (V) Margin a segment must pass its threshold by before entering the due / marginal class
+#define MIN_REFRESH_INTERVAL                0             // (ms) Minimum time between refresh rounds of one polarity (0 = none)
+
+#define OCP_SETTLE_TIME                     0             // (ms) Wait after a pulse before reading the segments it disturbs (0 = read at once)
+#define OCP_SETTLE_BUDGET                   0             // (ms) Total settle wait allowed in one update (0 = no limit)
+#define CROSSTALK_LEARN_SETTLE_TIME         500           // (ms) Wait after each learnCrosstalk() step, so only the static coupling remains
+
+
+#if MAX_NUMBER_OF_SEGMENTS > 64
+#error "MAX_NUMBER_OF_SEGMENTS is limited to 64 (one bit per segment in ecdSegmentMask_t)"
+#elif MAX_NUMBER_OF_SEGMENTS > 32
+typedef uint64_t ecdSegmentMask_t;                        // Segment set: bit i = segment i
+#else
+typedef uint32_t ecdSegmentMask_t;                        // Segment set: bit i = segment i
+#endif
+
+// Flags written from another context than the one driving (ISR, RTOS task,
+// ECD_CommandQueue producer): std::atomic on the host, where producers are
+// threads; a volatile byte on the MCU, where a byte store is atomic.
+#if defined(YNV_ECD_SIMULATOR) || defined(YNV_ECD_NOOP_HAL)
+#define YNV_ECD_HOST_THREADS                              // Host build: std::thread / std::atomic available
+#include <atomic>
+typedef std::atomic<bool>    ecdFlag_t;
+typedef std::atomic<uint8_t> ecdPhase_t;
+#else
+typedef volatile bool        ecdFlag_t;
+typedef volatile uint8_t     ecdPhase_t;
+#endif
+
 
 // ---------------------------------------------------------------------------
 // Enums & Configuration Structures
@@ -72,6 +117,27 @@ enum ecdSegmentState_e {
     SEGMENT_STATE_COLOR     = 1     // Colored (ON)
 };
 
+/**
+ * @brief Segment priorities (setSegmentPriority(), getTimeToVisible()).
+ */
+enum ecdSegmentPriority_e {
+    SEGMENT_PRIORITY_NORMAL = 0,    // Bulk update: bleach phase, then color phase
+    SEGMENT_PRIORITY_HIGH   = 1     // Driven first, in a phase of their own
+};
+
+/**
+ * @brief Phase of the driving engine, reported for tracing and debugging.
+ */
+enum ecdDriverPhase_e {
+    DRIVER_PHASE_IDLE           = 0,    // Not driving (CE High-Z)
+    DRIVER_PHASE_BLEACH         = 1,    // Bleach transition pulse
+    DRIVER_PHASE_COLOR          = 2,    // Color transition pulse
+    DRIVER_PHASE_CHECK          = 3,    // OCP measurement (check_refresh)
+    DRIVER_PHASE_REFRESH_BLEACH = 4,    // Bleach refresh pulses + re-checks
+    DRIVER_PHASE_REFRESH_COLOR  = 5,    // Color refresh pulses + re-checks
+    DRIVER_PHASE_DIRECT_DRIVE   = 6     // directDriveAll()
+};
+
 /**
  * @brief Configuration structure for all ECD driving parameters.
  *
@@ -95,6 +161,40 @@ struct ECD_Config {
     float refreshBleachingVoltage           { REFRESH_BLEACHING_VOLTAGE };      // (V) Refresh Bleach amplitude
     int   bleachingTime                     { BLEACHING_TIME };                 // (ms) Bleach pulse duration
     int   refreshBleachPulseTime            { REFRESH_BLEACH_PULSE_TIME };      // (ms) Refresh Bleach pulse duration
+
+    float refreshHysteresisVoltage          { REFRESH_HYSTERESIS_VOLTAGE };     // (V) Recovery needed to leave the due / marginal class
+    float refreshEntryMarginVoltage         { REFRESH_ENTRY_MARGIN_VOLTAGE };   // (V) Overshoot needed to enter the due / marginal class
+    unsigned long minRefreshInterval        { MIN_REFRESH_INTERVAL };           // (ms) Minimum time between Color (or Bleach) refresh rounds
+
+    int   ocpSettleTime                     { OCP_SETTLE_TIME };                // (ms) Pulse end to the first read of a disturbed segment
+    int   ocpSettleBudget                   { OCP_SETTLE_BUDGET };              // (ms) Check sweep settle waits allowed per executeDisplay() / executePendingRefresh()
+};
+
+/**
+ * @brief Driving statistics accumulated by a YNV_ECD object.
+ *
+ * Counters are cumulative since construction or the last resetStats() call.
+ * Used to compare update latency and drive effort between configurations.
+ */
+struct ECD_Stats {
+
+    unsigned long executeCount              { 0 };                              // Number of executeDisplay() calls
+    unsigned long driveTimeMs               { 0 };                              // (ms) Time spent inside executeDisplay()
+    unsigned long ceSettles                 { 0 };                              // CE enable + settle cycles
+    unsigned long colorPulses               { 0 };                              // COLOR pulses (transition + refresh)
+    unsigned long bleachPulses              { 0 };                              // BLEACH pulses (transition + refresh)
+    unsigned long refreshRetries            { 0 };                              // Refresh pulse + re-check iterations
+    unsigned long refreshFailures           { 0 };                              // Refresh rounds ended by MAX_REFRESH_RETRIES
+    unsigned long priorityPhases            { 0 };                              // Updates that drove high-priority segments first
+    unsigned long refreshTriggers           { 0 };                              // OCP checks that started a refresh
+    unsigned long refreshRounds             { 0 };                              // Color and Bleach refresh rounds (refreshColor() / refreshBleach())
+    unsigned long marginalJoins             { 0 };                              // Marginal segments refreshed along with a due one
+    unsigned long hysteresisHolds           { 0 };                              // Classifications kept by the hysteresis (plain thresholds would release)
+    unsigned long deferredRefreshes         { 0 };                              // Refresh rounds held back by minRefreshInterval
+    unsigned long watchConversions          { 0 };                              // Refresh watch window compares (refreshWatchStep())
+    unsigned long watchEvents               { 0 };                              // Refresh watch compares outside the band
+
+    ECD_Stats& operator+=(const ECD_Stats& t_other);                            ///< Add every counter of t_other (e.g. totals over several displays)
 };
 
 
@@ -109,52 +209,192 @@ struct ECD_Config {
  * Provides the public API for setting segment states, executing transitions,
  * updating supply voltage, performing OCP checks, and running adaptive refresh
  * routines. Low-level ADC, DAC, and GPIO operations are managed internally.
+ *
+ * Refresh is polled by default: every executeDisplay() settles the CE at the
+ * check level and sweeps all OCPs. With startRefreshWatch() the CE stays at
+ * the check level between updates (WE pins High-Z) and refreshWatchStep()
+ * compares one segment at a time with its refresh band; only segments that
+ * left their band are refreshed, by executePendingRefresh().
+ *
+ * OCP readings taken right after a pulse pick up the double-layer relaxation
+ * of the pulsed segments and, through the panel, of their neighbours. With an
+ * adjacency map (setNeighbours()) the undisturbed segments are read first and
+ * ECD_Config::ocpSettleTime is waited only before the pulsed segments and
+ * their neighbours. The static coupling left can be learned once
+ * (learnCrosstalk()) and removed from the OCP checks.
+ *
+ * Each colored or bleached segment is classified by the OCP checks as OK,
+ * marginal (past half of its band) or due (past its refresh limit). A due
+ * segment starts a refresh round of its polarity, which takes the marginal
+ * segments of the same polarity along. With ECD_Config::refreshEntryMarginVoltage
+ * a segment enters the due or marginal class only once past its threshold by
+ * that margin, and with ECD_Config::refreshHysteresisVoltage it leaves the
+ * class only after recovering that margin, so readings near a threshold do
+ * not flip it in and out of the rounds; ECD_Config::minRefreshInterval
+ * spaces the rounds of one polarity.
+ *
+ * High-priority segments (setSegmentPriority(), or one change staged with
+ * SEGMENT_PRIORITY_HIGH) do not wait behind the bulk update: executeDisplay()
+ * first colors, then bleaches the changed high-priority segments, and only
+ * then runs the bleach and color phases of the others and the refresh work.
+ * getTimeToVisible() reports, per priority, when the last update had shown
+ * its segments.
+ *
+ * Segment states are kept as bit masks (ecdSegmentMask_t). The per-segment
+ * arrays are sized for the display: with caller storage (or YNV_ECD_Sized<n>)
+ * the pin list is referenced, not copied, and the OCP readings use a
+ * caller-provided array; the three-argument constructor allocates both once.
  */
 class YNV_ECD {
 public:
-    YNV_ECD(int t_numberOfSegments, int* t_segments); ///< Constructor (segment count + pin list)
+    YNV_ECD(int t_numberOfSegments, int* t_segments, int t_counterElectrodePin = PIN_CE); ///< Constructor (segment count + pin list + CE pin), storage allocated
+    YNV_ECD(int t_numberOfSegments, const int* t_segments, int t_counterElectrodePin, uint16_t* t_ocpStorage); ///< Constructor with caller storage (pin list kept, t_numberOfSegments OCP readings)
+    ~YNV_ECD();
+    YNV_ECD(const YNV_ECD&) = delete;
+    YNV_ECD& operator=(const YNV_ECD&) = delete;
 
     void begin();                                     ///< Initialize display (color all, then bleach all)
     void setConfig(const ECD_Config& t_cfg) { m_cfg = t_cfg; updateRefreshLimits(); } ///< Apply new configuration
     void updateSupplyVoltage(int t_supplyVoltage);    ///< Update supply and recalc thresholds
     void executeDisplay();                            ///< Apply pending state changes + refresh
     void setSegmentState(int t_segment, bool t_state);///< Schedule a segment to be colored/bleached
+    void setSegmentState(int t_segment, bool t_state, uint8_t t_priority); ///< Schedule a change with an ecdSegmentPriority_e for this change only
+    void setSegmentPriority(int t_segment, uint8_t t_priority); ///< ecdSegmentPriority_e of all changes of a segment
+    unsigned long getTimeToVisible(uint8_t t_priority) const; ///< (ms) Last executeDisplay(): start to end of the pulse showing its t_priority segments (0 = none changed)
     void setAllSegmentsBleach();                      ///< Convenience: set all segments to BLEACH
     void setStopDrivingFlag();                        ///< Interrupt driving loops safely
     void clearStopDriving();                          ///< Clear driving interruption flag
     void enableCounterElectrode(float t_voltage);     ///< Drive CE via DAC to given voltage
     void disableCounterElectrode();                   ///< Set CE to High-Z
+    void directDriveAll(bool t_state, float t_ceVoltage, unsigned long t_driveTime); ///< Drive all WE pins, bypassing state/refresh logic (ends a refresh watch)
+    void startRefreshWatch();                         ///< Event-driven refresh: hold the CE at the check level between updates
+    void stopRefreshWatch();                          ///< Back to polled refresh: release the CE
+    bool refreshWatchStep();                          ///< Background scan: compare the next segment with its band, true if it left it
+    void executePendingRefresh();                     ///< Refresh only the segments that left their band
+    bool isRefreshWatchActive() const { return m_watchActive; }     ///< Refresh watch running
+    ecdSegmentMask_t getPendingRefresh() const { return m_refreshPending; } ///< Segments that left their band, not yet refreshed
+    void setNeighbours(const ecdSegmentMask_t* t_neighbours) { m_neighbours = t_neighbours; } ///< Adjacency map: bit j of t_neighbours[i] = segment j next to segment i (kept, nullptr = none)
+    void setCrosstalkGains(float* t_gains) { m_crosstalkGains = t_gains; } ///< Crosstalk gain of each segment (kept, nullptr = no correction)
+    void learnCrosstalk();                            ///< Learn the crosstalk gains (ends with all segments bleached)
+#ifndef YNV_ECD_NO_STATS
+    const ECD_Stats& getStats() const { return m_stats; } ///< Driving statistics since last reset
+    void resetStats() { m_stats = ECD_Stats(); }      ///< Clear driving statistics
+#else
+    const ECD_Stats& getStats() const { static const ECD_Stats none; return none; } ///< Statistics compiled out: all zero
+    void resetStats() {}                              ///< Statistics compiled out: nothing to clear
+#endif
+#ifndef YNV_ECD_NO_PHASE
+    uint8_t getPhase() const { return m_phase; }      ///< Current ecdDriverPhase_e (e.g. read from an ISR)
+#else
+    uint8_t getPhase() const { return DRIVER_PHASE_IDLE; } ///< Phase tracking compiled out
+#endif
+    int  getSegmentState(int t_segment) const;        ///< Current ecdSegmentState_e of a segment
+    int  getNumberOfSegments() const { return m_numberOfSegments; } ///< Number of segments of the display
+    ECD_Hal& getHal() { return m_hal; }               ///< Hardware backend (e.g. attach an expander bus)
+#ifdef YNV_ECD_SIMULATOR
+    void attachSimulator(YNV_ECD_Simulator* t_simulator); ///< Route all I/O to a simulated board (nullptr = Arduino)
+#endif
     
 private:
-    void execute_bleach(void);                        ///< Apply BLEACH transition pulse
-    void execute_color(void);                         ///< Apply COLOR transition pulse
+    void execute_bleach(ecdSegmentMask_t t_select = ~(ecdSegmentMask_t)0); ///< Apply BLEACH transition pulse (pending changes in t_select)
+    void execute_color(ecdSegmentMask_t t_select = ~(ecdSegmentMask_t)0);  ///< Apply COLOR transition pulse (pending changes in t_select)
+    void execute_priority(void);                      ///< Latency-first phase: COLOR then BLEACH pulse of the high-priority changes
+    ecdSegmentMask_t pendingChanges(void) const;      ///< Segments whose requested state is not applied yet
     void check_refresh(void);                         ///< Measure OCP and determine refresh needs
+    void classifyRefresh(void);                       ///< Classify the segments (OK / marginal / due) and build the refresh list
+    bool refreshRoundAllowed(bool t_colorRound, unsigned long t_nowMs) const; ///< minRefreshInterval passed since the last round
     void execute_refresh(void);                       ///< Dispatcher for refresh routines
     void refreshBleach(void);                         ///< Refresh BLEACHED segments
     void refreshColor(void);                          ///< Refresh COLORED segments
     void updateRefreshLimits(void);                   ///< Recompute thresholds in LSB
     void disableAllSegments(void);                    ///< Set all WE pins to High-Z
+    void setPhase(ecdDriverPhase_e t_phase);          ///< Enter a driving phase (traced in simulation)
+    void armRefreshWatch(void);                       ///< CE to the check level, pending events cleared
+    void markDriven(ecdSegmentMask_t t_driven);       ///< Pulse ended on t_driven: start of its settle time
+    void measureOcp(ecdSegmentMask_t t_select);       ///< Read OCPs: undisturbed segments first, settle before the disturbed ones
+    void correctCrosstalk(ecdSegmentMask_t t_select); ///< Remove the learned neighbour coupling from the readings
+    ecdSegmentMask_t allSegments(void) const;         ///< Mask of segments 0..m_numberOfSegments-1
 
     ECD_Config m_cfg;
+#ifndef YNV_ECD_NO_STATS
+    ECD_Stats  m_stats;
+#endif
     int        m_numberOfSegments;
     int        m_counterElectrodePin;
-    int        m_segmentPinsList       [MAX_NUMBER_OF_SEGMENTS];
-    
-    uint8_t    m_currentState          [MAX_NUMBER_OF_SEGMENTS];
-    uint8_t    m_nextState             [MAX_NUMBER_OF_SEGMENTS];
-    
-    bool       m_refreshSegmentNeeded  [MAX_NUMBER_OF_SEGMENTS];
+    const int* m_segmentPinsList;                     // m_numberOfSegments WE pins
+    uint16_t*  m_ocpReadings;                         // m_numberOfSegments last OCP readings (LSB)
+    bool       m_ownsStorage           {false};       // Both arrays allocated by the constructor
+
+    ecdSegmentMask_t m_currentColor    {0};           // Segments colored by the last transition
+    ecdSegmentMask_t m_currentBleach   {0};           // Segments bleached by the last transition
+    ecdSegmentMask_t m_nextColor       {0};           // Segments requested colored
+    ecdSegmentMask_t m_nextBleach      {0};           // Segments requested bleached
+    ecdSegmentMask_t m_refreshNeeded   {0};           // Segments in the refresh list
+    ecdSegmentMask_t m_prioritySegments{0};           // Segments set to SEGMENT_PRIORITY_HIGH
+    ecdSegmentMask_t m_urgentChanges   {0};           // Pending changes staged with SEGMENT_PRIORITY_HIGH
+    unsigned long m_timeToVisible[2]   {0, 0};        // (ms) Last executeDisplay(), per ecdSegmentPriority_e
+    ecdSegmentMask_t m_segmentDue      {0};           // Class of the last check: past the refresh limit
+    ecdSegmentMask_t m_segmentMarginal {0};           // Class of the last check: past half of the band
+    unsigned long m_lastColorRoundMs   {0};           // (ms) End of the last Color refresh round
+    unsigned long m_lastBleachRoundMs  {0};           // (ms) End of the last Bleach refresh round
+    bool       m_colorRoundDone        {false};       // A Color refresh round ran (m_lastColorRoundMs valid)
+    bool       m_bleachRoundDone       {false};       // A Bleach refresh round ran (m_lastBleachRoundMs valid)
+    ecdSegmentMask_t m_refreshPending  {0};           // Refresh watch: segments that left their band
+    bool       m_watchActive           {false};       // Refresh watch: CE held at the check level
+    int        m_watchSegment          {-1};          // Refresh watch: last compared segment
+    const ecdSegmentMask_t* m_neighbours {nullptr};   // Adjacency map, m_numberOfSegments masks (caller storage)
+    float*     m_crosstalkGains        {nullptr};     // Crosstalk gain per segment (caller storage)
+    ecdSegmentMask_t m_recentlyDriven  {0};           // Segments pulsed since the readings last settled
+    unsigned long m_settledMs          {0};           // (ms) Time the last pulse stops disturbing the readings
+    int        m_settleSpentMs         {0};           // (ms) Settle waits of the current update (ocpSettleBudget)
+    int        m_counterElectrodeLSB   {ADC_DAC_MAX_LSB / 2}; // Last CE DAC code
     int        m_minBleachOcpLSB       {0};
     bool       m_bleachRequiredFlag;
     bool       m_refresh_bleach_needed;
     bool       m_colorRequiredFlag;
     bool       m_refresh_color_needed;
     
-    static bool m_stopDrivingFlag;
+    ecdFlag_t  m_stopDrivingFlag       {false};       // Per-display, may be set from an ISR or another thread
+#ifndef YNV_ECD_NO_PHASE
+    ecdPhase_t m_phase                 {DRIVER_PHASE_IDLE};
+#endif
 
     float      m_supplyVoltage         {SUPPLY_VOLTAGE};
     float      m_refreshColorLimitH, m_refreshColorLimitL, m_refreshColorHalf;
     float      m_refreshBleachLimitH, m_refreshBleachLimitL, m_refreshBleachHalf;
+    float      m_refreshHysteresis;                   // (LSB) refreshHysteresisVoltage
+    float      m_refreshEntryMargin;                  // (LSB) refreshEntryMarginVoltage
+
+    ECD_Hal    m_hal;                                 // Hardware backend (YnvisibleECDHal.h)
+};
+
+
+/**
+ * @brief Storage of a YNV_ECD_Sized display (base class, so it is built
+ * before the YNV_ECD that uses it).
+ */
+template <int Capacity>
+struct ECD_SegmentBuffer {
+    uint16_t m_ocpStorage[Capacity];
+};
+
+/**
+ * @class YNV_ECD_Sized
+ * @brief YNV_ECD with storage for exactly Capacity segments inside the object
+ * (no heap), e.g. YNV_ECD_Sized<7> bars(7, barPins);
+ *
+ * The pin list is referenced, not copied: it must outlive the display.
+ *
+ * @tparam Capacity Number of segments (1..MAX_NUMBER_OF_SEGMENTS); a larger
+ *         t_numberOfSegments is clamped to it.
+ */
+template <int Capacity>
+class YNV_ECD_Sized : private ECD_SegmentBuffer<Capacity>, public YNV_ECD {
+    static_assert(Capacity > 0 && Capacity <= MAX_NUMBER_OF_SEGMENTS, "Capacity must be 1..MAX_NUMBER_OF_SEGMENTS");
+public:
+    YNV_ECD_Sized(int t_numberOfSegments, const int* t_segments, int t_counterElectrodePin = PIN_CE)
+        : YNV_ECD((t_numberOfSegments < Capacity) ? t_numberOfSegments : Capacity, t_segments,
+                  t_counterElectrodePin, ECD_SegmentBuffer<Capacity>::m_ocpStorage) {}
 };
 
 #endif // _YNVISIBLE_ECD
@@ -0,0 +1,340 @@
+
+/**
+ * @file YnvisibleECDCompositor.cpp
+ * @brief Layered frame compositor in front of one YNV_ECD display.
+ *
+ * This file implements the ECD_Compositor class declared in
+ * YnvisibleECDCompositor.h: the layer writes, the composition of the visible
+ * layers and the minimal-diff commit to the display.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include "Arduino.h"
+#include "YnvisibleECDCompositor.h"
+
+
+/***************************************************************************/
+/******************************** HELPERS **********************************/
+/***************************************************************************/
+
+static ecdSegmentMask_t segmentsMask(int t_numberOfSegments)     // Mask of segments 0..t_numberOfSegments-1
+{
+  if (t_numberOfSegments <= 0) {
+    return 0;
+  }
+  return (ecdSegmentMask_t)~(ecdSegmentMask_t)0 >> (8 * sizeof(ecdSegmentMask_t) - t_numberOfSegments);
+}
+
+
+/***************************************************************************/
+/**************************** PUBLIC FUNCTIONS *****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Compositor of one display.
+ *
+ * @param t_display Display the composite is committed to
+ * @param t_windowMs (ms) Scheduling window: minimum time between commits
+ */
+/***************************************************************************/
+
+ECD_Compositor::ECD_Compositor(YNV_ECD& t_display, unsigned long t_windowMs)
+  : m_display(t_display), m_windowMs(t_windowMs)
+{
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Replace the content of a layer.
+ *
+ * @param t_layer ecdLayer_e
+ * @param t_states Requested states (bit i: 1 = color), only inside t_select
+ * @param t_select Segments covered by the layer
+ */
+/***************************************************************************/
+
+void ECD_Compositor::setLayer(uint8_t t_layer, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select)
+{
+  t_select &= segmentsMask(m_display.getNumberOfSegments());
+  storeLayer(t_layer, t_states & t_select, t_select);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Cover one segment of a layer with a state.
+ */
+/***************************************************************************/
+
+void ECD_Compositor::setSegment(uint8_t t_layer, int t_segment, bool t_state)
+{
+  if (t_layer >= ECD_COMPOSITOR_LAYERS || t_segment < 0 || t_segment >= m_display.getNumberOfSegments()) {
+    return;
+  }
+  ecdSegmentMask_t bit    = (ecdSegmentMask_t)1 << t_segment;
+  ecdSegmentMask_t states = t_state ? (m_states[t_layer] | bit) : (m_states[t_layer] & ~bit);
+  storeLayer(t_layer, states, m_select[t_layer] | bit);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Uncover one segment of a layer: the layers below show through.
+ */
+/***************************************************************************/
+
+void ECD_Compositor::releaseSegment(uint8_t t_layer, int t_segment)
+{
+  if (t_layer >= ECD_COMPOSITOR_LAYERS || t_segment < 0 || t_segment >= m_display.getNumberOfSegments()) {
+    return;
+  }
+  ecdSegmentMask_t bit = (ecdSegmentMask_t)1 << t_segment;
+  storeLayer(t_layer, m_states[t_layer] & ~bit, m_select[t_layer] & ~bit);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Uncover all segments of a layer.
+ */
+/***************************************************************************/
+
+void ECD_Compositor::clearLayer(uint8_t t_layer)
+{
+  storeLayer(t_layer, 0, 0);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Show or hide a layer. Showing the blink layer starts a shown
+ * half-period, so a blink starts visible.
+ */
+/***************************************************************************/
+
+void ECD_Compositor::showLayer(uint8_t t_layer, bool t_visible)
+{
+  if (t_layer >= ECD_COMPOSITOR_LAYERS || m_visible[t_layer] == t_visible) {
+    return;
+  }
+  if (t_layer == ECD_LAYER_BLINK && t_visible) {
+    m_blinkStartMs = m_display.getHal().millis();
+  }
+  m_visible[t_layer] = t_visible;
+  m_layersDirty      = true;
+  m_stats.layerChanges++;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Priority of the segment changes a layer wins (e.g. an alarm
+ * overlay with SEGMENT_PRIORITY_HIGH, see YNV_ECD::setSegmentState()).
+ */
+/***************************************************************************/
+
+void ECD_Compositor::setLayerPriority(uint8_t t_layer, uint8_t t_priority)
+{
+  if (t_layer < ECD_COMPOSITOR_LAYERS) {
+    m_priority[t_layer] = t_priority;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Blink half-period; the blink layer restarts in its shown half.
+ *
+ * @param t_halfPeriodMs (ms) Shown time = hidden time, 0 = always shown
+ */
+/***************************************************************************/
+
+void ECD_Compositor::setBlinkPeriod(unsigned long t_halfPeriodMs)
+{
+  m_blinkHalfMs  = t_halfPeriodMs;
+  m_blinkStartMs = m_display.getHal().millis();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Composite frame at the current time (bit i: 1 = color), e.g. for
+ * ECD_CommandQueue::postFrame() from a producer task.
+ */
+/***************************************************************************/
+
+ecdSegmentMask_t ECD_Compositor::compose() const
+{
+  return composeAt(m_display.getHal().millis());
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Commit the composite when the scheduling window has passed since
+ * the last commit. Call it from the display loop as often as wanted.
+ *
+ * @return true if the display was updated
+ */
+/***************************************************************************/
+
+bool ECD_Compositor::service()
+{
+  unsigned long now = m_display.getHal().millis();
+
+  m_stats.services++;
+  if (m_committedValid && now - m_lastCommitMs < m_windowMs) {
+    if (composeAt(now) != m_committed) {
+      m_stats.heldByWindow++;
+    }
+    return false;
+  }
+  return commitAt(now);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Commit the composite now, whatever the window.
+ *
+ * @return true if the display was updated
+ */
+/***************************************************************************/
+
+bool ECD_Compositor::commit()
+{
+  return commitAt(m_display.getHal().millis());
+}
+
+
+/***************************************************************************/
+/************************** END PUBLIC FUNCTIONS ***************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**************************** PRIVATE FUNCTIONS ****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Visible layer, and for the blink layer in a shown half-period.
+ */
+/***************************************************************************/
+
+bool ECD_Compositor::layerShown(uint8_t t_layer, unsigned long t_nowMs) const
+{
+  if (!m_visible[t_layer]) {
+    return false;
+  }
+  if (t_layer == ECD_LAYER_BLINK && m_blinkHalfMs > 0) {
+    return ((t_nowMs - m_blinkStartMs) / m_blinkHalfMs) % 2 == 0;
+  }
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Store a layer; only a real change marks the layers dirty.
+ */
+/***************************************************************************/
+
+void ECD_Compositor::storeLayer(uint8_t t_layer, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select)
+{
+  if (t_layer >= ECD_COMPOSITOR_LAYERS || (m_states[t_layer] == t_states && m_select[t_layer] == t_select)) {
+    return;
+  }
+  m_states[t_layer] = t_states;
+  m_select[t_layer] = t_select;
+  m_layersDirty     = true;
+  m_stats.layerChanges++;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Shown layers bottom to top, each replacing the segments it covers.
+ */
+/***************************************************************************/
+
+ecdSegmentMask_t ECD_Compositor::composeAt(unsigned long t_nowMs) const
+{
+  ecdSegmentMask_t frame = 0;
+
+  for (uint8_t layer = 0; layer < ECD_COMPOSITOR_LAYERS; layer++) {
+    if (layerShown(layer, t_nowMs)) {
+      frame = (frame & ~m_select[layer]) | m_states[layer];
+    }
+  }
+  return frame;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Stage the segments whose composite state differs from the last
+ * commit, with the priority of the layer that shows them, and run one
+ * executeDisplay(). Segments a stopped update left unchanged stay
+ * uncommitted, so the next commit stages them again.
+ *
+ * @return true if the display was updated
+ */
+/***************************************************************************/
+
+bool ECD_Compositor::commitAt(unsigned long t_nowMs)
+{
+  int              segments = m_display.getNumberOfSegments();
+  ecdSegmentMask_t frame    = composeAt(t_nowMs);
+  ecdSegmentMask_t diff     = m_committedValid ? (frame ^ m_committed) : segmentsMask(segments);
+  bool             shown[ECD_COMPOSITOR_LAYERS];
+
+  if (diff == 0) {
+    if (m_layersDirty) {
+      m_stats.cancelledChanges++;                           // Layer writes that undid each other
+      m_layersDirty = false;
+    }
+    return false;
+  }
+
+  for (uint8_t layer = 0; layer < ECD_COMPOSITOR_LAYERS; layer++) {
+    shown[layer] = layerShown(layer, t_nowMs);
+  }
+  for (int i = 0; i < segments; i++) {
+    ecdSegmentMask_t bit      = (ecdSegmentMask_t)1 << i;
+    uint8_t          priority = SEGMENT_PRIORITY_NORMAL;
+    if ((diff & bit) == 0) {
+      continue;
+    }
+    for (int layer = ECD_COMPOSITOR_LAYERS - 1; layer >= 0; layer--) {   // Topmost layer showing the segment
+      if (shown[layer] && (m_select[layer] & bit)) {
+        priority = m_priority[layer];
+        break;
+      }
+    }
+    m_display.setSegmentState(i, (frame & bit) != 0, priority);
+    m_stats.segmentsStaged++;
+  }
+  m_display.executeDisplay();
+
+  ecdSegmentMask_t applied = 0;                             // Changes the update really made
+  for (int i = 0; i < segments; i++) {
+    ecdSegmentMask_t bit = (ecdSegmentMask_t)1 << i;
+    if ((diff & bit) && m_display.getSegmentState(i) == ((frame & bit) ? SEGMENT_STATE_COLOR : SEGMENT_STATE_BLEACH)) {
+      applied |= bit;
+    }
+  }
+  m_committed      = (m_committed & ~applied) | (frame & applied);
+  m_committedValid = m_committedValid || applied == diff;
+  m_lastCommitMs   = t_nowMs;
+  m_layersDirty    = false;
+  m_stats.commits++;
+  return true;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,126 @@
+
+/**
+ * @file YnvisibleECDCompositor.h
+ * @brief Layered frame compositor in front of one YNV_ECD display.
+ *
+ * Applications draw on a few layers instead of merging masks by hand, e.g. a
+ * value on the base layer, a warning indicator or a unit sign on the overlay
+ * and a blinking colon on the blink layer:
+ *  - Each layer holds the states of the segments it covers (select mask);
+ *    a visible layer hides the layers below it on those segments, and
+ *    segments covered by no layer are bleached.
+ *  - The blink layer is shown and hidden in turn every blink half-period.
+ *  - Layer writes only change masks. service() composes the frame, compares
+ *    it with the frame last committed to the display and stages only the
+ *    segments that differ, then runs executeDisplay() once; an unchanged
+ *    composite does not touch the display at all.
+ *  - With a scheduling window, service() commits at most once per window:
+ *    layer toggles that cancel out inside it never reach the hardware.
+ *
+ * The compositor is used by the owner of the display (the caller of
+ * executeDisplay(), or an ECD_CommandQueue producer through compose()), and
+ * assumes no one else changes the segment states. Refresh is not its
+ * business: between commits the display is checked as before (executeDisplay()
+ * or the refresh watch).
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_COMPOSITOR
+#define _YNVISIBLE_ECD_COMPOSITOR
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_COMPOSITOR_LAYERS               3             // Base, overlay, blink
+#define ECD_COMPOSITOR_BLINK_MS             500           // (ms) Default blink half-period (shown, then hidden)
+
+
+/**
+ * @brief Layers of the compositor, bottom to top.
+ */
+enum ecdLayer_e {
+    ECD_LAYER_BASE      = 0,    // Main content (e.g. the value)
+    ECD_LAYER_OVERLAY   = 1,    // Indicators and signs on top of the base
+    ECD_LAYER_BLINK     = 2     // Shown every other blink half-period
+};
+
+/**
+ * @brief Compositor counters since construction or resetStats().
+ */
+struct ECD_CompositorStats {
+
+    unsigned long layerChanges              { 0 };                              // Layer writes that changed a layer
+    unsigned long services                  { 0 };                              // service() calls
+    unsigned long commits                   { 0 };                              // executeDisplay() calls (composite changed)
+    unsigned long segmentsStaged            { 0 };                              // Segment changes passed to the display
+    unsigned long cancelledChanges          { 0 };                              // Commit points where the layers changed, the composite not
+    unsigned long heldByWindow              { 0 };                              // service() calls with a change held back by the window
+};
+
+
+// ---------------------------------------------------------------------------
+// Frame Compositor
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_Compositor
+ * @brief Base, overlay and blink layers composed into minimal-diff commits.
+ */
+class ECD_Compositor {
+public:
+    explicit ECD_Compositor(YNV_ECD& t_display, unsigned long t_windowMs = 0);
+    ECD_Compositor(const ECD_Compositor&) = delete;
+    ECD_Compositor& operator=(const ECD_Compositor&) = delete;
+
+    // Layers
+    void setLayer(uint8_t t_layer, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select = ~(ecdSegmentMask_t)0); ///< Replace a layer (bit i of t_states: 1 = color)
+    void setSegment(uint8_t t_layer, int t_segment, bool t_state);  ///< Cover one segment with a state
+    void releaseSegment(uint8_t t_layer, int t_segment);            ///< Uncover one segment (lower layers show through)
+    void clearLayer(uint8_t t_layer);                               ///< Uncover all segments of a layer
+    void showLayer(uint8_t t_layer, bool t_visible);                ///< Show or hide a layer (blink: restarts shown)
+    void setLayerPriority(uint8_t t_layer, uint8_t t_priority);     ///< ecdSegmentPriority_e of the changes a layer wins
+    void setBlinkPeriod(unsigned long t_halfPeriodMs);              ///< Blink half-period (0 = blink layer steady)
+    void setWindow(unsigned long t_windowMs) { m_windowMs = t_windowMs; } ///< Minimum time between commits
+
+    // Output
+    ecdSegmentMask_t compose(void) const;                           ///< Composite frame at the current time
+    bool service(void);                                             ///< Commit the composite if it changed and the window allows; true if committed
+    bool commit(void);                                              ///< Commit the composite if it changed, ignoring the window
+    ecdSegmentMask_t getCommitted(void) const { return m_committed; } ///< Frame last committed to the display
+
+    const ECD_CompositorStats& getStats(void) const { return m_stats; } ///< Compositor counters
+    void resetStats(void) { m_stats = ECD_CompositorStats(); }      ///< Clear the compositor counters
+
+private:
+    bool layerShown(uint8_t t_layer, unsigned long t_nowMs) const;  ///< Visible and, for the blink layer, in its shown half-period
+    void storeLayer(uint8_t t_layer, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select); ///< Store a layer, count a real change
+    ecdSegmentMask_t composeAt(unsigned long t_nowMs) const;        ///< Composite frame at t_nowMs
+    bool commitAt(unsigned long t_nowMs);                           ///< Stage the differing segments and update the display
+
+    YNV_ECD&         m_display;
+    ecdSegmentMask_t m_states[ECD_COMPOSITOR_LAYERS]     {0, 0, 0}; // Requested states (inside the select mask)
+    ecdSegmentMask_t m_select[ECD_COMPOSITOR_LAYERS]     {0, 0, 0}; // Segments covered by each layer
+    bool             m_visible[ECD_COMPOSITOR_LAYERS]    {true, true, true};
+    uint8_t          m_priority[ECD_COMPOSITOR_LAYERS]   {SEGMENT_PRIORITY_NORMAL, SEGMENT_PRIORITY_NORMAL, SEGMENT_PRIORITY_NORMAL};
+    unsigned long    m_blinkHalfMs          {ECD_COMPOSITOR_BLINK_MS};
+    unsigned long    m_blinkStartMs         {0};                    // (ms) Start of a shown half-period
+    unsigned long    m_windowMs;
+    unsigned long    m_lastCommitMs         {0};
+    ecdSegmentMask_t m_committed            {0};                    // Frame the display was last given
+    bool             m_committedValid       {false};                // false: nothing committed yet, every segment is staged
+    bool             m_layersDirty          {false};                // Layers changed since the last commit point
+    ECD_CompositorStats m_stats;
+};
+
+#endif // _YNVISIBLE_ECD_COMPOSITOR
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
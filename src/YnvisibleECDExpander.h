@@ -0,0 +1,307 @@
+
+/**
+ * @file YnvisibleECDExpander.h
+ * @brief Segment outputs on GPIO expanders, with batched bus transactions.
+ *
+ * Large custom panels can drive their WE pins through GPIO expanders with
+ * tri-state outputs (MCP23017 on I2C, MCP23S17 on SPI, or the simulated
+ * expander of YnvisibleECDSimulator.h). Expander outputs are addressed by
+ * virtual pin numbers, ECD_EXPANDER_PIN(chip, bit), in the segment pin list
+ * of a YNV_ECD; lower pin numbers stay on the board (native backend).
+ *
+ * Build with YNV_ECD_HAL_EXPANDER: ECD_Hal becomes ECD_ExpanderHal on top of
+ * the backend the other flags select, and the bus is attached at run time:
+ *   display.getHal().attachExpander(&bus, numberOfChips);
+ *
+ * Batching and timing:
+ *  - Group operations (drivePins(), releasePins()) only stage the new output
+ *    level and enable bits of each chip, then flush: one bus transaction
+ *    (ECD_ExpanderBus::writeChip()) per chip that changed, level before
+ *    enable within the transaction.
+ *  - Chips are always written in ascending order, so on drive and release
+ *    every chip is switched at the same offset after the start of the flush
+ *    (its rank x transactionMicros()). Each chip thus sees a pulse of exactly
+ *    the engine pulse time; the start skew between chips is bounded by the
+ *    flush duration, reported in ECD_ExpanderStats.
+ *  - Expanders cannot measure the OCP. The OCP of expander pins comes from an
+ *    ECD_OcpSensor set with setOcpSensor() (group scans, e.g. the analog
+ *    muxes of YnvisibleECDMux.h), else from the per-pin reader set with
+ *    setOcpReader(), else every segment reports its last driven level (open
+ *    loop: no refresh).
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_EXPANDER
+#define _YNVISIBLE_ECD_EXPANDER
+
+#include "Arduino.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_EXPANDER_PIN_BASE               128           // Virtual pin number of chip 0, bit 0
+#define ECD_EXPANDER_PINS_PER_CHIP          16            // Outputs per chip (MCP23x17: ports A and B)
+#define ECD_EXPANDER_MAX_CHIPS              8             // Chips per bus (MCP23x17 hardware addresses 0..7)
+
+#define ECD_EXPANDER_PIN(t_chip, t_bit)     (ECD_EXPANDER_PIN_BASE + (t_chip) * ECD_EXPANDER_PINS_PER_CHIP + (t_bit))
+
+
+// ---------------------------------------------------------------------------
+// Bus Interface
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_ExpanderBus
+ * @brief Transport to a set of expander chips.
+ *
+ * Bus transfers take far longer than a virtual call, so transports are
+ * run-time objects; the engine-side backend stays static.
+ */
+class ECD_ExpanderBus {
+public:
+    virtual ~ECD_ExpanderBus() {}
+
+    /** @brief Bus and chip setup (all outputs tri-stated). */
+    virtual void begin(uint8_t t_numberOfChips) { (void)t_numberOfChips; }
+
+    /**
+     * @brief Write the output levels, then the output enables, of one chip
+     * in a single bus transaction.
+     * @param t_chip Chip index (0..ECD_EXPANDER_MAX_CHIPS-1)
+     * @param t_level Output latch (bit i = output i HIGH)
+     * @param t_outputs Output enables (bit i = output i driven, 0 = High-Z)
+     */
+    virtual void writeChip(uint8_t t_chip, uint16_t t_level, uint16_t t_outputs) = 0;
+
+    /** @brief (us) Duration of one writeChip() transaction (timing model). */
+    virtual unsigned long transactionMicros(void) const = 0;
+};
+
+/**
+ * @class ECD_OcpSensor
+ * @brief External OCP measurement path for pins without an ADC input.
+ *
+ * scan() receives a whole group so a sensor can order and overlap its
+ * measurements (see ECD_AnalogMux).
+ */
+class ECD_OcpSensor {
+public:
+    virtual ~ECD_OcpSensor() {}
+
+    /** @brief OCP of one pin (ADC LSB). */
+    virtual int read(int t_pin) = 0;
+
+    /**
+     * @brief OCP of a group: t_values[t_indices[k]] = OCP of t_pins[t_indices[k]].
+     * @param t_pins Pin list of the display
+     * @param t_indices Indices of the pins to measure, ascending
+     * @param t_count Number of indices
+     */
+    virtual void scan(const int* t_pins, const uint8_t* t_indices, int t_count, uint16_t* t_values) {
+        for (int k = 0; k < t_count; k++) {
+            t_values[t_indices[k]] = (uint16_t)read(t_pins[t_indices[k]]);
+        }
+    }
+};
+
+/**
+ * @brief Bus activity of an ECD_ExpanderHal since attachExpander().
+ */
+struct ECD_ExpanderStats {
+
+    unsigned long flushes                   { 0 };                              // Flushes with at least one transaction
+    unsigned long transactions              { 0 };                              // writeChip() calls
+    unsigned long busMicros                 { 0 };                              // (us) Modelled bus time
+    unsigned long maxFlushMicros            { 0 };                              // (us) Longest flush = max start skew between chips
+};
+
+
+// ---------------------------------------------------------------------------
+// Expander Backend
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_ExpanderHal
+ * @brief ECD_Hal backend routing expander pins to an ECD_ExpanderBus.
+ *
+ * @tparam Native Backend for the board pins, the CE, the ADC and the clock.
+ */
+template <class Native>
+class ECD_ExpanderHal : public Native {
+public:
+    /** @brief Attach the expander bus; all chips are written once (outputs as staged). */
+    void attachExpander(ECD_ExpanderBus* t_bus, uint8_t t_numberOfChips) {
+        m_bus           = t_bus;
+        m_numberOfChips = (t_numberOfChips < ECD_EXPANDER_MAX_CHIPS) ? t_numberOfChips : ECD_EXPANDER_MAX_CHIPS;
+        m_stats         = ECD_ExpanderStats();
+        if (m_bus == nullptr) {
+            return;
+        }
+        m_bus->begin(m_numberOfChips);
+        for (uint8_t chip = 0; chip < m_numberOfChips; chip++) {
+            m_bus->writeChip(chip, m_level[chip], m_outputs[chip]);
+            m_writtenLevel[chip]   = m_level[chip];
+            m_writtenOutputs[chip] = m_outputs[chip];
+        }
+    }
+
+    /** @brief Group OCP path of expander pins (nullptr = use the reader below). */
+    void setOcpSensor(ECD_OcpSensor* t_sensor) { m_ocpSensor = t_sensor; }
+
+    /** @brief Per-pin OCP path of expander pins (nullptr = open loop, see file header). */
+    void setOcpReader(int (*t_reader)(int t_pin, void* t_context), void* t_context) {
+        m_ocpReader        = t_reader;
+        m_ocpReaderContext = t_context;
+    }
+
+    const ECD_ExpanderStats& getExpanderStats() const { return m_stats; }
+
+    void begin(int t_resolution) {
+        Native::begin(t_resolution);
+        m_adcMaxLSB = (1 << t_resolution) - 1;
+    }
+
+    void pinMode(int t_pin, int t_mode) {
+        if (!isExpanderPin(t_pin)) { Native::pinMode(t_pin, t_mode); return; }
+        stageOutput(t_pin, t_mode == OUTPUT);
+        flush();
+    }
+
+    void digitalWrite(int t_pin, int t_level) {
+        if (!isExpanderPin(t_pin)) { Native::digitalWrite(t_pin, t_level); return; }
+        stageLevel(t_pin, t_level != LOW);
+        flush();
+    }
+
+    int readAdc(int t_pin) {
+        if (!isExpanderPin(t_pin)) { return Native::readAdc(t_pin); }
+        if (m_ocpSensor != nullptr) { return m_ocpSensor->read(t_pin); }
+        if (m_ocpReader != nullptr) { return m_ocpReader(t_pin, m_ocpReaderContext); }
+        int chip = chipOf(t_pin);
+        return (chip < ECD_EXPANDER_MAX_CHIPS && (m_level[chip] & bitOf(t_pin))) ? m_adcMaxLSB : 0;
+    }
+
+    /** @brief Window compare: board pins on the native backend, expander pins through readAdc(). */
+    bool compareAdc(int t_pin, int t_low, int t_high, int& t_value) {
+        if (!isExpanderPin(t_pin)) { return Native::compareAdc(t_pin, t_low, t_high, t_value); }
+        t_value = readAdc(t_pin);
+        return t_value < t_low || t_value > t_high;
+    }
+
+    /** @brief Drive the selected pins: board pins at once, expander pins in one flush. */
+    template <class Mask>
+    void drivePins(const int* t_pins, Mask t_select, int t_count, int t_level) {
+        Mask native = 0;
+        Mask select = t_select;
+
+        for (int i = 0; i < t_count && select != 0; i++, select >>= 1) {
+            if (select & 1) {
+                if (isExpanderPin(t_pins[i])) {
+                    stageLevel(t_pins[i], t_level != LOW);
+                    stageOutput(t_pins[i], true);
+                } else {
+                    native |= ((Mask)1 << i);
+                }
+            }
+        }
+        Native::drivePins(t_pins, native, t_count, t_level);
+        flush();
+    }
+
+    /** @brief Set a group of pins to High-Z, expander pins in one flush. */
+    void releasePins(const int* t_pins, int t_count) {
+        for (int i = 0; i < t_count; i++) {
+            if (isExpanderPin(t_pins[i])) {
+                stageOutput(t_pins[i], false);
+            } else {
+                Native::pinMode(t_pins[i], INPUT);
+            }
+        }
+        flush();
+    }
+
+    /** @brief Read board pins directly, then all selected expander pins in one sensor scan. */
+    template <class Mask>
+    void scanAdc(const int* t_pins, Mask t_select, int t_count, uint16_t* t_values) {
+        uint8_t indices[sizeof(Mask) * 8];
+        int     count = 0;
+
+        for (int i = 0; i < t_count && t_select != 0; i++, t_select >>= 1) {
+            if (t_select & 1) {
+                if (m_ocpSensor != nullptr && isExpanderPin(t_pins[i])) {
+                    indices[count++] = (uint8_t)i;
+                } else {
+                    t_values[i] = (uint16_t)readAdc(t_pins[i]);
+                }
+            }
+        }
+        if (count > 0) {
+            m_ocpSensor->scan(t_pins, indices, count, t_values);
+        }
+    }
+
+private:
+    static bool     isExpanderPin(int t_pin) { return t_pin >= ECD_EXPANDER_PIN_BASE; }
+    static int      chipOf(int t_pin)        { return (t_pin - ECD_EXPANDER_PIN_BASE) / ECD_EXPANDER_PINS_PER_CHIP; }
+    static uint16_t bitOf(int t_pin)         { return (uint16_t)(1u << ((t_pin - ECD_EXPANDER_PIN_BASE) % ECD_EXPANDER_PINS_PER_CHIP)); }
+
+    void stageLevel(int t_pin, bool t_high) {
+        int chip = chipOf(t_pin);
+        if (chip >= ECD_EXPANDER_MAX_CHIPS) { return; }
+        if (t_high) { m_level[chip] |= bitOf(t_pin); } else { m_level[chip] &= ~bitOf(t_pin); }
+    }
+
+    void stageOutput(int t_pin, bool t_output) {
+        int chip = chipOf(t_pin);
+        if (chip >= ECD_EXPANDER_MAX_CHIPS) { return; }
+        if (t_output) { m_outputs[chip] |= bitOf(t_pin); } else { m_outputs[chip] &= ~bitOf(t_pin); }
+    }
+
+    /** @brief One transaction per changed chip, in ascending chip order. */
+    void flush() {
+        if (m_bus == nullptr) {
+            return;
+        }
+        unsigned long transactions = 0;
+        for (uint8_t chip = 0; chip < m_numberOfChips; chip++) {
+            if (m_level[chip] != m_writtenLevel[chip] || m_outputs[chip] != m_writtenOutputs[chip]) {
+                m_bus->writeChip(chip, m_level[chip], m_outputs[chip]);
+                m_writtenLevel[chip]   = m_level[chip];
+                m_writtenOutputs[chip] = m_outputs[chip];
+                transactions++;
+            }
+        }
+        if (transactions > 0) {
+            unsigned long flushMicros = transactions * m_bus->transactionMicros();
+            m_stats.flushes++;
+            m_stats.transactions += transactions;
+            m_stats.busMicros    += flushMicros;
+            if (flushMicros > m_stats.maxFlushMicros) {
+                m_stats.maxFlushMicros = flushMicros;
+            }
+        }
+    }
+
+    ECD_ExpanderBus*  m_bus                 {nullptr};
+    ECD_OcpSensor*    m_ocpSensor           {nullptr};
+    uint8_t           m_numberOfChips       {0};
+    int               (*m_ocpReader)(int, void*) {nullptr};
+    void*             m_ocpReaderContext    {nullptr};
+    int               m_adcMaxLSB           {1023};
+    ECD_ExpanderStats m_stats;
+
+    uint16_t          m_level               [ECD_EXPANDER_MAX_CHIPS] {};   // Staged output latches
+    uint16_t          m_outputs             [ECD_EXPANDER_MAX_CHIPS] {};   // Staged output enables
+    uint16_t          m_writtenLevel        [ECD_EXPANDER_MAX_CHIPS] {};   // Last written to the chips
+    uint16_t          m_writtenOutputs      [ECD_EXPANDER_MAX_CHIPS] {};
+};
+
+#endif // _YNVISIBLE_ECD_EXPANDER
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
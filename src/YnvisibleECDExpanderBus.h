@@ -0,0 +1,148 @@
+
+/**
+ * @file YnvisibleECDExpanderBus.h
+ * @brief MCP23017 (I2C) and MCP23S17 (SPI) transports for ECD_ExpanderHal.
+ *
+ * Header-only, include it from the sketch (it pulls in Wire.h and SPI.h):
+ *   #include "YnvisibleECDExpanderBus.h"
+ *   ECD_Mcp23017Bus bus(Wire);
+ *   display.getHal().attachExpander(&bus, 2);
+ *
+ * Both chips use the power-on register layout (IOCON.BANK = 0). One
+ * transaction is a single sequential write of four registers starting at
+ * OLATA: OLATA, OLATB, then the address pointer wraps to IODIRA, IODIRB.
+ * The output latch is therefore always written before the direction, so an
+ * output is never enabled at its previous level.
+ *
+ * Shift registers (74HC595) have no per-output High-Z state, which the open-
+ * circuit OCP measurement of every segment needs, hence SPI expanders.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_EXPANDER_BUS
+#define _YNVISIBLE_ECD_EXPANDER_BUS
+
+#include "Arduino.h"
+#include <Wire.h>
+#include <SPI.h>
+#include "YnvisibleECDExpander.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_MCP23X17_IODIRA                 0x00          // Direction register, port A (1 = input)
+#define ECD_MCP23X17_IOCON                  0x0A          // Configuration register
+#define ECD_MCP23X17_OLATA                  0x14          // Output latch, port A
+#define ECD_MCP23X17_IOCON_HAEN             0x08          // SPI hardware address enable
+#define ECD_MCP23017_ADDRESS                0x20          // I2C address with A2..A0 = 0
+#define ECD_MCP23S17_OPCODE                 0x40          // SPI write opcode with A2..A0 = 0
+#define ECD_MCP23X17_FRAME_BYTES            6             // Address/opcode, register, 4 data bytes
+
+
+// ---------------------------------------------------------------------------
+// MCP23017 (I2C)
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_Mcp23017Bus
+ * @brief MCP23017 chips at I2C addresses 0x20 + chip.
+ */
+class ECD_Mcp23017Bus : public ECD_ExpanderBus {
+public:
+    ECD_Mcp23017Bus(TwoWire& t_wire, uint32_t t_clockHz = 400000)
+        : m_wire(t_wire), m_clockHz(t_clockHz) {}
+
+    void begin(uint8_t t_numberOfChips) override {
+        m_wire.begin();
+        m_wire.setClock(m_clockHz);
+        for (uint8_t chip = 0; chip < t_numberOfChips; chip++) {
+            writeChip(chip, 0x0000, 0x0000);
+        }
+    }
+
+    void writeChip(uint8_t t_chip, uint16_t t_level, uint16_t t_outputs) override {
+        m_wire.beginTransmission((uint8_t)(ECD_MCP23017_ADDRESS + t_chip));
+        m_wire.write((uint8_t)ECD_MCP23X17_OLATA);
+        m_wire.write((uint8_t)(t_level & 0xFF));
+        m_wire.write((uint8_t)(t_level >> 8));
+        m_wire.write((uint8_t)(~t_outputs & 0xFF));        // Wraps to IODIRA
+        m_wire.write((uint8_t)(~t_outputs >> 8));
+        m_wire.endTransmission();
+    }
+
+    /** @brief Start, 6 bytes with ACK, stop. */
+    unsigned long transactionMicros(void) const override {
+        return ((ECD_MCP23X17_FRAME_BYTES * 9 + 2) * 1000000UL) / m_clockHz;
+    }
+
+private:
+    TwoWire&  m_wire;
+    uint32_t  m_clockHz;
+};
+
+
+// ---------------------------------------------------------------------------
+// MCP23S17 (SPI)
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_Mcp23S17Bus
+ * @brief MCP23S17 chips sharing one chip select, hardware addresses 0..7.
+ */
+class ECD_Mcp23S17Bus : public ECD_ExpanderBus {
+public:
+    ECD_Mcp23S17Bus(SPIClass& t_spi, int t_csPin, uint32_t t_clockHz = 8000000)
+        : m_spi(t_spi), m_csPin(t_csPin), m_settings(t_clockHz, MSBFIRST, SPI_MODE0), m_clockHz(t_clockHz) {}
+
+    void begin(uint8_t t_numberOfChips) override {
+        ::pinMode(m_csPin, OUTPUT);
+        ::digitalWrite(m_csPin, HIGH);
+        m_spi.begin();
+
+        m_spi.beginTransaction(m_settings);                // Before HAEN every chip answers address 0
+        ::digitalWrite(m_csPin, LOW);
+        m_spi.transfer(ECD_MCP23S17_OPCODE);
+        m_spi.transfer(ECD_MCP23X17_IOCON);
+        m_spi.transfer(ECD_MCP23X17_IOCON_HAEN);
+        ::digitalWrite(m_csPin, HIGH);
+        m_spi.endTransaction();
+
+        for (uint8_t chip = 0; chip < t_numberOfChips; chip++) {
+            writeChip(chip, 0x0000, 0x0000);
+        }
+    }
+
+    void writeChip(uint8_t t_chip, uint16_t t_level, uint16_t t_outputs) override {
+        m_spi.beginTransaction(m_settings);
+        ::digitalWrite(m_csPin, LOW);
+        m_spi.transfer((uint8_t)(ECD_MCP23S17_OPCODE | (t_chip << 1)));
+        m_spi.transfer(ECD_MCP23X17_OLATA);
+        m_spi.transfer((uint8_t)(t_level & 0xFF));
+        m_spi.transfer((uint8_t)(t_level >> 8));
+        m_spi.transfer((uint8_t)(~t_outputs & 0xFF));      // Wraps to IODIRA
+        m_spi.transfer((uint8_t)(~t_outputs >> 8));
+        ::digitalWrite(m_csPin, HIGH);
+        m_spi.endTransaction();
+    }
+
+    /** @brief 6 bytes of 8 clocks, plus about 2 us of chip select handling. */
+    unsigned long transactionMicros(void) const override {
+        return ((ECD_MCP23X17_FRAME_BYTES * 8) * 1000000UL) / m_clockHz + 2;
+    }
+
+private:
+    SPIClass&    m_spi;
+    int          m_csPin;
+    SPISettings  m_settings;
+    uint32_t     m_clockHz;
+};
+
+#endif // _YNVISIBLE_ECD_EXPANDER_BUS
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
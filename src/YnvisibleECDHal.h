@@ -0,0 +1,288 @@
+
+/**
+ * @file YnvisibleECDHal.h
+ * @brief Hardware abstraction layer of the electrochromic driving engine.
+ *
+ * The engine (YNV_ECD) performs every CE/WE/ADC access and every wait through
+ * a backend object of type ECD_Hal, chosen at compile time, so all calls are
+ * resolved statically (no virtual dispatch) and inlined where possible.
+ *
+ * Backend interface:
+ *  - begin()                      One-time ADC/DAC setup
+ *  - pinMode() / digitalWrite()   Single WE pin access
+ *  - drivePins()                  Drive a group of WE pins to one level
+ *  - releasePins()                Set a group of WE pins to High-Z
+ *  - writeCounterElectrode()      CE DAC code / releaseCounterElectrode()
+ *  - scanAdc()                    Read the ADC of a group of WE pins
+ *  - compareAdc()                 One WE conversion against a window (refresh watch)
+ *  - millis() / delay()           Clock and blocking wait
+ *  - waitUntil()                  Wait for an absolute deadline (pulse end)
+ *  - setPhase()                   Engine phase hook (tracing)
+ *
+ * ECD_HalBase<Backend> implements the group operations and waitUntil() on top
+ * of the single-pin primitives of the backend (CRTP). A backend only
+ * overrides what its hardware does better, e.g. one port register write for
+ * a whole group.
+ *
+ * Backends (build flags):
+ *  - ECD_ArduinoHal    Default: Arduino core functions
+ *  - ECD_DriverV5Hal   YNV_ECD_HAL_DRIVER_V5: WE groups through PORT registers
+ *                      on SAMD cores, Arduino core otherwise
+ *  - ECD_SimulatorHal  YNV_ECD_SIMULATOR: YNV_ECD_Simulator when attached
+ *  - ECD_NoopHal       YNV_ECD_NOOP_HAL: no I/O (host micro-benchmarks)
+ *  - ECD_ExpanderHal   YNV_ECD_HAL_EXPANDER: WE pins on GPIO expanders, on top
+ *                      of one of the above (YnvisibleECDExpander.h)
+ *
+ * Notes:
+ *  - A group is a pin list plus a selection mask of any unsigned integer
+ *    type (bit i selects t_pins[i]); the loops stop after the highest
+ *    selected pin, so their cost follows the selection, not the display size.
+ *  - Group drives set the output level of every pin before enabling its
+ *    output, so no WE ever drives the opposite level for an instant.
+ *  - compareAdc() compares one conversion with the window in software: every
+ *    compare of the refresh watch is a conversion run and read by the CPU.
+ *    No backend offloads it to an ADC window monitor (e.g. SAMD WINCTRL).
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_HAL
+#define _YNVISIBLE_ECD_HAL
+
+#include "Arduino.h"
+
+
+// ---------------------------------------------------------------------------
+// Common Backend Base
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_HalBase
+ * @brief Group operations and deadline wait built on single-pin primitives.
+ *
+ * @tparam Backend Derived backend class (CRTP).
+ */
+template <class Backend>
+class ECD_HalBase {
+public:
+    /** @brief Drive the pins selected in t_select (bit i = t_pins[i]) to t_level. */
+    template <class Mask>
+    void drivePins(const int* t_pins, Mask t_select, int t_count, int t_level) {
+        for (int i = 0; i < t_count && t_select != 0; i++, t_select >>= 1) {
+            if (t_select & 1) {
+                backend().digitalWrite(t_pins[i], t_level);
+                backend().pinMode(t_pins[i], OUTPUT);
+            }
+        }
+    }
+
+    /** @brief Set all pins of a group to High-Z. */
+    void releasePins(const int* t_pins, int t_count) {
+        for (int i = 0; i < t_count; i++) {
+            backend().pinMode(t_pins[i], INPUT);
+        }
+    }
+
+    /** @brief Read the pins selected in t_select (bit i = t_pins[i]) into t_values[i]. */
+    template <class Mask, class Value>
+    void scanAdc(const int* t_pins, Mask t_select, int t_count, Value* t_values) {
+        for (int i = 0; i < t_count && t_select != 0; i++, t_select >>= 1) {
+            if (t_select & 1) {
+                t_values[i] = (Value)backend().readAdc(t_pins[i]);
+            }
+        }
+    }
+
+    /** @brief Read one pin into t_value; true if it is outside [t_low, t_high]. */
+    bool compareAdc(int t_pin, int t_low, int t_high, int& t_value) {
+        t_value = backend().readAdc(t_pin);
+        return t_value < t_low || t_value > t_high;
+    }
+
+    /** @brief Wait until millis() reaches t_deadlineMs (returns at once if past). */
+    void waitUntil(unsigned long t_deadlineMs) {
+        unsigned long now = backend().millis();
+        if ((long)(t_deadlineMs - now) > 0) {
+            backend().delay(t_deadlineMs - now);
+        }
+    }
+
+    void setPhase(int t_phase) { (void)t_phase; }
+
+private:
+    Backend& backend() { return *static_cast<Backend*>(this); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Arduino Core Backend
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_ArduinoHal
+ * @brief Portable backend on the Arduino core functions.
+ */
+class ECD_ArduinoHal : public ECD_HalBase<ECD_ArduinoHal> {
+public:
+    void begin(int t_resolution) {
+        analogReadResolution(t_resolution);
+        analogWriteResolution(t_resolution);
+    }
+
+    void pinMode(int t_pin, int t_mode)                   { ::pinMode(t_pin, t_mode); }
+    void digitalWrite(int t_pin, int t_level)             { ::digitalWrite(t_pin, t_level); }
+    int  readAdc(int t_pin)                               { return ::analogRead(t_pin); }
+    void writeCounterElectrode(int t_pin, int t_value)    { ::analogWrite(t_pin, t_value); }
+    void releaseCounterElectrode(int t_pin)               { ::pinMode(t_pin, INPUT); }
+    void delay(unsigned long t_ms)                        { ::delay(t_ms); }
+    unsigned long millis()                                { return ::millis(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Driver v5 Register-Level Backend
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_DriverV5Hal
+ * @brief Driver v5 backend: WE groups switched with one PORT write per port.
+ *
+ * On SAMD cores a group drive sets the level (OUTSET/OUTCLR) and then the
+ * direction (DIRSET) of all pins of a port at once, so the pulse starts at
+ * the same instant on every segment; a group release is one DIRCLR per port.
+ * The pin configuration is reset to plain GPIO first, as analogRead() hands
+ * the pin to the ADC mux. The CE DAC and the ADC keep the Arduino core
+ * functions (the CE settle time dominates them). Other cores use the Arduino
+ * backend behaviour.
+ */
+class ECD_DriverV5Hal : public ECD_ArduinoHal {
+public:
+#if defined(ARDUINO_ARCH_SAMD)
+    template <class Mask>
+    void drivePins(const int* t_pins, Mask t_select, int t_count, int t_level) {
+        uint32_t portMask[PORT_GROUPS] = {0};
+
+        for (int i = 0; i < t_count && t_select != 0; i++, t_select >>= 1) {
+            if (t_select & 1) {
+                const PinDescription& pin = g_APinDescription[t_pins[i]];
+                PORT->Group[pin.ulPort].PINCFG[pin.ulPin].reg = PORT_PINCFG_INEN;  // GPIO, no pull, no mux
+                portMask[pin.ulPort] |= (1ul << pin.ulPin);
+            }
+        }
+        for (int port = 0; port < PORT_GROUPS; port++) {
+            if (portMask[port] != 0) {
+                if (t_level) { PORT->Group[port].OUTSET.reg = portMask[port]; }
+                else         { PORT->Group[port].OUTCLR.reg = portMask[port]; }
+                PORT->Group[port].DIRSET.reg = portMask[port];
+            }
+        }
+    }
+
+    void releasePins(const int* t_pins, int t_count) {
+        uint32_t portMask[PORT_GROUPS] = {0};
+
+        for (int i = 0; i < t_count; i++) {
+            const PinDescription& pin = g_APinDescription[t_pins[i]];
+            portMask[pin.ulPort] |= (1ul << pin.ulPin);
+        }
+        for (int port = 0; port < PORT_GROUPS; port++) {
+            if (portMask[port] != 0) {
+                PORT->Group[port].DIRCLR.reg = portMask[port];
+            }
+        }
+    }
+#endif
+};
+
+
+// ---------------------------------------------------------------------------
+// No-Op Backend (host micro-benchmarks)
+// ---------------------------------------------------------------------------
+
+#ifdef YNV_ECD_NOOP_HAL
+extern int ynvNoopHalReading;                             // ADC code returned by the no-op HAL (host micro-benchmarks)
+#endif
+
+/**
+ * @class ECD_NoopHal
+ * @brief Backend without I/O: delays return at once, ADC reads return
+ * ynvNoopHalReading. Only the CPU-side work of the engine remains.
+ */
+class ECD_NoopHal : public ECD_HalBase<ECD_NoopHal> {
+public:
+    void begin(int t_resolution)                          { (void)t_resolution; }
+    void pinMode(int t_pin, int t_mode)                   { (void)t_pin; (void)t_mode; }
+    void digitalWrite(int t_pin, int t_level)             { (void)t_pin; (void)t_level; }
+    void writeCounterElectrode(int t_pin, int t_value)    { (void)t_pin; (void)t_value; }
+    void releaseCounterElectrode(int t_pin)               { (void)t_pin; }
+    void delay(unsigned long t_ms)                        { (void)t_ms; }
+    unsigned long millis()                                { return 0; }
+#ifdef YNV_ECD_NOOP_HAL
+    int  readAdc(int t_pin)                               { (void)t_pin; return ynvNoopHalReading; }
+#else
+    int  readAdc(int t_pin)                               { (void)t_pin; return 0; }
+#endif
+};
+
+
+// ---------------------------------------------------------------------------
+// Simulator Backend (host builds)
+// ---------------------------------------------------------------------------
+
+#ifdef YNV_ECD_SIMULATOR
+class YNV_ECD_Simulator;
+
+/**
+ * @class ECD_SimulatorHal
+ * @brief Routes I/O to an attached YNV_ECD_Simulator, or to the Arduino core
+ * when none is attached. Implemented in YnvisibleECDSimulator.cpp.
+ */
+class ECD_SimulatorHal : public ECD_HalBase<ECD_SimulatorHal> {
+public:
+    void attach(YNV_ECD_Simulator* t_simulator)           { m_simulator = t_simulator; }
+    YNV_ECD_Simulator* simulator() const                  { return m_simulator; }
+
+    void begin(int t_resolution);
+    void pinMode(int t_pin, int t_mode);
+    void digitalWrite(int t_pin, int t_level);
+    int  readAdc(int t_pin);
+    bool compareAdc(int t_pin, int t_low, int t_high, int& t_value);
+    void writeCounterElectrode(int t_pin, int t_value);
+    void releaseCounterElectrode(int t_pin);
+    void delay(unsigned long t_ms);
+    unsigned long millis();
+    void setPhase(int t_phase);
+
+private:
+    YNV_ECD_Simulator* m_simulator {nullptr};
+};
+#endif
+
+
+// ---------------------------------------------------------------------------
+// Backend Selection
+// ---------------------------------------------------------------------------
+
+#if defined(YNV_ECD_SIMULATOR)
+typedef ECD_SimulatorHal    ECD_BoardHal;
+#elif defined(YNV_ECD_NOOP_HAL)
+typedef ECD_NoopHal         ECD_BoardHal;
+#elif defined(YNV_ECD_HAL_DRIVER_V5)
+typedef ECD_DriverV5Hal     ECD_BoardHal;
+#else
+typedef ECD_ArduinoHal      ECD_BoardHal;
+#endif
+
+#ifdef YNV_ECD_HAL_EXPANDER
+#include "YnvisibleECDExpander.h"
+typedef ECD_ExpanderHal<ECD_BoardHal> ECD_Hal;
+#else
+typedef ECD_BoardHal        ECD_Hal;
+#endif
+
+#endif // _YNVISIBLE_ECD_HAL
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
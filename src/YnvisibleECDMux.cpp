@@ -0,0 +1,242 @@
+
+/**
+ * @file YnvisibleECDMux.cpp
+ * @brief OCP sensing of expander pins through external analog multiplexers.
+ *
+ * This file implements the ECD_AnalogMux class declared in YnvisibleECDMux.h:
+ * pin to mux/channel mapping, the Gray-code channel schedule of a group scan
+ * and the select line, settle and ADC accesses. In simulator builds it also
+ * implements ECD_SimAnalogMux (YnvisibleECDSimulator.h), so host tools that
+ * do not use the muxes link without this file.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include "Arduino.h"
+#include "YnvisibleECDMux.h"
+
+#ifdef YNV_ECD_SIMULATOR
+#include "YnvisibleECDSimulator.h"
+#endif
+
+
+/***************************************************************************/
+/******************************** HELPERS **********************************/
+/***************************************************************************/
+
+static uint8_t grayCode(uint8_t t_rank)                           // Channel at a rank of the Gray sequence
+{
+  return t_rank ^ (t_rank >> 1);
+}
+
+static uint8_t grayRank(uint8_t t_code)                           // Rank of a channel in the Gray sequence
+{
+  uint8_t rank = t_code;
+  rank ^= rank >> 1;
+  rank ^= rank >> 2;
+  rank ^= rank >> 4;
+  return rank;
+}
+
+
+/***************************************************************************/
+/**************************** PUBLIC FUNCTIONS *****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Analog muxes with shared select lines.
+ *
+ * @param t_selectPins t_selectBits select pins, S0 first (kept, not copied)
+ * @param t_selectBits Select lines (1..ECD_MUX_MAX_SELECT_BITS)
+ * @param t_adcPins ADC input of each mux (kept, not copied)
+ * @param t_numberOfMuxes Muxes (1..ECD_MUX_MAX_MUXES)
+ * @param t_settleMicros (us) Settle time after a channel switch
+ */
+/***************************************************************************/
+
+ECD_AnalogMux::ECD_AnalogMux(const int* t_selectPins, uint8_t t_selectBits, const int* t_adcPins, uint8_t t_numberOfMuxes,
+                             unsigned int t_settleMicros)
+  : m_selectPins(t_selectPins), m_adcPins(t_adcPins), m_settleMicros(t_settleMicros)
+{
+  m_selectBits    = constrain(t_selectBits, 1, ECD_MUX_MAX_SELECT_BITS);
+  m_numberOfMuxes = constrain(t_numberOfMuxes, 1, ECD_MUX_MAX_MUXES);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Configure the select lines and connect channel 0.
+ */
+/***************************************************************************/
+
+void ECD_AnalogMux::begin()
+{
+  for (uint8_t line = 0; line < m_selectBits; line++) {
+    if (m_selectPins != nullptr) {
+      ::pinMode(m_selectPins[line], OUTPUT);
+    }
+    writeSelect(line, LOW);
+  }
+  m_channel = 0;
+  m_ready   = true;
+  settle(m_settleMicros);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief OCP of one expander pin (0 for pins outside the muxes).
+ */
+/***************************************************************************/
+
+int ECD_AnalogMux::read(int t_pin)
+{
+  uint8_t mux, channel;
+
+  if (!locate(t_pin, mux, channel)) {
+    return 0;
+  }
+  if (!m_ready) {
+    begin();
+  }
+  selectChannel(channel);
+  m_stats.reads++;
+  return readInput(mux);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Scan a group: each needed channel is selected once, in Gray-code
+ * order from the current channel, and read on every mux that needs it.
+ */
+/***************************************************************************/
+
+void ECD_AnalogMux::scan(const int* t_pins, const uint8_t* t_indices, int t_count, uint16_t* t_values)
+{
+  uint8_t neededMuxes[ECD_MUX_MAX_CHANNELS] = {0};                // Muxes to read on each channel (bit per mux)
+  uint8_t valueIndex[ECD_MUX_MAX_CHANNELS][ECD_MUX_MAX_MUXES];    // Display index read on each mux/channel
+  uint8_t mux, channel;
+
+  if (!m_ready) {
+    begin();
+  }
+
+  for (int k = 0; k < t_count; k++) {
+    if (locate(t_pins[t_indices[k]], mux, channel)) {
+      neededMuxes[channel]      |= (uint8_t)(1u << mux);
+      valueIndex[channel][mux]   = t_indices[k];
+    } else {
+      t_values[t_indices[k]] = 0;
+    }
+  }
+
+  uint8_t channels = getChannels();
+  uint8_t start    = grayRank(m_channel);
+
+  for (uint8_t step = 0; step < channels; step++) {
+    channel = grayCode((uint8_t)((start + step) & (channels - 1)));
+    if (neededMuxes[channel] == 0) {
+      continue;
+    }
+    selectChannel(channel);
+    for (mux = 0; mux < m_numberOfMuxes; mux++) {                 // One settle, then every mux back to back
+      if (neededMuxes[channel] & (1u << mux)) {
+        t_values[valueIndex[channel][mux]] = (uint16_t)readInput(mux);
+        m_stats.reads++;
+      }
+    }
+  }
+  m_stats.scans++;
+}
+
+
+/***************************************************************************/
+/*************************** PROTECTED FUNCTIONS ***************************/
+/***************************************************************************/
+
+void ECD_AnalogMux::writeSelect(uint8_t t_line, int t_level)
+{
+  ::digitalWrite(m_selectPins[t_line], t_level);
+}
+
+void ECD_AnalogMux::settle(unsigned int t_micros)
+{
+  ::delayMicroseconds(t_micros);
+}
+
+int ECD_AnalogMux::readInput(uint8_t t_mux)
+{
+  return ::analogRead(m_adcPins[t_mux]);
+}
+
+
+/***************************************************************************/
+/**************************** PRIVATE FUNCTIONS ****************************/
+/***************************************************************************/
+
+bool ECD_AnalogMux::locate(int t_pin, uint8_t& t_mux, uint8_t& t_channel) const
+{
+  if (t_pin < ECD_EXPANDER_PIN_BASE) {
+    return false;
+  }
+  int index = t_pin - ECD_EXPANDER_PIN_BASE;
+  if ((index >> m_selectBits) >= m_numberOfMuxes) {
+    return false;
+  }
+  t_mux     = (uint8_t)(index >> m_selectBits);
+  t_channel = (uint8_t)(index & (getChannels() - 1));
+  return true;
+}
+
+void ECD_AnalogMux::selectChannel(uint8_t t_channel)
+{
+  uint8_t changes = t_channel ^ m_channel;
+
+  if (changes == 0) {                                             // Already connected and settled
+    return;
+  }
+  for (uint8_t line = 0; line < m_selectBits; line++) {
+    if (changes & (1u << line)) {
+      writeSelect(line, (t_channel & (1u << line)) ? HIGH : LOW);
+      m_stats.selectToggles++;
+    }
+  }
+  m_channel = t_channel;
+  m_stats.channelSwitches++;
+  m_stats.settleMicros += m_settleMicros;
+  settle(m_settleMicros);
+}
+
+
+#ifdef YNV_ECD_SIMULATOR
+
+/***************************************************************************/
+/*************************** ECD_SimAnalogMux ******************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Simulated analog muxes on the expander pins of a simulator.
+ */
+/***************************************************************************/
+
+ECD_SimAnalogMux::ECD_SimAnalogMux(YNV_ECD_Simulator& t_simulator, uint8_t t_selectBits, uint8_t t_numberOfMuxes,
+                                   unsigned int t_settleMicros)
+  : ECD_AnalogMux(nullptr, t_selectBits, nullptr, t_numberOfMuxes, t_settleMicros),
+    m_simulator(t_simulator)
+{
+}
+
+int ECD_SimAnalogMux::readInput(uint8_t t_mux)
+{
+  return m_simulator.analogRead(ECD_EXPANDER_PIN_BASE + t_mux * getChannels() + selectedChannel());
+}
+
+#endif // YNV_ECD_SIMULATOR
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,111 @@
+
+/**
+ * @file YnvisibleECDMux.h
+ * @brief OCP sensing of expander pins through external analog multiplexers.
+ *
+ * Expander outputs have no ADC, so on expanded panels each WE is also wired
+ * to a channel of an analog mux (e.g. CD74HC4067, 16:1) whose common output
+ * goes to an ADC input of the board. ECD_AnalogMux is an ECD_OcpSensor for
+ * ECD_ExpanderHal::setOcpSensor().
+ *
+ * Wiring:
+ *  - Expander pin ECD_EXPANDER_PIN_BASE + n is channel n % channels of mux
+ *    n / channels (channels = 2^selectBits). With 16:1 muxes, output b of
+ *    expander c is channel b of mux c.
+ *  - All muxes share the select lines; each mux has its own ADC input.
+ *
+ * Scan schedule:
+ *  - Selecting a channel connects it on every mux at once, so one settle time
+ *    serves all muxes, whose ADC inputs are then read back to back.
+ *  - Needed channels are visited in Gray-code order starting from the
+ *    channel already selected: one select line toggles per step, and the
+ *    first step is free when the current channel is needed.
+ *  - A sweep costs (needed channels x settle) + (segments x ADC read), so
+ *    the mux overhead of a 64-segment panel on four 16:1 muxes is 16 settle
+ *    times, against the 50 ms CE settle of every check_refresh().
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_MUX
+#define _YNVISIBLE_ECD_MUX
+
+#include "Arduino.h"
+#include "YnvisibleECDExpander.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_MUX_MAX_SELECT_BITS             4             // Up to 16:1 muxes
+#define ECD_MUX_MAX_CHANNELS                (1 << ECD_MUX_MAX_SELECT_BITS)
+#define ECD_MUX_MAX_MUXES                   8             // Muxes (ADC inputs) per sensor
+#define ECD_MUX_DEFAULT_SETTLE_US           10            // (us) Default settle time after a channel switch
+
+
+/**
+ * @brief Activity of an ECD_AnalogMux since resetMuxStats().
+ */
+struct ECD_MuxStats {
+
+    unsigned long scans                     { 0 };                              // Group scans
+    unsigned long channelSwitches           { 0 };                              // Channel changes (one settle each)
+    unsigned long selectToggles             { 0 };                              // Select line transitions
+    unsigned long reads                     { 0 };                              // ADC reads
+    unsigned long settleMicros              { 0 };                              // (us) Time spent settling
+};
+
+
+// ---------------------------------------------------------------------------
+// Analog Multiplexer Sensor
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_AnalogMux
+ * @brief Muxes with shared select lines, one ADC input each.
+ *
+ * The pin accesses are virtual so a simulated mux (ECD_SimAnalogMux) can
+ * replace them; the schedule stays the same.
+ */
+class ECD_AnalogMux : public ECD_OcpSensor {
+public:
+    ECD_AnalogMux(const int* t_selectPins, uint8_t t_selectBits, const int* t_adcPins, uint8_t t_numberOfMuxes,
+                  unsigned int t_settleMicros = ECD_MUX_DEFAULT_SETTLE_US);
+
+    void begin(void);                                               ///< Select lines as outputs, channel 0 (called by the first read)
+    int  read(int t_pin) override;                                  ///< OCP of one expander pin
+    void scan(const int* t_pins, const uint8_t* t_indices, int t_count, uint16_t* t_values) override; ///< Scheduled group scan
+
+    void setSettleMicros(unsigned int t_micros) { m_settleMicros = t_micros; } ///< Settle time after a channel switch
+    uint8_t getChannels(void) const { return (uint8_t)(1u << m_selectBits); }  ///< Channels per mux
+    const ECD_MuxStats& getMuxStats(void) const { return m_stats; } ///< Scan statistics
+    void resetMuxStats(void) { m_stats = ECD_MuxStats(); }          ///< Clear scan statistics
+
+protected:
+    virtual void writeSelect(uint8_t t_line, int t_level);          ///< Drive one select line
+    virtual void settle(unsigned int t_micros);                     ///< Wait for the mux output to settle
+    virtual int  readInput(uint8_t t_mux);                          ///< ADC reading of a mux output
+
+    uint8_t selectedChannel(void) const { return m_channel; }       ///< Channel connected on every mux
+
+private:
+    bool locate(int t_pin, uint8_t& t_mux, uint8_t& t_channel) const; ///< Mux and channel of an expander pin
+    void selectChannel(uint8_t t_channel);                          ///< Toggle the select lines that differ, then settle
+
+    const int*    m_selectPins;
+    const int*    m_adcPins;
+    uint8_t       m_selectBits;
+    uint8_t       m_numberOfMuxes;
+    unsigned int  m_settleMicros;
+    uint8_t       m_channel             {0};
+    bool          m_ready               {false};
+    ECD_MuxStats  m_stats;
+};
+
+#endif // _YNVISIBLE_ECD_MUX
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,430 @@
+
+/**
+ * @file YnvisibleECDQueue.cpp
+ * @brief Thread-safe command queue in front of one YNV_ECD display.
+ *
+ * This file implements the ECD_CommandQueue class declared in
+ * YnvisibleECDQueue.h: the bounded FIFO shared by the producers, the owner
+ * side that applies the commands to the display, and the status queries.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include "Arduino.h"
+#include "YnvisibleECDQueue.h"
+
+
+// ---------------------------------------------------------------------------
+// Queue Lock
+// ---------------------------------------------------------------------------
+
+// ECD_QUEUE_LOCK() opens a critical section in the current block, closed by
+// ECD_QUEUE_UNLOCK() on every path; ECD_QUEUE_NOTIFY() wakes host waiters.
+#if defined(YNV_ECD_HOST_THREADS)
+#define ECD_QUEUE_LOCK()        std::unique_lock<std::mutex> queueLock(m_mutex)
+#define ECD_QUEUE_UNLOCK()      queueLock.unlock()
+#define ECD_QUEUE_NOTIFY()      m_changed.notify_all()
+#elif defined(ARDUINO_ARCH_SAMD)
+#define ECD_QUEUE_LOCK()        uint32_t queuePrimask = __get_PRIMASK(); __disable_irq()   // Nests in ISRs
+#define ECD_QUEUE_UNLOCK()      __set_PRIMASK(queuePrimask)
+#define ECD_QUEUE_NOTIFY()
+#elif defined(__AVR__)
+#define ECD_QUEUE_LOCK()        uint8_t queueSreg = SREG; cli()                          // Nests in ISRs
+#define ECD_QUEUE_UNLOCK()      SREG = queueSreg
+#define ECD_QUEUE_NOTIFY()
+#else
+#define ECD_QUEUE_LOCK()        noInterrupts()
+#define ECD_QUEUE_UNLOCK()      interrupts()
+#define ECD_QUEUE_NOTIFY()
+#endif
+
+
+/***************************************************************************/
+/**************************** PUBLIC FUNCTIONS *****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Command queue of one display.
+ *
+ * @param t_display Display driven by the owner of the queue
+ * @param t_storage t_capacity commands (kept, not copied)
+ * @param t_capacity Queue size (1..255)
+ */
+/***************************************************************************/
+
+ECD_CommandQueue::ECD_CommandQueue(YNV_ECD& t_display, ECD_Command* t_storage, uint8_t t_capacity)
+  : m_display(t_display), m_storage(t_storage), m_capacity(t_capacity)
+{
+  if (m_capacity == 0) {
+    m_capacity = 1;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set the selected segments (bit i of t_states: 1 = color) and update
+ * the display. Unselected segments keep their requested state; the changes
+ * of the segments in t_urgent are applied by the latency-first phase
+ * (SEGMENT_PRIORITY_HIGH, see YNV_ECD::setSegmentState()).
+ *
+ * @return Command id, 0 if the queue is full
+ */
+/***************************************************************************/
+
+uint32_t ECD_CommandQueue::postFrame(ecdSegmentMask_t t_states, ecdSegmentMask_t t_select, ecdSegmentMask_t t_urgent)
+{
+  return post(ECD_CMD_FRAME, t_states, t_select, t_urgent);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Stage one segment state; the display changes at the next frame or
+ * postExecute().
+ *
+ * @return Command id, 0 if the queue is full or the segment does not exist
+ */
+/***************************************************************************/
+
+uint32_t ECD_CommandQueue::postSegment(int t_segment, bool t_state)
+{
+  if (t_segment < 0 || t_segment >= m_display.getNumberOfSegments()) {
+    ECD_QUEUE_LOCK();
+    m_stats.rejected++;
+    ECD_QUEUE_UNLOCK();
+    return 0;
+  }
+  ecdSegmentMask_t bit = (ecdSegmentMask_t)1 << t_segment;
+  return post(ECD_CMD_SEGMENT, t_state ? bit : 0, bit);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Update the display (executeDisplay()).
+ *
+ * @return Command id, 0 if the queue is full
+ */
+/***************************************************************************/
+
+uint32_t ECD_CommandQueue::postExecute()
+{
+  return post(ECD_CMD_EXECUTE, 0, 0);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Initialize the display (begin()).
+ *
+ * @return Command id, 0 if the queue is full
+ */
+/***************************************************************************/
+
+uint32_t ECD_CommandQueue::postBegin()
+{
+  return post(ECD_CMD_BEGIN, 0, 0);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Drop every queued command and stop the running one.
+ *
+ * Dropped commands stay in the queue marked cancelled, so the owner still
+ * reports them in order; the running update is stopped with the stop flag
+ * of the display and ends at its next checkpoint (segments released, CE
+ * High-Z). Commands posted afterwards run normally.
+ *
+ * @return Number of commands dropped or stopped
+ */
+/***************************************************************************/
+
+int ECD_CommandQueue::cancel()
+{
+  int cancelled = 0;
+
+  ECD_QUEUE_LOCK();
+  for (uint8_t k = 0; k < m_count; k++) {
+    ECD_Command& command = m_storage[(m_head + k) % m_capacity];
+    if (!command.cancelled) {
+      command.cancelled = true;
+      cancelled++;
+    }
+  }
+  if (m_runningId != 0 && !m_runningCancelled) {
+    m_runningCancelled = true;
+    m_display.setStopDrivingFlag();
+    cancelled++;
+  }
+  ECD_QUEUE_UNLOCK();
+  return cancelled;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Owner: run the oldest command and report it.
+ *
+ * The stop flag of the display is cleared before each command that runs,
+ * so a cancel() only stops the command it hit.
+ *
+ * @return true if a command was dequeued
+ */
+/***************************************************************************/
+
+bool ECD_CommandQueue::process()
+{
+  ECD_Command command;
+  bool        completed;
+
+  {
+    ECD_QUEUE_LOCK();
+    if (m_count == 0) {
+      ECD_QUEUE_UNLOCK();
+      return false;
+    }
+    command = m_storage[m_head];
+    m_head  = (uint8_t)((m_head + 1) % m_capacity);
+    m_count--;
+    m_runningId        = command.id;
+    m_runningCancelled = command.cancelled;
+    if (!command.cancelled) {
+      m_display.clearStopDriving();
+    }
+    ECD_QUEUE_UNLOCK();
+  }
+
+  if (!command.cancelled) {
+    run(command);
+  }
+
+  {
+    ECD_QUEUE_LOCK();
+    completed     = !m_runningCancelled;
+    m_runningId   = 0;
+    m_completedId = command.id;
+    if (completed) {
+      m_stats.executed++;
+    } else {
+      m_stats.cancelled++;
+    }
+    ECD_QUEUE_UNLOCK();
+  }
+  ECD_QUEUE_NOTIFY();
+
+  if (m_callback != nullptr) {
+    m_callback(command, completed, m_callbackContext);
+  }
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Owner: run commands until the queue is empty.
+ *
+ * @return Number of commands dequeued
+ */
+/***************************************************************************/
+
+int ECD_CommandQueue::processAll()
+{
+  int processed = 0;
+
+  while (process()) {
+    processed++;
+  }
+  return processed;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Completion callback, called by the owner (inside process()) after
+ * each command. Set it before the owner starts.
+ */
+/***************************************************************************/
+
+void ECD_CommandQueue::setCallback(ecdCommandCallback_t t_callback, void* t_context)
+{
+  m_callback        = t_callback;
+  m_callbackContext = t_context;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Status of a command id (ecdCommandStatus_e). Commands finish in
+ * posting order, so every id up to getCompletedId() is finished.
+ */
+/***************************************************************************/
+
+uint8_t ECD_CommandQueue::getStatus(uint32_t t_id) const
+{
+  uint8_t status;
+
+  ECD_QUEUE_LOCK();
+  if (t_id == 0 || t_id >= m_nextId) {
+    status = ECD_CMD_STATUS_UNKNOWN;
+  } else if (t_id <= m_completedId) {
+    status = ECD_CMD_STATUS_FINISHED;
+  } else if (t_id == m_runningId) {
+    status = ECD_CMD_STATUS_RUNNING;
+  } else {
+    status = ECD_CMD_STATUS_QUEUED;
+  }
+  ECD_QUEUE_UNLOCK();
+  return status;
+}
+
+
+uint32_t ECD_CommandQueue::getCompletedId() const
+{
+  uint32_t id;
+
+  ECD_QUEUE_LOCK();
+  id = m_completedId;
+  ECD_QUEUE_UNLOCK();
+  return id;
+}
+
+
+int ECD_CommandQueue::getDepth() const
+{
+  int depth;
+
+  ECD_QUEUE_LOCK();
+  depth = m_count;
+  ECD_QUEUE_UNLOCK();
+  return depth;
+}
+
+
+ECD_QueueStats ECD_CommandQueue::getStats() const
+{
+  ECD_QueueStats stats;
+
+  ECD_QUEUE_LOCK();
+  stats = m_stats;
+  ECD_QUEUE_UNLOCK();
+  return stats;
+}
+
+
+void ECD_CommandQueue::resetStats()
+{
+  ECD_QUEUE_LOCK();
+  m_stats = ECD_QueueStats();
+  ECD_QUEUE_UNLOCK();
+}
+
+
+#ifdef YNV_ECD_HOST_THREADS
+
+/***************************************************************************/
+/**
+ * @brief Owner (host): block until a command is queued.
+ *
+ * @return true if a command is queued, false on timeout
+ */
+/***************************************************************************/
+
+bool ECD_CommandQueue::waitForWork(unsigned long t_timeoutMs)
+{
+  std::unique_lock<std::mutex> queueLock(m_mutex);
+  return m_changed.wait_for(queueLock, std::chrono::milliseconds(t_timeoutMs), [this] { return m_count > 0; });
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Producer (host): block until a command finished.
+ *
+ * @return true if command t_id finished, false on timeout
+ */
+/***************************************************************************/
+
+bool ECD_CommandQueue::waitForCompletion(uint32_t t_id, unsigned long t_timeoutMs)
+{
+  std::unique_lock<std::mutex> queueLock(m_mutex);
+  return m_changed.wait_for(queueLock, std::chrono::milliseconds(t_timeoutMs), [this, t_id] { return m_completedId >= t_id; });
+}
+
+#endif // YNV_ECD_HOST_THREADS
+
+
+/***************************************************************************/
+/**************************** PRIVATE FUNCTIONS ****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Append one command.
+ *
+ * @return Command id, 0 if the queue is full
+ */
+/***************************************************************************/
+
+uint32_t ECD_CommandQueue::post(uint8_t t_type, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select, ecdSegmentMask_t t_urgent)
+{
+  uint32_t id = 0;
+
+  {
+    ECD_QUEUE_LOCK();
+    if (m_count < m_capacity) {
+      ECD_Command& command = m_storage[(m_head + m_count) % m_capacity];
+      command.id        = m_nextId++;
+      command.type      = t_type;
+      command.cancelled = false;
+      command.states    = t_states & t_select;
+      command.select    = t_select;
+      command.urgent    = t_urgent & t_select;
+      id = command.id;
+      m_count++;
+      m_stats.posted++;
+      if (m_count > m_stats.maxDepth) {
+        m_stats.maxDepth = m_count;
+      }
+    } else {
+      m_stats.rejected++;
+    }
+    ECD_QUEUE_UNLOCK();
+  }
+  if (id != 0) {
+    ECD_QUEUE_NOTIFY();
+  }
+  return id;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Owner: apply a command to the display.
+ */
+/***************************************************************************/
+
+void ECD_CommandQueue::run(const ECD_Command& t_command)
+{
+  if (t_command.type == ECD_CMD_FRAME || t_command.type == ECD_CMD_SEGMENT) {
+    ecdSegmentMask_t select = t_command.select;
+    for (int i = 0; i < m_display.getNumberOfSegments() && select != 0; i++, select >>= 1) {
+      if (select & 1) {
+        m_display.setSegmentState(i, ((t_command.states >> i) & 1) != 0,
+                                  ((t_command.urgent >> i) & 1) ? SEGMENT_PRIORITY_HIGH : SEGMENT_PRIORITY_NORMAL);
+      }
+    }
+  }
+  if (t_command.type == ECD_CMD_FRAME || t_command.type == ECD_CMD_EXECUTE) {
+    m_display.executeDisplay();
+  } else if (t_command.type == ECD_CMD_BEGIN) {
+    m_display.begin();
+  }
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,191 @@
+
+/**
+ * @file YnvisibleECDQueue.h
+ * @brief Thread-safe command queue in front of one YNV_ECD display.
+ *
+ * Lets the display engine run in its own RTOS task, on a second core or in a
+ * host thread while other tasks post frames:
+ *  - Producers (any task, thread or ISR) post commands into a bounded FIFO;
+ *    a full queue rejects the command (post returns 0), nothing blocks.
+ *  - One owner runs process() and is the only caller of the YNV_ECD and its
+ *    hardware backend once the queue is in use.
+ *  - Every command gets an id; its status is queried with getStatus(), and
+ *    the owner reports each finished command to an optional callback.
+ *  - cancel() drops the queued commands and stops the running update through
+ *    the stop flag of the display (executeDisplay() returns early).
+ *
+ * Locking:
+ *  - Host builds (YNV_ECD_SIMULATOR / YNV_ECD_NOOP_HAL): std::mutex, plus
+ *    waitForWork() / waitForCompletion() on a condition variable.
+ *  - MCU builds: a short interrupt critical section around the queue indices
+ *    (single core, producers in tasks or ISRs). A port to a dual-core MCU
+ *    replaces ECD_QUEUE_LOCK / ECD_QUEUE_UNLOCK (YnvisibleECDQueue.cpp) with a
+ *    spinlock shared by both cores.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_QUEUE
+#define _YNVISIBLE_ECD_QUEUE
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+
+#ifdef YNV_ECD_HOST_THREADS
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+
+// ---------------------------------------------------------------------------
+// Commands
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Command types of the queue.
+ */
+enum ecdCommand_e {
+    ECD_CMD_FRAME   = 0,    // Stage the selected segment states, then executeDisplay()
+    ECD_CMD_SEGMENT = 1,    // Stage the selected segment states only
+    ECD_CMD_EXECUTE = 2,    // executeDisplay() (e.g. after ECD_CMD_SEGMENT commands)
+    ECD_CMD_BEGIN   = 3     // begin()
+};
+
+/**
+ * @brief Status of a command id (getStatus()).
+ */
+enum ecdCommandStatus_e {
+    ECD_CMD_STATUS_UNKNOWN   = 0,   // Never posted (or rejected)
+    ECD_CMD_STATUS_QUEUED    = 1,   // Waiting in the queue
+    ECD_CMD_STATUS_RUNNING   = 2,   // Being processed by the owner
+    ECD_CMD_STATUS_FINISHED  = 3    // Done or cancelled (the callback tells which)
+};
+
+/**
+ * @brief One queued command.
+ */
+struct ECD_Command {
+
+    uint32_t         id                     { 0 };                              // Queue-wide id, from 1 in posting order
+    uint8_t          type                   { ECD_CMD_EXECUTE };                // ecdCommand_e
+    bool             cancelled              { false };                          // Dropped by cancel(), reported but not run
+    ecdSegmentMask_t states                 { 0 };                              // Requested state of each selected segment (1 = color)
+    ecdSegmentMask_t select                 { 0 };                              // Segments staged by the command
+    ecdSegmentMask_t urgent                 { 0 };                              // Selected segments staged with SEGMENT_PRIORITY_HIGH
+};
+
+/**
+ * @brief Queue counters since construction or the last resetStats() call.
+ */
+struct ECD_QueueStats {
+
+    unsigned long posted                    { 0 };                              // Commands accepted
+    unsigned long rejected                  { 0 };                              // Posts refused (queue full, bad segment)
+    unsigned long executed                  { 0 };                              // Commands run to completion
+    unsigned long cancelled                 { 0 };                              // Commands dropped or stopped by cancel()
+    unsigned int  maxDepth                  { 0 };                              // Highest number of queued commands
+};
+
+/**
+ * @brief Completion callback, called by the owner after each command.
+ * t_completed is false for a command dropped or stopped by cancel().
+ */
+typedef void (*ecdCommandCallback_t)(const ECD_Command& t_command, bool t_completed, void* t_context);
+
+
+// ---------------------------------------------------------------------------
+// Command Queue
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_CommandQueue
+ * @brief Bounded command FIFO with a single owner driving one display.
+ *
+ * The command storage is provided by the caller (or by
+ * ECD_CommandQueueSized<n>) and must outlive the queue.
+ */
+class ECD_CommandQueue {
+public:
+    ECD_CommandQueue(YNV_ECD& t_display, ECD_Command* t_storage, uint8_t t_capacity);
+    ECD_CommandQueue(const ECD_CommandQueue&) = delete;
+    ECD_CommandQueue& operator=(const ECD_CommandQueue&) = delete;
+
+    // Producers (any task, thread or ISR): return the command id, 0 if rejected
+    uint32_t postFrame(ecdSegmentMask_t t_states, ecdSegmentMask_t t_select = ~(ecdSegmentMask_t)0,
+                       ecdSegmentMask_t t_urgent = 0);           ///< Set the selected segments and update (t_urgent: latency-first changes)
+    uint32_t postSegment(int t_segment, bool t_state);              ///< Stage one segment, no update
+    uint32_t postExecute(void);                                     ///< Update the display
+    uint32_t postBegin(void);                                       ///< Initialize the display
+    int      cancel(void);                                          ///< Drop queued commands, stop the running one; returns the count
+
+    // Owner
+    bool     process(void);                                         ///< Run the next command, false if none was queued
+    int      processAll(void);                                      ///< Run until the queue is empty, returns the count
+    void     setCallback(ecdCommandCallback_t t_callback, void* t_context = nullptr); ///< Owner-side completion callback
+
+    // Status (any context)
+    uint8_t  getStatus(uint32_t t_id) const;                        ///< ecdCommandStatus_e of a command id
+    uint32_t getCompletedId(void) const;                            ///< Id of the last finished command (0 = none)
+    int      getDepth(void) const;                                  ///< Queued commands
+    uint8_t  getCapacity(void) const { return m_capacity; }         ///< Queue size
+    ECD_QueueStats getStats(void) const;                            ///< Copy of the queue counters
+    void     resetStats(void);                                      ///< Clear the queue counters
+#ifdef YNV_ECD_HOST_THREADS
+    bool     waitForWork(unsigned long t_timeoutMs);                ///< Owner: block until a command is queued (host only)
+    bool     waitForCompletion(uint32_t t_id, unsigned long t_timeoutMs); ///< Block until a command finished (host only)
+#endif
+
+private:
+    uint32_t post(uint8_t t_type, ecdSegmentMask_t t_states, ecdSegmentMask_t t_select, ecdSegmentMask_t t_urgent = 0); ///< Append one command
+    void     run(const ECD_Command& t_command);                     ///< Apply a command to the display (owner)
+
+    YNV_ECD&      m_display;
+    ECD_Command*  m_storage;
+    uint8_t       m_capacity;
+    uint8_t       m_head                    {0};                    // Oldest queued command
+    uint8_t       m_count                   {0};                    // Queued commands
+    uint32_t      m_nextId                  {1};
+    uint32_t      m_runningId               {0};                    // Command being processed (0 = none)
+    bool          m_runningCancelled        {false};                // cancel() hit the running command
+    uint32_t      m_completedId             {0};
+    ecdCommandCallback_t m_callback         {nullptr};
+    void*         m_callbackContext         {nullptr};
+    ECD_QueueStats m_stats;
+#ifdef YNV_ECD_HOST_THREADS
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_changed;                              // Post, completion or cancel
+#endif
+};
+
+
+/**
+ * @brief Storage of an ECD_CommandQueueSized queue (base class, so it is
+ * built before the ECD_CommandQueue that uses it).
+ */
+template <int Capacity>
+struct ECD_CommandBuffer {
+    ECD_Command m_commandStorage[Capacity];
+};
+
+/**
+ * @class ECD_CommandQueueSized
+ * @brief ECD_CommandQueue with room for Capacity commands inside the object,
+ * e.g. ECD_CommandQueueSized<8> queue(display);
+ *
+ * @tparam Capacity Number of commands (1..255)
+ */
+template <int Capacity>
+class ECD_CommandQueueSized : private ECD_CommandBuffer<Capacity>, public ECD_CommandQueue {
+    static_assert(Capacity > 0 && Capacity <= 255, "Capacity must be 1..255");
+public:
+    explicit ECD_CommandQueueSized(YNV_ECD& t_display)
+        : ECD_CommandQueue(t_display, ECD_CommandBuffer<Capacity>::m_commandStorage, Capacity) {}
+};
+
+#endif // _YNVISIBLE_ECD_QUEUE
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,1352 @@
+
+/**
+ * @file YnvisibleECDSimulator.cpp
+ * @brief Equivalent-circuit model of electrochromic segments driven by a simulated Driver v5.
+ *
+ * This file implements the YNV_ECD_Simulator class declared in
+ * YnvisibleECDSimulator.h. It replaces the CE DAC, the WE GPIOs and the ADC
+ * of the Driver v5 board so the driving engine (executeDisplay, check_refresh,
+ * refresh loops) can be exercised end to end without hardware.
+ *
+ * Responsibilities:
+ *  - Keep the simulated pin modes, WE levels and CE DAC code.
+ *  - Keep the virtual device clock used by the simulated delay()/millis().
+ *  - Integrate the per-segment equivalent circuit:
+ *       • Fixed-step integration while the WE is driven and the CE is enabled
+ *         (current through Rs, double-layer charging, faradaic charge).
+ *       • Closed-form decay while the segment is at open circuit (double-layer
+ *         relaxation through Rct and self-discharge to the rest state), so
+ *         jumps of hours cost the same as a single step.
+ *  - Age every segment with the faradaic charge it has moved (capacity fade,
+ *    slower kinetics, faster self-discharge).
+ *  - Convert the resulting WE potential to ADC LSB on analogRead(), with the
+ *    coupling of the neighbouring segments and the optional ADC noise.
+ *  - Accumulate the charge delivered by the drive pulses (energy estimate).
+ *  - Record every I/O access in an optional trace buffer and serve
+ *    analogRead() from a recorded trace in replay mode.
+ *  - Check the safety ordering of CE and WE accesses.
+ *  - Convert traces to VCD (CE DAC bus, WE mode/level signals, ADC sample
+ *    markers and values, engine phase).
+ *
+ * Notes:
+ *  - A floating (High-Z) CE keeps its last DAC level for measurements, but no
+ *    current flows through any segment while it is disabled.
+ *  - Only compiled when YNV_ECD_SIMULATOR is defined.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifdef YNV_ECD_SIMULATOR
+
+#include "Arduino.h"
+#include "YnvisibleECDSimulator.h"
+
+
+/***************************************************************************/
+/**************************** PUBLIC FUNCTIONS *****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Simulated Driver v5 board without any segment attached.
+ */
+/***************************************************************************/
+
+YNV_ECD_Simulator::YNV_ECD_Simulator()
+{
+  m_counterElectrodePin = PIN_CE;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Register a segment (WE pin) in the simulator.
+ *
+ * The segment starts fully bleached, in High-Z, with default parameters.
+ * Registering a pin twice returns the existing segment index.
+ *
+ * @param t_pin WE pin of the segment.
+ * @return Segment index, or -1 if ECD_SIM_MAX_SEGMENTS is exceeded.
+ */
+/***************************************************************************/
+
+int YNV_ECD_Simulator::addSegment(int t_pin)
+{
+  int index = findSegment(t_pin);
+
+  if (index >= 0) {                                         // Already registered
+    return index;
+  }
+
+  if (m_numberOfSegments >= ECD_SIM_MAX_SEGMENTS) {
+    return -1;
+  }
+
+  index = m_numberOfSegments++;
+  m_segments[index].model              = ECD_SegmentModel();
+  m_segments[index].pin                = t_pin;
+  m_segments[index].output             = false;
+  m_segments[index].level              = false;
+  m_segments[index].charge             = 0.0f;
+  m_segments[index].doubleLayerVoltage = 0.0f;
+  m_segments[index].cycles             = 0.0f;
+  m_segments[index].neighbours         = 0;
+
+  return index;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set the equivalent-circuit parameters of one segment.
+ *
+ * @param t_segment Segment index returned by addSegment().
+ * @param t_model   New parameters.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setSegmentModel(int t_segment, const ECD_SegmentModel& t_model)
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return;
+  }
+  m_segments[t_segment].model = t_model;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set the same equivalent-circuit parameters on all segments.
+ *
+ * @param t_model New parameters.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setAllSegmentsModel(const ECD_SegmentModel& t_model)
+{
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    m_segments[i].model = t_model;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Draw the parameters of all segments around a nominal model.
+ *
+ * Each parameter of each segment is drawn from a normal distribution centred
+ * on the nominal value (resistances, capacitance, capacity and self-discharge
+ * are kept positive). The generator is local to this simulator, so runs are
+ * reproducible per seed and independent between simulators.
+ *
+ * @param t_nominal Nominal segment parameters.
+ * @param t_spread  Standard deviations of the parameters.
+ * @param t_seed    Random seed (0 is replaced by 1).
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::applySegmentSpread(const ECD_SegmentModel& t_nominal, const ECD_SegmentSpread& t_spread, uint32_t t_seed)
+{
+  m_randomState = (t_seed != 0) ? t_seed : 1;
+
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    ECD_SegmentModel& model = m_segments[i].model;
+
+    model = t_nominal;
+    model.seriesResistance         *= max(0.05f, 1.0f + t_spread.seriesResistance         * randomNormal(m_randomState));
+    model.chargeTransferResistance *= max(0.05f, 1.0f + t_spread.chargeTransferResistance * randomNormal(m_randomState));
+    model.doubleLayerCapacitance   *= max(0.05f, 1.0f + t_spread.doubleLayerCapacitance   * randomNormal(m_randomState));
+    model.chargeCapacity           *= max(0.05f, 1.0f + t_spread.chargeCapacity           * randomNormal(m_randomState));
+    model.selfDischargeTime        *= max(0.05f, 1.0f + t_spread.selfDischargeTime        * randomNormal(m_randomState));
+    model.coloredPotential         += t_spread.coloredPotential  * randomNormal(m_randomState);
+    model.bleachedPotential        += t_spread.bleachedPotential * randomNormal(m_randomState);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Force the charge state of a segment (e.g. to start from a known state).
+ *
+ * @param t_segment Segment index.
+ * @param t_charge  Normalised charge state (0 = bleached, 1 = colored).
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setSegmentCharge(int t_segment, float t_charge)
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return;
+  }
+  m_segments[t_segment].charge             = constrain(t_charge, 0.0f, 1.0f);
+  m_segments[t_segment].doubleLayerVoltage = 0.0f;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Force the age of a segment.
+ *
+ * Used by lifetime simulations to fast-forward aging between measurement
+ * windows instead of driving every cycle.
+ *
+ * @param t_segment Segment index.
+ * @param t_cycles  Full equivalent cycles already done by the segment.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setSegmentCycles(int t_segment, float t_cycles)
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return;
+  }
+  m_segments[t_segment].cycles = max(t_cycles, 0.0f);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Add Gaussian noise to the readings of the segments.
+ *
+ * @param t_sigmaLsb (LSB) Standard deviation of the noise, 0 for exact readings.
+ * @param t_seed     Seed of the noise generator (0 is replaced by 1).
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setAdcNoise(float t_sigmaLsb, uint32_t t_seed)
+{
+  m_adcNoiseLsb = max(t_sigmaLsb, 0.0f);
+  m_noiseState  = (t_seed != 0) ? t_seed : 1;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Set which segments are next to each other.
+ *
+ * The reading of a High-Z segment then includes, from each neighbour, its
+ * neighbourCoupling share of the neighbour WE-CE potential and its
+ * polarisationCoupling share of the neighbour double-layer voltage.
+ *
+ * @param t_neighbours Bit j of t_neighbours[i]: segment j next to segment i
+ *                     (one mask per registered segment), or nullptr.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setNeighbours(const ecdSegmentMask_t* t_neighbours)
+{
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    m_segments[i].neighbours = (t_neighbours != nullptr) ? t_neighbours[i] : 0;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated pinMode() for the CE and WE pins.
+ *
+ * INPUT places the pin in High-Z. On the CE pin this disables the DAC.
+ *
+ * @param t_pin  Pin number.
+ * @param t_mode INPUT or OUTPUT.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::pinMode(int t_pin, int t_mode)
+{
+  recordEvent(ECD_SIM_EVENT_PIN_MODE, t_pin, t_mode);
+
+  if (t_pin == m_counterElectrodePin) {
+    if (t_mode != OUTPUT) {
+      if (m_counterElectrodeEnabled && anySegmentDriven()) {
+        m_safetyViolations++;                               // CE released under a driven WE
+      }
+      m_counterElectrodeEnabled = false;
+    }
+    return;
+  }
+
+  int index = findSegment(t_pin);
+  if (index >= 0) {
+    m_segments[index].output = (t_mode == OUTPUT);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated digitalWrite() for the WE pins.
+ *
+ * @param t_pin   Pin number.
+ * @param t_level HIGH (drive to supply) or LOW (drive to 0 V).
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::digitalWrite(int t_pin, int t_level)
+{
+  recordEvent(ECD_SIM_EVENT_DIGITAL_WRITE, t_pin, t_level);
+
+  int index = findSegment(t_pin);
+  if (index >= 0) {
+    m_segments[index].level = (t_level != LOW);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated analogWrite() on the CE DAC.
+ *
+ * Writing the DAC enables the CE at the requested level. Changing the CE
+ * while a WE is driven is counted as a safety violation.
+ *
+ * @param t_pin   Pin number (only the CE pin is modelled).
+ * @param t_value DAC code in LSB.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::analogWrite(int t_pin, int t_value)
+{
+  recordEvent(ECD_SIM_EVENT_ANALOG_WRITE, t_pin, t_value);
+
+  if (t_pin == m_counterElectrodePin) {
+    int lsb = constrain(t_value, 0, ADC_DAC_MAX_LSB);
+
+    if ((!m_counterElectrodeEnabled || lsb != m_counterElectrodeLSB) && anySegmentDriven()) {
+      m_safetyViolations++;
+    }
+    m_counterElectrodeLSB     = lsb;
+    m_counterElectrodeEnabled = true;
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated analogRead() of a WE pin.
+ *
+ * A driven WE reads its output level. A High-Z WE reads the CE level plus
+ * the segment OCP and the remaining double-layer polarisation, plus the
+ * coupling of its neighbours (setNeighbours()) and the ADC noise
+ * (setAdcNoise()). In replay mode the next
+ * recorded reading of the pin is returned instead. Each conversion advances
+ * the clock by setAdcConversionTime() (none by default).
+ *
+ * @param t_pin Pin number.
+ * @return Absolute WE voltage in LSB (0..ADC_DAC_MAX_LSB).
+ */
+/***************************************************************************/
+
+int YNV_ECD_Simulator::analogRead(int t_pin)
+{
+  int lsb;
+
+  m_adcConversions++;
+  if (m_adcConversionMicros > 0) {
+    delayMicroseconds(m_adcConversionMicros);
+  }
+  if (m_replay != nullptr && nextReplayReading(t_pin, lsb)) {
+    recordEvent(ECD_SIM_EVENT_ANALOG_READ, t_pin, lsb);
+    return lsb;
+  }
+
+  int index = findSegment(t_pin);
+  if (index < 0) {
+    recordEvent(ECD_SIM_EVENT_ANALOG_READ, t_pin, 0);
+    return 0;
+  }
+
+  const SegmentState& seg     = m_segments[index];
+  float               voltage = weVoltage(seg);
+
+  if (!seg.output) {
+    ecdSegmentMask_t neighbours = seg.neighbours;
+
+    for (int j = 0; neighbours != 0 && j < m_numberOfSegments; j++, neighbours >>= 1) {
+      if (neighbours & 1) {
+        voltage += seg.model.neighbourCoupling    * (weVoltage(m_segments[j]) - counterElectrodeVoltage());
+        voltage += seg.model.polarisationCoupling * m_segments[j].doubleLayerVoltage;
+      }
+    }
+  }
+
+  if (m_adcNoiseLsb > 0.0f) {
+    voltage += m_adcNoiseLsb * randomNormal(m_noiseState) * (m_supplyVoltage / ADC_DAC_MAX_LSB);
+  }
+
+  lsb = (int)(voltage * (ADC_DAC_MAX_LSB / m_supplyVoltage) + 0.5f);
+  lsb = constrain(lsb, 0, ADC_DAC_MAX_LSB);
+
+  recordEvent(ECD_SIM_EVENT_ANALOG_READ, t_pin, lsb);
+  return lsb;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Window compare of the refresh watch: one conversion of a WE pin
+ * compared with [t_low, t_high].
+ *
+ * Same as ECD_HalBase::compareAdc() on the board backends: the CPU runs the
+ * conversion and compares it in software, so every compare is traced as an
+ * analogRead() of the pin. Compares and out-of-window events are counted.
+ *
+ * @param t_pin Pin number.
+ * @param t_low, t_high (LSB) Window bounds, inclusive.
+ * @param t_value Converted value (LSB).
+ * @return true if the value is outside the window (event).
+ */
+/***************************************************************************/
+
+bool YNV_ECD_Simulator::windowCompare(int t_pin, int t_low, int t_high, int& t_value)
+{
+  t_value = analogRead(t_pin);
+  m_comparatorConversions++;
+
+  if (t_value >= t_low && t_value <= t_high) {
+    return false;
+  }
+  m_comparatorEvents++;
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated delay().
+ *
+ * Recorded in the trace, then advances the virtual clock.
+ *
+ * @param t_ms Delay in milliseconds.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::delay(unsigned long t_ms)
+{
+  recordEvent(ECD_SIM_EVENT_DELAY, 0, (int)t_ms);
+  advanceTime(t_ms);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated delayMicroseconds().
+ *
+ * Not recorded in the trace. The delay adds to micros() at once; the model
+ * is integrated by whole milliseconds as the delays add up.
+ *
+ * @param t_us Delay in microseconds.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::delayMicroseconds(unsigned long t_us)
+{
+  m_subMillisMicros += t_us;
+  if (m_subMillisMicros >= 1000UL) {
+    unsigned long wholeMs = m_subMillisMicros / 1000UL;
+
+    m_subMillisMicros -= wholeMs * 1000UL;
+    advanceTime(wholeMs);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Advance the virtual clock and integrate all segments.
+ *
+ * Used by the simulated delay(). Tests can call it directly to jump ahead
+ * (e.g. hours) and exercise self-discharge and refresh scheduling. A
+ * pending interrupt due within the interval runs at its exact time, then
+ * the remaining time is integrated.
+ *
+ * @param t_ms Simulated time to advance, in milliseconds.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::advanceTime(unsigned long t_ms)
+{
+  if (m_interruptHandler != nullptr && m_interruptTimeMs <= m_timeMs + t_ms) {
+    unsigned long beforeInterrupt = (m_interruptTimeMs > m_timeMs) ? m_interruptTimeMs - m_timeMs : 0;
+    void (*handler)(void*)        = m_interruptHandler;
+
+    integrateAll(beforeInterrupt);
+    m_interruptHandler = nullptr;                           // One shot, the handler may schedule another
+    handler(m_interruptContext);
+    t_ms -= beforeInterrupt;
+  }
+
+  integrateAll(t_ms);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Record the phase entered by the driving engine.
+ *
+ * @param t_phase ecdDriverPhase_e value.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setDriverPhase(int t_phase)
+{
+  recordEvent(ECD_SIM_EVENT_PHASE, 0, t_phase);
+  m_driverPhase = t_phase;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Schedule a simulated interrupt.
+ *
+ * The handler is called from the virtual clock (inside delay() or
+ * advanceTime()) when device time reaches t_timeMs, like an ISR firing in
+ * the middle of a pulse. Only one interrupt is pending at a time.
+ *
+ * @param t_timeMs  Device time (ms) at which the handler runs.
+ * @param t_handler Handler, or nullptr to cancel the pending interrupt.
+ * @param t_context Argument passed to the handler.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::scheduleInterrupt(unsigned long t_timeMs, void (*t_handler)(void*), void* t_context)
+{
+  m_interruptTimeMs  = t_timeMs;
+  m_interruptHandler = t_handler;
+  m_interruptContext = t_context;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Get the normalised charge state of a segment.
+ *
+ * @param t_segment Segment index.
+ * @return Charge state (0 = bleached, 1 = colored), or 0 for an invalid index.
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::getSegmentCharge(int t_segment) const
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return 0.0f;
+  }
+  return m_segments[t_segment].charge;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Get the open-circuit WE-CE potential of a segment.
+ *
+ * @param t_segment Segment index.
+ * @return Potential in volts (OCP + double-layer polarisation).
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::getSegmentOcp(int t_segment) const
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return 0.0f;
+  }
+  return equilibriumPotential(m_segments[t_segment]) + m_segments[t_segment].doubleLayerVoltage;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Check if a segment looks colored to an observer.
+ *
+ * Used to detect a visibly wrong state after an update, independently of the
+ * OCP thresholds used by the driving engine.
+ *
+ * @param t_segment Segment index.
+ * @return true if the charge state is above ECD_SIM_VISIBLE_CHARGE.
+ */
+/***************************************************************************/
+
+bool YNV_ECD_Simulator::isSegmentVisiblyColored(int t_segment) const
+{
+  return getSegmentCharge(t_segment) > ECD_SIM_VISIBLE_CHARGE;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Get the age of a segment.
+ *
+ * One full equivalent cycle is twice the nominal charge capacity moved
+ * through Rct (a complete bleach → color → bleach transition).
+ *
+ * @param t_segment Segment index.
+ * @return Full equivalent cycles, or 0 for an invalid index.
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::getSegmentCycles(int t_segment) const
+{
+  if (t_segment < 0 || t_segment >= m_numberOfSegments) {
+    return 0.0f;
+  }
+  return m_segments[t_segment].cycles;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Record every I/O access into a caller-provided buffer.
+ *
+ * Recording stops silently when the buffer is full; lost events are counted
+ * by getTraceDropped(). Calls to advanceTime() are not engine actions and
+ * are not recorded.
+ *
+ * @param t_buffer   Event buffer, or nullptr to stop recording.
+ * @param t_capacity Number of events the buffer can hold.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setTraceBuffer(ECD_SimEvent* t_buffer, unsigned int t_capacity)
+{
+  m_trace         = t_buffer;
+  m_traceCapacity = (t_buffer != nullptr) ? t_capacity : 0;
+  clearTrace();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Replay the ADC readings of a recorded trace.
+ *
+ * Every analogRead() returns the next recorded ANALOG_READ of the trace.
+ * Pin actions still drive the model, so the engine decisions only depend on
+ * the recorded readings. If the engine reads a different pin than recorded,
+ * or reads past the end of the trace, the model value is used and the miss
+ * is counted: the decisions have already diverged at that point.
+ *
+ * @param t_trace  Recorded events, or nullptr to stop replaying.
+ * @param t_length Number of recorded events.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::setReplayTrace(const ECD_SimEvent* t_trace, unsigned int t_length)
+{
+  m_replay         = t_trace;
+  m_replayLength   = (t_trace != nullptr) ? t_length : 0;
+  m_replayPosition = 0;
+  m_replayMisses   = 0;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Find the first event where two traces differ.
+ *
+ * Events are equal when type, pin and value match and their times differ by
+ * no more than the tolerance.
+ *
+ * @param t_expected       Reference trace (e.g. field recording).
+ * @param t_expectedLength Number of events in the reference trace.
+ * @param t_actual         Trace recorded by the run under test.
+ * @param t_actualLength   Number of events in the run under test.
+ * @param t_toleranceMs    (ms) Allowed timing difference per event.
+ * @return Index of the first differing event, or -1 if the traces match.
+ */
+/***************************************************************************/
+
+int YNV_ECD_Simulator::findTraceDivergence(const ECD_SimEvent* t_expected, unsigned int t_expectedLength,
+                                           const ECD_SimEvent* t_actual, unsigned int t_actualLength,
+                                           unsigned long t_toleranceMs)
+{
+  unsigned int length = min(t_expectedLength, t_actualLength);
+
+  for (unsigned int i = 0; i < length; i++) {
+    unsigned long timeDifference = (t_expected[i].timeMs > t_actual[i].timeMs) ?
+                                    t_expected[i].timeMs - t_actual[i].timeMs :
+                                    t_actual[i].timeMs - t_expected[i].timeMs;
+
+    if (timeDifference > t_toleranceMs             ||
+        t_expected[i].type   != t_actual[i].type   ||
+        t_expected[i].pin    != t_actual[i].pin    ||
+        t_expected[i].value  != t_actual[i].value) {
+      return (int)i;
+    }
+  }
+  return (t_expectedLength == t_actualLength) ? -1 : (int)length;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Print one trace event as a CSV line.
+ *
+ * Format: time (ms), type (ECD_SimEventType), pin, value.
+ *
+ * @param t_out   Output stream (e.g. Serial).
+ * @param t_event Event to print.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::printTraceEvent(Print& t_out, const ECD_SimEvent& t_event)
+{
+  t_out.print(t_event.timeMs);      t_out.print(',');
+  t_out.print((int)t_event.type);   t_out.print(',');
+  t_out.print((int)t_event.pin);    t_out.print(',');
+  t_out.println(t_event.value);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Write a trace as a Value Change Dump (VCD) file.
+ *
+ * Signals (timescale 1 ms):
+ *  - ce_dac      : CE DAC code bus (ADC_DAC_RESOLUTION bits)
+ *  - ce_enabled  : CE driven (DAC written) or High-Z
+ *  - phase       : engine phase bus (ecdDriverPhase_e, decoded in a comment)
+ *  - adc_sample  : VCD event marking every analogRead()
+ *  - adc_value   : last ADC reading bus
+ *  - we_<pin>_output / we_<pin>_level : mode and level of every WE pin
+ *
+ * The CE pin is the pin of the first DAC write; every other pin accessed
+ * is a WE. Works on simulator traces and on recordings from a device in the
+ * same time,type,pin,value format. Several ADC samples in the same
+ * millisecond show as a single marker.
+ *
+ * @param t_out    Output stream (e.g. Serial, redirected to a .vcd file).
+ * @param t_trace  Recorded events.
+ * @param t_length Number of events.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::writeTraceVcd(Print& t_out, const ECD_SimEvent* t_trace, unsigned int t_length)
+{
+  const int firstWeId = 5;                                  // Identifiers: '!' + index
+  const int maxWePins = ('~' - '!' + 1 - firstWeId) / 2;
+
+  int counterElectrodePin = -1;
+  int wePins[maxWePins];
+  int numberOfWePins = 0;
+
+  for (unsigned int i = 0; i < t_length && counterElectrodePin < 0; i++) {
+    if (t_trace[i].type == ECD_SIM_EVENT_ANALOG_WRITE) {
+      counterElectrodePin = t_trace[i].pin;
+    }
+  }
+  for (unsigned int i = 0; i < t_length; i++) {
+    const ECD_SimEvent& event = t_trace[i];
+    bool weAccess = event.type == ECD_SIM_EVENT_PIN_MODE || event.type == ECD_SIM_EVENT_DIGITAL_WRITE ||
+                    event.type == ECD_SIM_EVENT_ANALOG_READ;
+
+    if (weAccess && event.pin != counterElectrodePin && vcdPinIndex(wePins, numberOfWePins, event.pin) < 0 &&
+        numberOfWePins < maxWePins) {
+      wePins[numberOfWePins++] = event.pin;
+    }
+  }
+
+  // Header
+  t_out.println("$version Ynvisible ECD trace $end");
+  t_out.println("$timescale 1 ms $end");
+  t_out.println("$comment phase: 0 idle, 1 bleach, 2 color, 3 check, 4 refresh bleach, 5 refresh color, 6 direct drive $end");
+  t_out.println("$scope module ecd $end");
+  t_out.print("$var wire "); t_out.print(ADC_DAC_RESOLUTION); t_out.println(" ! ce_dac $end");
+  t_out.println("$var wire 1 \" ce_enabled $end");
+  t_out.println("$var wire 3 # phase $end");
+  t_out.println("$var event 1 $ adc_sample $end");
+  t_out.print("$var wire "); t_out.print(ADC_DAC_RESOLUTION); t_out.println(" % adc_value $end");
+  for (int i = 0; i < numberOfWePins; i++) {
+    t_out.print("$var wire 1 "); t_out.print((char)('!' + firstWeId + 2 * i));
+    t_out.print(" we_"); t_out.print(wePins[i]); t_out.println("_output $end");
+    t_out.print("$var wire 1 "); t_out.print((char)('!' + firstWeId + 2 * i + 1));
+    t_out.print(" we_"); t_out.print(wePins[i]); t_out.println("_level $end");
+  }
+  t_out.println("$upscope $end");
+  t_out.println("$enddefinitions $end");
+
+  // Initial values: CE and all WE pins High-Z, engine idle
+  t_out.println("#0");
+  t_out.println("$dumpvars");
+  writeVcdBus(t_out, 0, ADC_DAC_RESOLUTION, '!');
+  t_out.println("0\"");
+  writeVcdBus(t_out, 0, 3, '#');
+  writeVcdBus(t_out, 0, ADC_DAC_RESOLUTION, '%');
+  for (int i = 0; i < 2 * numberOfWePins; i++) {
+    t_out.print('0'); t_out.println((char)('!' + firstWeId + i));
+  }
+  t_out.println("$end");
+
+  // Value changes
+  unsigned long lastTime = 0;
+  for (unsigned int i = 0; i < t_length; i++) {
+    const ECD_SimEvent& event = t_trace[i];
+    int weIndex = (event.pin == counterElectrodePin) ? -1 : vcdPinIndex(wePins, numberOfWePins, event.pin);
+
+    if (event.timeMs != lastTime) {
+      t_out.print('#'); t_out.println(event.timeMs);
+      lastTime = event.timeMs;
+    }
+
+    switch (event.type) {
+      case ECD_SIM_EVENT_PIN_MODE:
+        if (event.pin == counterElectrodePin && event.value != OUTPUT) {
+          t_out.println("0\"");
+        }
+        else if (weIndex >= 0) {
+          t_out.print(event.value == OUTPUT ? '1' : '0'); t_out.println((char)('!' + firstWeId + 2 * weIndex));
+        }
+        break;
+
+      case ECD_SIM_EVENT_DIGITAL_WRITE:
+        if (weIndex >= 0) {
+          t_out.print(event.value != LOW ? '1' : '0'); t_out.println((char)('!' + firstWeId + 2 * weIndex + 1));
+        }
+        break;
+
+      case ECD_SIM_EVENT_ANALOG_WRITE:
+        writeVcdBus(t_out, event.value, ADC_DAC_RESOLUTION, '!');
+        t_out.println("1\"");
+        break;
+
+      case ECD_SIM_EVENT_ANALOG_READ:
+        t_out.println("1$");
+        writeVcdBus(t_out, event.value, ADC_DAC_RESOLUTION, '%');
+        break;
+
+      case ECD_SIM_EVENT_PHASE:
+        writeVcdBus(t_out, event.value, 3, '#');
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+
+/***************************************************************************/
+/************************** END PUBLIC FUNCTIONS ***************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**************************** PRIVATE FUNCTIONS ****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Integrate a driven segment with a fixed time step.
+ *
+ * @param t_seg Segment being driven (WE OUTPUT, CE enabled).
+ * @param t_ms  Time to integrate, in milliseconds.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::integrateDriven(SegmentState& t_seg, unsigned long t_ms)
+{
+  const ECD_SegmentModel  model = agedModel(t_seg);
+  const float dt          = ECD_SIM_STEP_MS * 0.001f;           // (s) Integration step
+  const float cellVoltage = (t_seg.level ? m_supplyVoltage : 0.0f) - counterElectrodeVoltage();
+
+  for (unsigned long t = 0; t < t_ms; t += ECD_SIM_STEP_MS) {
+
+    float current         = (cellVoltage - equilibriumPotential(t_seg) - t_seg.doubleLayerVoltage) / model.seriesResistance;
+    float faradaicCurrent = t_seg.doubleLayerVoltage / model.chargeTransferResistance;
+
+    // Faradaic current stops when no material is left to color/bleach
+    faradaicCurrent *= (faradaicCurrent > 0.0f) ? (1.0f - t_seg.charge) : t_seg.charge;
+
+    m_chargeDelivered        += fabsf(current) * dt;
+    t_seg.cycles             += fabsf(faradaicCurrent) * dt / (2.0f * t_seg.model.chargeCapacity);
+    t_seg.doubleLayerVoltage += (current - faradaicCurrent) * dt / model.doubleLayerCapacitance;
+    t_seg.charge             += faradaicCurrent * dt / model.chargeCapacity;
+    t_seg.charge             += (model.restCharge - t_seg.charge) * ECD_SIM_STEP_MS / model.selfDischargeTime;
+    t_seg.charge              = constrain(t_seg.charge, 0.0f, 1.0f);
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Integrate an open-circuit segment in closed form.
+ *
+ * With no current through Rs, Cdl discharges through Rct into the faradaic
+ * charge, and the charge state decays exponentially to the rest state.
+ *
+ * @param t_seg Segment at open circuit.
+ * @param t_ms  Time to integrate, in milliseconds.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::integrateIdle(SegmentState& t_seg, unsigned long t_ms)
+{
+  const ECD_SegmentModel  model = agedModel(t_seg);
+  const float t        = t_ms * 0.001f;                                     // (s)
+  const float relaxed  = 1.0f - expf(-t / (model.chargeTransferResistance * model.doubleLayerCapacitance));
+
+  // Charge released by the double layer flows through Rct into the segment
+  const float released      = model.doubleLayerCapacitance * t_seg.doubleLayerVoltage * relaxed;   // (C)
+  t_seg.charge             += released / model.chargeCapacity;
+  t_seg.cycles             += fabsf(released) / (2.0f * t_seg.model.chargeCapacity);
+  t_seg.doubleLayerVoltage -= t_seg.doubleLayerVoltage * relaxed;
+
+  // Self-discharge toward the rest potential
+  t_seg.charge  = model.restCharge + (t_seg.charge - model.restCharge) * expf(-(float)t_ms / model.selfDischargeTime);
+  t_seg.charge  = constrain(t_seg.charge, 0.0f, 1.0f);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Integrate every segment over an interval and advance the clock.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::integrateAll(unsigned long t_ms)
+{
+  for (int i = 0; i < m_numberOfSegments; i++) {
+
+    if (m_segments[i].output && m_counterElectrodeEnabled) {
+      integrateDriven(m_segments[i], t_ms);
+    }
+    else {
+      integrateIdle(m_segments[i], t_ms);
+    }
+  }
+
+  m_timeMs += t_ms;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Check if any registered WE is driven (OUTPUT mode).
+ */
+/***************************************************************************/
+
+bool YNV_ECD_Simulator::anySegmentDriven() const
+{
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    if (m_segments[i].output) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Find the segment registered on a WE pin.
+ *
+ * @param t_pin Pin number.
+ * @return Segment index, or -1 if the pin is not a registered segment.
+ */
+/***************************************************************************/
+
+int YNV_ECD_Simulator::findSegment(int t_pin) const
+{
+  for (int i = 0; i < m_numberOfSegments; i++) {
+    if (m_segments[i].pin == t_pin) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Voltage currently applied by the CE DAC.
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::counterElectrodeVoltage() const
+{
+  return m_counterElectrodeLSB * (m_supplyVoltage / ADC_DAC_MAX_LSB);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Open-circuit potential for the present charge state of a segment.
+ *
+ * Linear interpolation between the bleached and colored potentials.
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::equilibriumPotential(const SegmentState& t_seg) const
+{
+  return t_seg.model.bleachedPotential +
+         t_seg.charge * (t_seg.model.coloredPotential - t_seg.model.bleachedPotential);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief WE voltage of a segment without coupling: its output level when
+ * driven, otherwise CE + OCP + double-layer polarisation.
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::weVoltage(const SegmentState& t_seg) const
+{
+  if (t_seg.output) {
+    return t_seg.level ? m_supplyVoltage : 0.0f;
+  }
+  return counterElectrodeVoltage() + equilibriumPotential(t_seg) + t_seg.doubleLayerVoltage;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Equivalent-circuit parameters of a segment after aging.
+ *
+ * Linear aging with the number of full equivalent cycles:
+ *  - the charge capacity fades (floored at 10 % of the nominal value),
+ *  - the charge transfer resistance grows (slower kinetics),
+ *  - the self-discharge rate grows (shorter time constant).
+ */
+/***************************************************************************/
+
+ECD_SegmentModel YNV_ECD_Simulator::agedModel(const SegmentState& t_seg) const
+{
+  ECD_SegmentModel model = t_seg.model;
+
+  model.chargeCapacity           *= max(1.0f - model.capacityFade * t_seg.cycles, 0.1f);
+  model.chargeTransferResistance *= 1.0f + model.kineticsAging * t_seg.cycles;
+  model.selfDischargeTime        /= 1.0f + model.selfDischargeAging * t_seg.cycles;
+
+  return model;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Uniform random number from a xorshift32 generator state of the
+ * simulator (spread or ADC noise).
+ *
+ * @return Value in [-1, 1).
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::randomUniform(uint32_t& t_state)
+{
+  t_state ^= t_state << 13;
+  t_state ^= t_state >> 17;
+  t_state ^= t_state << 5;
+
+  return (t_state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Standard normal random number (Box-Muller transform).
+ */
+/***************************************************************************/
+
+float YNV_ECD_Simulator::randomNormal(uint32_t& t_state)
+{
+  float u1 = (randomUniform(t_state) + 1.0f) * 0.5f;        // (0, 1]
+  float u2 = (randomUniform(t_state) + 1.0f) * 0.5f;
+
+  if (u1 < 1.0e-7f) {
+    u1 = 1.0e-7f;
+  }
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Append an I/O event to the trace buffer, if recording.
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::recordEvent(ECD_SimEventType t_type, int t_pin, int t_value)
+{
+  if (m_trace == nullptr) {
+    return;
+  }
+  if (m_traceLength >= m_traceCapacity) {
+    m_traceDropped++;
+    return;
+  }
+
+  ECD_SimEvent& event = m_trace[m_traceLength++];
+  event.timeMs = m_timeMs;
+  event.type   = t_type;
+  event.pin    = (uint8_t)t_pin;
+  event.value  = t_value;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Get the next recorded analogRead() from the replayed trace.
+ *
+ * @param t_pin   Pin being read by the engine.
+ * @param t_value Recorded reading (LSB), set on success.
+ * @return true if the next recorded reading is on the same pin.
+ */
+/***************************************************************************/
+
+bool YNV_ECD_Simulator::nextReplayReading(int t_pin, int& t_value)
+{
+  while (m_replayPosition < m_replayLength &&
+         m_replay[m_replayPosition].type != ECD_SIM_EVENT_ANALOG_READ) {
+    m_replayPosition++;
+  }
+
+  if (m_replayPosition >= m_replayLength || m_replay[m_replayPosition].pin != t_pin) {
+    m_replayMisses++;
+    return false;
+  }
+
+  t_value = m_replay[m_replayPosition++].value;
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Write a VCD bus value change ("b<binary> <id>").
+ */
+/***************************************************************************/
+
+void YNV_ECD_Simulator::writeVcdBus(Print& t_out, int t_value, int t_bits, char t_id)
+{
+  t_out.print('b');
+  for (int bit = t_bits - 1; bit >= 0; bit--) {
+    t_out.print(((t_value >> bit) & 1) ? '1' : '0');
+  }
+  t_out.print(' ');
+  t_out.println(t_id);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Position of a pin in a VCD pin list, or -1.
+ */
+/***************************************************************************/
+
+int YNV_ECD_Simulator::vcdPinIndex(const int* t_pins, int t_count, int t_pin)
+{
+  for (int i = 0; i < t_count; i++) {
+    if (t_pins[i] == t_pin) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+/***************************************************************************/
+/************************** END PRIVATE FUNCTIONS **************************/
+/***************************************************************************/
+
+
+/***************************************************************************/
+/**
+ * @brief Simulated expander bus on a simulator.
+ *
+ * @param t_simulator Simulator holding the segments of the expander pins
+ * @param t_transactionMicros (us) Modelled duration of one chip transaction
+ */
+/***************************************************************************/
+
+ECD_SimExpanderBus::ECD_SimExpanderBus(YNV_ECD_Simulator& t_simulator, unsigned long t_transactionMicros)
+  : m_simulator(t_simulator), m_transactionMicros(t_transactionMicros)
+{
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Release all outputs and clear the statistics.
+ */
+/***************************************************************************/
+
+void ECD_SimExpanderBus::begin(uint8_t t_numberOfChips)
+{
+  for (uint8_t chip = 0; chip < ECD_EXPANDER_MAX_CHIPS; chip++) {
+    for (int bit = 0; bit < ECD_EXPANDER_PINS_PER_CHIP; bit++) {
+      if (chip < t_numberOfChips && (m_outputs[chip] & (1u << bit))) {
+        m_simulator.pinMode(ECD_EXPANDER_PIN(chip, bit), INPUT);
+      }
+    }
+    m_level[chip]   = 0;
+    m_outputs[chip] = 0;
+  }
+  resetStats();
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Apply one chip transaction: output level changes, then output
+ * enable changes, at the end of the modelled transaction.
+ */
+/***************************************************************************/
+
+void ECD_SimExpanderBus::writeChip(uint8_t t_chip, uint16_t t_level, uint16_t t_outputs)
+{
+  if (t_chip >= ECD_EXPANDER_MAX_CHIPS) {
+    return;
+  }
+
+  unsigned long startMicros = m_simulator.millis() * 1000UL;       // Transactions queue on the bus
+  if (m_busMicros > startMicros) {
+    startMicros = m_busMicros;
+  }
+  m_busMicros = startMicros + m_transactionMicros;
+  m_transactions[t_chip]++;
+
+  uint16_t levelChanges  = t_level ^ m_level[t_chip];
+  uint16_t outputChanges = t_outputs ^ m_outputs[t_chip];
+
+  for (int bit = 0; bit < ECD_EXPANDER_PINS_PER_CHIP; bit++) {     // Output latch first ...
+    if (levelChanges & (1u << bit)) {
+      m_simulator.digitalWrite(ECD_EXPANDER_PIN(t_chip, bit), (t_level & (1u << bit)) ? HIGH : LOW);
+    }
+  }
+  for (int bit = 0; bit < ECD_EXPANDER_PINS_PER_CHIP; bit++) {     // ... then output enables
+    if (outputChanges & (1u << bit)) {
+      m_simulator.pinMode(ECD_EXPANDER_PIN(t_chip, bit), (t_outputs & (1u << bit)) ? OUTPUT : INPUT);
+    }
+  }
+
+  uint8_t chipBit = (uint8_t)(1u << t_chip);
+
+  if (m_outputs[t_chip] == 0 && t_outputs != 0) {                  // Pulse starts on this chip
+    m_enableMicros[t_chip] = m_busMicros;
+    m_pulseChips |= chipBit;
+  }
+  else if (m_outputs[t_chip] != 0 && t_outputs == 0) {             // Pulse ends on this chip
+    unsigned long width = m_busMicros - m_enableMicros[t_chip];
+    m_lastPulseMicros[t_chip] = width;
+
+    if (!m_pulseWidthSeen || width < m_pulseMinMicros) { m_pulseMinMicros = width; }
+    if (!m_pulseWidthSeen || width > m_pulseMaxMicros) { m_pulseMaxMicros = width; }
+    m_pulseWidthSeen = true;
+    m_pulseChips &= ~chipBit;
+
+    if (m_pulseChips == 0) {                                       // Last chip of the pulse released
+      if (m_pulseMaxMicros - m_pulseMinMicros > m_maxMismatchMicros) {
+        m_maxMismatchMicros = m_pulseMaxMicros - m_pulseMinMicros;
+      }
+      m_pulseWidthSeen = false;
+    }
+  }
+
+  m_level[t_chip]   = t_level;
+  m_outputs[t_chip] = t_outputs;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief OCP reader for ECD_ExpanderHal::setOcpReader(): reads the WE of
+ * the simulator directly (ideal measurement path).
+ * @param t_simulator YNV_ECD_Simulator*
+ */
+/***************************************************************************/
+
+int ECD_SimExpanderBus::readOcp(int t_pin, void* t_simulator)
+{
+  return static_cast<YNV_ECD_Simulator*>(t_simulator)->analogRead(t_pin);
+}
+
+
+unsigned long ECD_SimExpanderBus::getTransactions(uint8_t t_chip) const
+{
+  return (t_chip < ECD_EXPANDER_MAX_CHIPS) ? m_transactions[t_chip] : 0;
+}
+
+unsigned long ECD_SimExpanderBus::getLastPulseMicros(uint8_t t_chip) const
+{
+  return (t_chip < ECD_EXPANDER_MAX_CHIPS) ? m_lastPulseMicros[t_chip] : 0;
+}
+
+void ECD_SimExpanderBus::resetStats()
+{
+  for (uint8_t chip = 0; chip < ECD_EXPANDER_MAX_CHIPS; chip++) {
+    m_transactions[chip]    = 0;
+    m_lastPulseMicros[chip] = 0;
+  }
+  m_pulseWidthSeen    = false;
+  m_maxMismatchMicros = 0;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief ECD_SimulatorHal: engine I/O on the attached simulator, or on the
+ * Arduino core when no simulator is attached.
+ */
+/***************************************************************************/
+
+void ECD_SimulatorHal::begin(int t_resolution)
+{
+  analogReadResolution(t_resolution);
+  analogWriteResolution(t_resolution);
+}
+
+void ECD_SimulatorHal::pinMode(int t_pin, int t_mode)
+{
+  if (m_simulator != nullptr) { m_simulator->pinMode(t_pin, t_mode); return; }
+  ::pinMode(t_pin, t_mode);
+}
+
+void ECD_SimulatorHal::digitalWrite(int t_pin, int t_level)
+{
+  if (m_simulator != nullptr) { m_simulator->digitalWrite(t_pin, t_level); return; }
+  ::digitalWrite(t_pin, t_level);
+}
+
+int ECD_SimulatorHal::readAdc(int t_pin)
+{
+  if (m_simulator != nullptr) { return m_simulator->analogRead(t_pin); }
+  return ::analogRead(t_pin);
+}
+
+bool ECD_SimulatorHal::compareAdc(int t_pin, int t_low, int t_high, int& t_value)
+{
+  if (m_simulator != nullptr) { return m_simulator->windowCompare(t_pin, t_low, t_high, t_value); }
+  t_value = ::analogRead(t_pin);
+  return t_value < t_low || t_value > t_high;
+}
+
+void ECD_SimulatorHal::writeCounterElectrode(int t_pin, int t_value)
+{
+  if (m_simulator != nullptr) { m_simulator->analogWrite(t_pin, t_value); return; }
+  ::analogWrite(t_pin, t_value);
+}
+
+void ECD_SimulatorHal::releaseCounterElectrode(int t_pin)
+{
+  pinMode(t_pin, INPUT);
+}
+
+void ECD_SimulatorHal::delay(unsigned long t_ms)
+{
+  if (m_simulator != nullptr) { m_simulator->delay(t_ms); return; }
+  ::delay(t_ms);
+}
+
+unsigned long ECD_SimulatorHal::millis()
+{
+  if (m_simulator != nullptr) { return m_simulator->millis(); }
+  return ::millis();
+}
+
+void ECD_SimulatorHal::setPhase(int t_phase)
+{
+  if (m_simulator != nullptr) { m_simulator->setDriverPhase(t_phase); }
+}
+
+#endif // YNV_ECD_SIMULATOR
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
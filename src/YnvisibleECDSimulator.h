@@ -0,0 +1,364 @@
+
+/**
+ * @file YnvisibleECDSimulator.h
+ * @brief Equivalent-circuit simulator of electrochromic segments for host testing.
+ *
+ * This header defines a software model of the display side of the Driver v5
+ * board. Each segment is modelled as a Randles-type equivalent circuit driven
+ * between its WE (Working Electrode) pin and the shared CE (Counter Electrode):
+ *
+ *      WE ──[ Rs ]──┬──[ Rct ]──┬── OCP(charge) ── CE
+ *                   └──[ Cdl ]──┘
+ *
+ * Responsibilities:
+ *  - Track the charge state, double-layer voltage and self-discharge of every
+ *    segment from the simulated CE DAC level and the WE pin modes/levels.
+ *  - Return realistic OCP readings (in LSB) from analogRead() on segment pins,
+ *    with optional ADC noise.
+ *  - Run the window compares of the refresh watch (windowCompare()),
+ *    counting conversions and out-of-window events.
+ *  - Allow per-segment parameters so display spread can be reproduced.
+ *  - Couple the readings of neighbouring segments (setNeighbours()): a
+ *    static share of each neighbour potential and a share of its double-layer
+ *    polarisation, which fades after a pulse.
+ *  - Keep all state (clock, random generator) per object, so independent
+ *    boards can be simulated side by side, e.g. one per thread.
+ *  - Record the I/O issued by the engine as a trace of ECD_SimEvent, and
+ *    replay recorded ADC readings so engine decisions can be compared run
+ *    to run (regression of the refresh logic).
+ *  - Count safety-ordering violations: CE DAC changes or CE release while a
+ *    segment WE is still driven (segments must be High-Z first).
+ *  - Emulate one pending interrupt at a given device time (e.g. a cancel
+ *    request arriving in the middle of a pulse).
+ *  - Export traces as Value Change Dump (VCD) files for GTKWave.
+ *  - Simulate GPIO expanders carrying segment WE pins (ECD_SimExpanderBus),
+ *    with a bus timing model to check pulse synchronization across chips.
+ *  - Simulate analog muxes reading the OCP of expander pins (ECD_SimAnalogMux).
+ *
+ * Notes:
+ *  - Only compiled when YNV_ECD_SIMULATOR is defined (host builds); attach a
+ *    simulator to a YNV_ECD object with YNV_ECD::attachSimulator().
+ *  - Time is virtual: delay() advances the simulator clock and integrates the
+ *    model instantly, so simulations run much faster than real time. Device
+ *    time is read with millis() or micros(); host CPU time is unaffected.
+ *    Microsecond delays (mux settles, ADC conversions) are integrated once
+ *    they add up to a whole millisecond.
+ *  - Default parameters are representative of a Gen3 segment, not a fit of
+ *    any specific display. Aging is disabled by default; the aging rates
+ *    apply per full (bleach → color → bleach) equivalent cycle.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_SIMULATOR
+#define _YNVISIBLE_ECD_SIMULATOR
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+#include "YnvisibleECDExpander.h"
+#include "YnvisibleECDMux.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_SIM_MAX_SEGMENTS                MAX_NUMBER_OF_SEGMENTS  // Max number of simulated segments
+#define ECD_SIM_STEP_MS                     1             // (ms) Integration step of the equivalent circuit
+#define ECD_SIM_EXPANDER_TRANSACTION_US     140           // (us) Default expander transaction: MCP23017 frame at 400 kHz I2C
+#define ECD_SIM_VISIBLE_CHARGE              0.5f          // Charge state above which a segment looks colored
+
+
+// ---------------------------------------------------------------------------
+// Enumerations
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Hardware access recorded in a simulator trace.
+ */
+enum ECD_SimEventType : uint8_t {
+    ECD_SIM_EVENT_PIN_MODE = 0,                                     ///< pinMode(pin, value)
+    ECD_SIM_EVENT_DIGITAL_WRITE,                                    ///< digitalWrite(pin, value)
+    ECD_SIM_EVENT_ANALOG_WRITE,                                     ///< analogWrite(pin, value) (CE DAC code)
+    ECD_SIM_EVENT_ANALOG_READ,                                      ///< analogRead(pin) returned value
+    ECD_SIM_EVENT_DELAY,                                            ///< delay(value)
+    ECD_SIM_EVENT_PHASE                                             ///< Engine entered phase value (ecdDriverPhase_e)
+};
+
+
+// ---------------------------------------------------------------------------
+// Configuration Structures
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Equivalent-circuit parameters of a single segment.
+ *
+ * Potentials are given relative to the CE, as seen by check_refresh().
+ * The charge state is normalised: 0 = fully bleached, 1 = fully colored.
+ */
+struct ECD_SegmentModel {
+
+    float seriesResistance                  { 100.0f };     // (Ohm) Series resistance Rs (electrolyte + tracks)
+    float chargeTransferResistance          { 150.0f };     // (Ohm) Charge transfer resistance Rct
+    float doubleLayerCapacitance            { 500.0e-6f };  // (F) Double-layer capacitance Cdl
+    float chargeCapacity                    { 2.0e-3f };    // (C) Charge needed for a full bleach → color transition
+
+    float bleachedPotential                 { -0.6f };      // (V) OCP of a fully bleached segment
+    float coloredPotential                  { 1.2f };       // (V) OCP of a fully colored segment
+
+    float restCharge                        { 0.3f };       // Charge state reached by self-discharge (rest potential)
+    float selfDischargeTime                 { 3600000.0f }; // (ms) Self-discharge time constant
+
+    float capacityFade                      { 0.0f };       // Relative charge capacity lost per full cycle
+    float kineticsAging                     { 0.0f };       // Relative Rct increase per full cycle
+    float selfDischargeAging                { 0.0f };       // Relative self-discharge rate increase per full cycle
+
+    float neighbourCoupling                 { 0.0f };       // Share of each neighbour WE-CE potential in this segment reading
+    float polarisationCoupling              { 0.0f };       // Share of each neighbour double-layer voltage in this segment reading
+};
+
+/**
+ * @brief Manufacturing spread of the segment parameters.
+ *
+ * Relative standard deviations (e.g. 0.1 = 10 %) of normal distributions
+ * centred on a nominal ECD_SegmentModel. Potentials use absolute values (V).
+ */
+struct ECD_SegmentSpread {
+
+    float seriesResistance                  { 0.1f };       // Relative sigma of Rs
+    float chargeTransferResistance          { 0.1f };       // Relative sigma of Rct
+    float doubleLayerCapacitance            { 0.1f };       // Relative sigma of Cdl
+    float chargeCapacity                    { 0.1f };       // Relative sigma of the charge capacity
+    float coloredPotential                  { 0.02f };      // (V) Sigma of the colored OCP
+    float bleachedPotential                 { 0.02f };      // (V) Sigma of the bleached OCP
+    float selfDischargeTime                 { 0.2f };       // Relative sigma of the self-discharge time
+};
+
+
+/**
+ * @brief One hardware access issued by the driving engine.
+ *
+ * Field recordings (one event per line: time, type, pin, value) use the
+ * same layout, so they can be replayed with setReplayTrace().
+ */
+struct ECD_SimEvent {
+
+    unsigned long    timeMs;                                        // (ms) Device time of the access
+    ECD_SimEventType type;                                          // Kind of access
+    uint8_t          pin;                                           // Pin number
+    int              value;                                         // Mode, level, DAC/ADC code (LSB) or delay (ms)
+};
+
+
+// ---------------------------------------------------------------------------
+// Simulator Class
+// ---------------------------------------------------------------------------
+
+/**
+ * @class YNV_ECD_Simulator
+ * @brief Host-side model of the CE DAC, WE GPIOs and ADC of a Driver v5 board.
+ *
+ * Exposes Arduino-like I/O methods that the driving engine calls instead of
+ * the Arduino core when a simulator is attached.
+ */
+class YNV_ECD_Simulator {
+public:
+    YNV_ECD_Simulator();                                            ///< Constructor (no segments, CE on PIN_CE)
+
+    int   addSegment(int t_pin);                                    ///< Register a WE pin, returns segment index or -1
+    void  setSegmentModel(int t_segment, const ECD_SegmentModel& t_model); ///< Set the parameters of one segment
+    void  setAllSegmentsModel(const ECD_SegmentModel& t_model);     ///< Set the parameters of all segments
+    void  applySegmentSpread(const ECD_SegmentModel& t_nominal, const ECD_SegmentSpread& t_spread, uint32_t t_seed); ///< Draw parameters around a nominal model
+    void  setSegmentCharge(int t_segment, float t_charge);          ///< Force the charge state (0..1) of a segment
+    void  setSegmentCycles(int t_segment, float t_cycles);          ///< Force the age (full equivalent cycles) of a segment
+    void  setNeighbours(const ecdSegmentMask_t* t_neighbours);      ///< Adjacency of the segments (copied, nullptr = none), as YNV_ECD::setNeighbours()
+    void  setCounterElectrodePin(int t_pin) { m_counterElectrodePin = t_pin; } ///< Select the CE (DAC) pin
+    void  setSupplyVoltage(float t_voltage) { m_supplyVoltage = t_voltage; }   ///< Supply used for DAC/ADC scaling
+    void  setAdcNoise(float t_sigmaLsb, uint32_t t_seed = 1);       ///< Gaussian noise (LSB rms) added to the segment readings (0 = none)
+    void  setAdcConversionTime(unsigned int t_micros) { m_adcConversionMicros = t_micros; } ///< (us) Device time of one analogRead() (0 = none)
+
+    void  pinMode(int t_pin, int t_mode);                           ///< Simulated pinMode()
+    void  digitalWrite(int t_pin, int t_level);                     ///< Simulated digitalWrite()
+    void  analogWrite(int t_pin, int t_value);                      ///< Simulated analogWrite() (CE DAC)
+    int   analogRead(int t_pin);                                    ///< Simulated analogRead() (WE OCP in LSB)
+    bool  windowCompare(int t_pin, int t_low, int t_high, int& t_value); ///< Refresh watch compare (one conversion), true on an event
+
+    void  delay(unsigned long t_ms);                                ///< Simulated delay() (no real waiting)
+    void  delayMicroseconds(unsigned long t_us);                    ///< Simulated delayMicroseconds() (not traced)
+    unsigned long millis() const { return m_timeMs; }               ///< Simulated millis() (virtual device time)
+    unsigned long micros() const { return m_timeMs * 1000UL + m_subMillisMicros; } ///< Simulated micros() (virtual device time)
+    void  setDriverPhase(int t_phase);                              ///< Phase reported by the engine (ecdDriverPhase_e)
+    int   getDriverPhase() const { return m_driverPhase; }          ///< Last phase reported by the engine
+    void  advanceTime(unsigned long t_ms);                          ///< Advance the virtual clock and integrate the model
+    void  scheduleInterrupt(unsigned long t_timeMs, void (*t_handler)(void*), void* t_context); ///< Call a handler when the clock reaches t_timeMs
+
+    int   getNumberOfSegments() const { return m_numberOfSegments; }
+    float getSegmentCharge(int t_segment) const;                    ///< Charge state (0..1) of a segment
+    float getSegmentOcp(int t_segment) const;                       ///< Open-circuit WE-CE potential (V) of a segment
+    bool  isSegmentVisiblyColored(int t_segment) const;             ///< Segment looks colored (charge above ECD_SIM_VISIBLE_CHARGE)
+    float getSegmentCycles(int t_segment) const;                    ///< Age of a segment in full equivalent cycles
+    bool  anySegmentDriven(void) const;                             ///< At least one WE in OUTPUT mode
+    bool  isCounterElectrodeEnabled() const { return m_counterElectrodeEnabled; } ///< CE DAC driving (not High-Z)
+    float getChargeDelivered() const { return m_chargeDelivered; }  ///< (C) Charge moved through all segments
+    void  resetChargeDelivered() { m_chargeDelivered = 0.0f; }      ///< Clear the delivered charge counter
+    unsigned int getSafetyViolations() const { return m_safetyViolations; } ///< CE changes while a WE was driven
+    void  resetSafetyViolations() { m_safetyViolations = 0; }       ///< Clear the safety violation counter
+    unsigned long getAdcConversions() const { return m_adcConversions; }               ///< analogRead() conversions (window compares included)
+    void  resetAdcConversions() { m_adcConversions = 0; }           ///< Clear the conversion counter
+    unsigned long getComparatorConversions() const { return m_comparatorConversions; } ///< windowCompare() conversions
+    unsigned long getComparatorEvents() const { return m_comparatorEvents; }           ///< windowCompare() values outside the window
+    void  resetComparatorStats() { m_comparatorConversions = 0; m_comparatorEvents = 0; } ///< Clear the comparator counters
+
+    void  setTraceBuffer(ECD_SimEvent* t_buffer, unsigned int t_capacity); ///< Record I/O events into a caller buffer (nullptr stops)
+    void  clearTrace() { m_traceLength = 0; m_traceDropped = 0; }   ///< Empty the trace buffer
+    unsigned int getTraceLength() const { return m_traceLength; }   ///< Number of recorded events
+    unsigned int getTraceDropped() const { return m_traceDropped; } ///< Events lost because the buffer was full
+    void  setReplayTrace(const ECD_SimEvent* t_trace, unsigned int t_length); ///< Serve analogRead() from a recorded trace (nullptr stops)
+    unsigned int getReplayMisses() const { return m_replayMisses; } ///< Reads not found in the replayed trace (model used)
+
+    static int  findTraceDivergence(const ECD_SimEvent* t_expected, unsigned int t_expectedLength,
+                                    const ECD_SimEvent* t_actual, unsigned int t_actualLength,
+                                    unsigned long t_toleranceMs = 0); ///< First differing event or -1
+    static void printTraceEvent(Print& t_out, const ECD_SimEvent& t_event); ///< Print one event as "time,type,pin,value"
+    static void writeTraceVcd(Print& t_out, const ECD_SimEvent* t_trace, unsigned int t_length); ///< Write a trace as a VCD file
+
+private:
+    /**
+     * @brief Dynamic state of one simulated segment.
+     */
+    struct SegmentState {
+        ECD_SegmentModel model;
+        int   pin;
+        bool  output;                                               // WE driven (OUTPUT) or High-Z (INPUT)
+        bool  level;                                                // WE output level (HIGH = supply, LOW = 0 V)
+        float charge;                                               // Normalised charge state (0..1)
+        float doubleLayerVoltage;                                   // (V) Voltage across Cdl
+        float cycles;                                               // Full equivalent cycles (faradaic charge / 2 Q)
+        ecdSegmentMask_t neighbours;                                // Segments coupled into its reading (bit per segment)
+    };
+
+    void  integrateDriven(SegmentState& t_seg, unsigned long t_ms); ///< Step-by-step integration of a driven segment
+    void  integrateIdle(SegmentState& t_seg, unsigned long t_ms);   ///< Closed-form integration of an open-circuit segment
+    int   findSegment(int t_pin) const;                             ///< Segment index of a WE pin or -1
+    float counterElectrodeVoltage(void) const;                      ///< (V) Current CE DAC output
+    float equilibriumPotential(const SegmentState& t_seg) const;    ///< (V) OCP for the segment charge state
+    float weVoltage(const SegmentState& t_seg) const;               ///< (V) WE voltage of a segment alone (no coupling)
+    ECD_SegmentModel agedModel(const SegmentState& t_seg) const;    ///< Parameters after aging of the segment
+    static float randomUniform(uint32_t& t_state);                  ///< Uniform random number in [-1, 1)
+    static float randomNormal(uint32_t& t_state);                   ///< Standard normal random number
+    void  integrateAll(unsigned long t_ms);                         ///< Integrate every segment and advance the clock
+    void  recordEvent(ECD_SimEventType t_type, int t_pin, int t_value); ///< Append an event to the trace buffer
+    bool  nextReplayReading(int t_pin, int& t_value);               ///< Next recorded analogRead() of a pin
+    static void writeVcdBus(Print& t_out, int t_value, int t_bits, char t_id); ///< VCD bus value change
+    static int  vcdPinIndex(const int* t_pins, int t_count, int t_pin);         ///< Index of a pin in a list or -1
+
+    SegmentState  m_segments           [ECD_SIM_MAX_SEGMENTS];
+    int           m_numberOfSegments   {0};
+    int           m_counterElectrodePin;
+    bool          m_counterElectrodeEnabled {false};
+    int           m_counterElectrodeLSB {ADC_DAC_MAX_LSB / 2};
+    float         m_supplyVoltage      {SUPPLY_VOLTAGE};
+    unsigned long m_timeMs             {0};
+    unsigned long m_subMillisMicros    {0};                         // (us) Microsecond delays not yet integrated (< 1 ms)
+    unsigned int  m_adcConversionMicros {0};                        // (us) Device time of one analogRead()
+    float         m_chargeDelivered    {0.0f};
+    uint32_t      m_randomState        {1};
+    float         m_adcNoiseLsb        {0.0f};                      // (LSB rms) Noise of the segment readings
+    uint32_t      m_noiseState         {1};                         // Noise generator (independent of the spread)
+    unsigned int  m_safetyViolations   {0};
+    unsigned long m_adcConversions     {0};
+    unsigned long m_comparatorConversions {0};
+    unsigned long m_comparatorEvents   {0};
+    int           m_driverPhase        {0};
+
+    void          (*m_interruptHandler)(void*) {nullptr};           // Pending simulated interrupt
+    void*         m_interruptContext   {nullptr};
+    unsigned long m_interruptTimeMs    {0};
+
+    ECD_SimEvent*       m_trace          {nullptr};                 // Trace buffer (caller owned)
+    unsigned int        m_traceCapacity  {0};
+    unsigned int        m_traceLength    {0};
+    unsigned int        m_traceDropped   {0};
+    const ECD_SimEvent* m_replay         {nullptr};                 // Replayed trace (caller owned)
+    unsigned int        m_replayLength   {0};
+    unsigned int        m_replayPosition {0};
+    unsigned int        m_replayMisses   {0};
+};
+
+
+// ---------------------------------------------------------------------------
+// Simulated GPIO Expanders
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_SimExpanderBus
+ * @brief Expander bus whose outputs are segment WE pins of a YNV_ECD_Simulator.
+ *
+ * Output i of chip c is the simulator pin ECD_EXPANDER_PIN(c, i). A
+ * transaction applies the level changes, then the enable changes, like the
+ * OLAT-then-IODIR frame of an MCP23x17. A microsecond bus clock (simulator
+ * time plus transactionMicros() per transaction) gives the switching time of
+ * every chip, from which the pulse width of each chip and the largest width
+ * difference between the chips of one pulse are kept.
+ */
+class ECD_SimExpanderBus : public ECD_ExpanderBus {
+public:
+    ECD_SimExpanderBus(YNV_ECD_Simulator& t_simulator, unsigned long t_transactionMicros = ECD_SIM_EXPANDER_TRANSACTION_US);
+
+    void  begin(uint8_t t_numberOfChips) override;                  ///< All outputs released, statistics cleared
+    void  writeChip(uint8_t t_chip, uint16_t t_level, uint16_t t_outputs) override; ///< Apply one chip transaction to the simulator
+    unsigned long transactionMicros(void) const override { return m_transactionMicros; }
+
+    static int readOcp(int t_pin, void* t_simulator);               ///< Ideal OCP path for setOcpReader() (simulator analogRead())
+
+    unsigned long getTransactions(uint8_t t_chip) const;            ///< Transactions to one chip
+    unsigned long getLastPulseMicros(uint8_t t_chip) const;         ///< (us) Width of the last completed pulse of one chip
+    unsigned long getMaxPulseMismatchMicros() const { return m_maxMismatchMicros; } ///< (us) Largest width difference between chips of one pulse
+    void  resetStats();                                             ///< Clear transaction and pulse statistics
+
+private:
+    YNV_ECD_Simulator& m_simulator;
+    unsigned long m_transactionMicros;
+    unsigned long m_busMicros          {0};                         // (us) Time the bus becomes free
+    uint16_t      m_level              [ECD_EXPANDER_MAX_CHIPS] {};
+    uint16_t      m_outputs            [ECD_EXPANDER_MAX_CHIPS] {};
+    unsigned long m_transactions       [ECD_EXPANDER_MAX_CHIPS] {};
+    unsigned long m_enableMicros       [ECD_EXPANDER_MAX_CHIPS] {};  // (us) Start of the current pulse of each chip
+    unsigned long m_lastPulseMicros    [ECD_EXPANDER_MAX_CHIPS] {};
+    uint8_t       m_pulseChips         {0};                         // Chips with driven outputs (bit per chip)
+    unsigned long m_pulseMinMicros     {0};                         // (us) Shortest / longest width in the current pulse
+    unsigned long m_pulseMaxMicros     {0};
+    bool          m_pulseWidthSeen     {false};
+    unsigned long m_maxMismatchMicros  {0};
+};
+
+
+/**
+ * @class ECD_SimAnalogMux
+ * @brief ECD_AnalogMux whose mux outputs read the simulated segments.
+ *
+ * readInput() returns the simulator analogRead() of the expander pin wired
+ * to the selected channel of the mux, so a wrong schedule reads the wrong
+ * segment. Settling advances the simulator clock (delayMicroseconds()), so
+ * a sweep can be timed with micros(). Implemented in YnvisibleECDMux.cpp.
+ */
+class ECD_SimAnalogMux : public ECD_AnalogMux {
+public:
+    ECD_SimAnalogMux(YNV_ECD_Simulator& t_simulator, uint8_t t_selectBits, uint8_t t_numberOfMuxes,
+                     unsigned int t_settleMicros = ECD_MUX_DEFAULT_SETTLE_US);
+
+protected:
+    void writeSelect(uint8_t t_line, int t_level) override { (void)t_line; (void)t_level; }
+    void settle(unsigned int t_micros) override { m_simulator.delayMicroseconds(t_micros); }
+    int  readInput(uint8_t t_mux) override;
+
+private:
+    YNV_ECD_Simulator& m_simulator;
+};
+
+#endif // _YNVISIBLE_ECD_SIMULATOR
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,496 @@
+
+/**
+ * @file YnvisibleECDSync.cpp
+ * @brief Synchronized updates of displays spread over several Driver v5 boards.
+ *
+ * This file implements the classes declared in YnvisibleECDSync.h: the
+ * Stream framing of sync messages, the board side (staging, timed start,
+ * reports) and the coordinator side (clock offsets, commits, skew).
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#include "Arduino.h"
+#include "YnvisibleECDSync.h"
+
+
+/***************************************************************************/
+/******************************** HELPERS **********************************/
+/***************************************************************************/
+
+static void putWord32(uint8_t* t_bytes, uint32_t t_value)         // Little-endian
+{
+  for (int i = 0; i < 4; i++) {
+    t_bytes[i] = (uint8_t)(t_value >> (8 * i));
+  }
+}
+
+static uint32_t getWord32(const uint8_t* t_bytes)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= (uint32_t)t_bytes[i] << (8 * i);
+  }
+  return value;
+}
+
+
+/***************************************************************************/
+/************************** ECD_StreamSyncLink *****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Write one message: start byte, type, board, sequence, time, value
+ * (little-endian), XOR of the 13 message bytes.
+ */
+/***************************************************************************/
+
+void ECD_StreamSyncLink::send(const ECD_SyncMessage& t_message)
+{
+  uint8_t frame[ECD_SYNC_WIRE_BYTES];
+  uint8_t checksum = 0;
+
+  frame[0] = ECD_SYNC_START_BYTE;
+  frame[1] = t_message.type;
+  frame[2] = t_message.board;
+  frame[3] = (uint8_t)(t_message.sequence & 0xFF);
+  frame[4] = (uint8_t)(t_message.sequence >> 8);
+  putWord32(&frame[5], t_message.time);
+  putWord32(&frame[9], t_message.value);
+  for (int i = 1; i < ECD_SYNC_WIRE_BYTES - 1; i++) {
+    checksum ^= frame[i];
+  }
+  frame[ECD_SYNC_WIRE_BYTES - 1] = checksum;
+
+  m_stream.write(frame, ECD_SYNC_WIRE_BYTES);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Read the available bytes; frames with a bad checksum are dropped
+ * and the next start byte is searched.
+ */
+/***************************************************************************/
+
+bool ECD_StreamSyncLink::receive(ECD_SyncMessage& t_message)
+{
+  while (m_stream.available() > 0) {
+    uint8_t byte = (uint8_t)m_stream.read();
+
+    if (m_length == 0 && byte != ECD_SYNC_START_BYTE) {
+      continue;
+    }
+    m_buffer[m_length++] = byte;
+    if (m_length < ECD_SYNC_WIRE_BYTES) {
+      continue;
+    }
+    m_length = 0;
+
+    uint8_t checksum = 0;
+    for (int i = 1; i < ECD_SYNC_WIRE_BYTES - 1; i++) {
+      checksum ^= m_buffer[i];
+    }
+    if (checksum != m_buffer[ECD_SYNC_WIRE_BYTES - 1]) {
+      continue;
+    }
+    t_message.type     = m_buffer[1];
+    t_message.board    = m_buffer[2];
+    t_message.sequence = (uint16_t)(m_buffer[3] | (m_buffer[4] << 8));
+    t_message.time     = getWord32(&m_buffer[5]);
+    t_message.value    = getWord32(&m_buffer[9]);
+    return true;
+  }
+  return false;
+}
+
+
+/***************************************************************************/
+/***************************** ECD_SyncBoard *******************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Board side of the sync protocol.
+ *
+ * @param t_display Display of this board
+ * @param t_link Link to the coordinator
+ * @param t_boardId Board id (0..ECD_SYNC_MAX_BOARDS-1)
+ */
+/***************************************************************************/
+
+ECD_SyncBoard::ECD_SyncBoard(YNV_ECD& t_display, ECD_SyncLink& t_link, uint8_t t_boardId)
+  : m_display(t_display), m_link(t_link), m_boardId(t_boardId)
+{
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Handle every received message addressed to this board.
+ */
+/***************************************************************************/
+
+void ECD_SyncBoard::poll()
+{
+  ECD_SyncMessage message;
+
+  while (m_link.receive(message)) {
+    if (message.board != m_boardId && message.board != ECD_SYNC_BROADCAST) {
+      continue;
+    }
+
+    switch (message.type) {
+      case ECD_SYNC_MSG_PING:
+        reply(ECD_SYNC_MSG_PONG, 0, message.time, (uint32_t)m_display.getHal().millis());
+        break;
+
+      case ECD_SYNC_MSG_OFFSET:
+        m_clockOffset  = (long)(int32_t)message.value;
+        m_synchronized = true;
+        break;
+
+      case ECD_SYNC_MSG_FRAME:
+        stageChunk(message);
+        break;
+
+      case ECD_SYNC_MSG_COMMIT:
+        if (message.sequence != m_frameSequence || !frameComplete()) {
+          m_refused         = true;                                 // Stale or partial frame: keep the display as is
+          m_refusedSequence = message.sequence;
+          m_refusedCommits++;
+          break;
+        }
+        for (int i = 0; i < m_frameSegments; i++) {                 // Out-of-range segments are ignored
+          m_display.setSegmentState(i, (m_frameStates >> i) & 1);
+        }
+        m_frameSegments = 0;                                        // Frame consumed
+        m_refused   = false;
+        m_sequence  = message.sequence;
+        m_onTrigger = (message.time == ECD_SYNC_ON_TRIGGER);
+        m_triggered = false;
+        m_startMs   = message.time + (unsigned long)m_clockOffset;   // Coordinator tick on the board clock
+        m_armed     = true;
+        break;
+
+      case ECD_SYNC_MSG_STATUS:
+        if (m_refused) {
+          reply(ECD_SYNC_MSG_NAK, m_refusedSequence, m_frameSequence, m_frameChunks);
+          break;
+        }
+        reply(ECD_SYNC_MSG_DONE, m_completedSequence,
+              (uint32_t)(m_lastStartMs - (unsigned long)m_clockOffset),
+              (uint32_t)(m_lastEndMs - (unsigned long)m_clockOffset));
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Execute the committed update when due.
+ * @returns true if executeDisplay() ran
+ */
+/***************************************************************************/
+
+bool ECD_SyncBoard::run()
+{
+  ECD_Hal& hal = m_display.getHal();
+
+  if (!m_armed) {
+    return false;
+  }
+  if (m_onTrigger) {
+    if (!m_triggered) {
+      return false;
+    }
+  }
+  else {
+    if ((long)(m_startMs - hal.millis()) > ECD_SYNC_WAIT_MS) {
+      return false;
+    }
+    hal.waitUntil(m_startMs);                                     // Returns at once if already late
+  }
+
+  m_armed       = false;
+  m_lastStartMs = hal.millis();
+  m_display.executeDisplay();
+  m_lastEndMs   = hal.millis();
+  m_completedSequence = m_sequence;
+  return true;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Start an update committed with ECD_SYNC_ON_TRIGGER (call from the
+ * trigger line interrupt).
+ */
+/***************************************************************************/
+
+void ECD_SyncBoard::trigger()
+{
+  m_triggered = true;
+}
+
+
+void ECD_SyncBoard::reply(uint8_t t_type, uint16_t t_sequence, uint32_t t_time, uint32_t t_value)
+{
+  ECD_SyncMessage message;
+
+  message.type     = t_type;
+  message.board    = m_boardId;
+  message.sequence = t_sequence;
+  message.time     = t_time;
+  message.value    = t_value;
+  m_link.send(message);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Buffer one FRAME message. A chunk of another sequence or frame
+ * size starts a new frame: the chunks of a frame that was never committed
+ * are dropped.
+ */
+/***************************************************************************/
+
+void ECD_SyncBoard::stageChunk(const ECD_SyncMessage& t_message)
+{
+  int first    = (int)(t_message.time & 0xFFFF);
+  int segments = min((int)(t_message.time >> 16), MAX_NUMBER_OF_SEGMENTS);
+
+  if (t_message.sequence != m_frameSequence || segments != m_frameSegments) {
+    m_frameSequence = t_message.sequence;
+    m_frameSegments = (uint16_t)segments;
+    m_frameChunks   = 0;
+    m_frameStates   = 0;
+  }
+  if (first % ECD_SYNC_FRAME_SEGMENTS != 0 || first >= segments) {
+    return;
+  }
+  for (int i = 0; i < ECD_SYNC_FRAME_SEGMENTS && first + i < segments; i++) {
+    ecdSegmentMask_t bit = (ecdSegmentMask_t)1 << (first + i);
+    m_frameStates = (t_message.value & (1ul << i)) ? (m_frameStates | bit) : (m_frameStates & ~bit);
+  }
+  m_frameChunks |= (uint8_t)(1 << (first / ECD_SYNC_FRAME_SEGMENTS));
+}
+
+
+bool ECD_SyncBoard::frameComplete() const
+{
+  int chunks = (m_frameSegments + ECD_SYNC_FRAME_SEGMENTS - 1) / ECD_SYNC_FRAME_SEGMENTS;
+  return m_frameSegments > 0 && m_frameChunks == (uint8_t)((1 << chunks) - 1);
+}
+
+
+/***************************************************************************/
+/************************** ECD_SyncCoordinator ****************************/
+/***************************************************************************/
+
+/***************************************************************************/
+/**
+ * @brief Coordinator side of the sync protocol.
+ *
+ * @param t_link Link to the boards
+ * @param t_numberOfBoards Boards 0..t_numberOfBoards-1 (up to ECD_SYNC_MAX_BOARDS)
+ * @param t_clock Coordinator clock in ms (nullptr = millis())
+ */
+/***************************************************************************/
+
+ECD_SyncCoordinator::ECD_SyncCoordinator(ECD_SyncLink& t_link, uint8_t t_numberOfBoards, unsigned long (*t_clock)(void))
+  : m_link(t_link), m_clock(t_clock)
+{
+  m_numberOfBoards = constrain(t_numberOfBoards, 1, ECD_SYNC_MAX_BOARDS);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Handle replies: PONG gives the offset of a board (sent back to it),
+ * DONE the times of its last update.
+ */
+/***************************************************************************/
+
+void ECD_SyncCoordinator::poll()
+{
+  ECD_SyncMessage message;
+
+  while (m_link.receive(message)) {
+    if (message.board >= m_numberOfBoards) {
+      continue;
+    }
+
+    switch (message.type) {
+      case ECD_SYNC_MSG_PONG: {
+        unsigned long sent     = message.time;
+        unsigned long received = now();
+        long offset = (long)(message.value - (sent + (received - sent) / 2)); // Board time at the middle of the round trip
+        m_clockOffset[message.board] = offset;
+        send(ECD_SYNC_MSG_OFFSET, message.board, 0, 0, (uint32_t)offset);
+        break;
+      }
+
+      case ECD_SYNC_MSG_DONE:
+        m_doneSequence[message.board]   = message.sequence;
+        m_startTime[message.board]      = message.time;
+        m_completionTime[message.board] = message.value;
+        break;
+
+      case ECD_SYNC_MSG_NAK:
+        m_refusedSequence[message.board] = message.sequence;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+
+void ECD_SyncCoordinator::syncClock(uint8_t t_board)
+{
+  send(ECD_SYNC_MSG_PING, t_board, 0, (uint32_t)now(), 0);
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Stage the next frame of one board (ECD_SYNC_FRAME_SEGMENTS states
+ * per message). Every board must be staged before each commit: a board
+ * without the complete frame of the committed sequence refuses it.
+ */
+/***************************************************************************/
+
+void ECD_SyncCoordinator::stageFrame(uint8_t t_board, const bool* t_states, int t_count)
+{
+  t_count = constrain(t_count, 0, MAX_NUMBER_OF_SEGMENTS);
+  for (int first = 0; first < t_count; first += ECD_SYNC_FRAME_SEGMENTS) {
+    uint32_t states = 0;
+    for (int i = 0; i < ECD_SYNC_FRAME_SEGMENTS && first + i < t_count; i++) {
+      if (t_states[first + i]) {
+        states |= (1ul << i);
+      }
+    }
+    send(ECD_SYNC_MSG_FRAME, t_board, (uint16_t)(m_sequence + 1), (uint32_t)first | ((uint32_t)t_count << 16), states);
+  }
+}
+
+
+uint16_t ECD_SyncCoordinator::commit(unsigned long t_leadMs)
+{
+  m_sequence++;
+  send(ECD_SYNC_MSG_COMMIT, ECD_SYNC_BROADCAST, m_sequence, (uint32_t)(now() + t_leadMs), 0);
+  return m_sequence;
+}
+
+
+uint16_t ECD_SyncCoordinator::commitOnTrigger()
+{
+  m_sequence++;
+  send(ECD_SYNC_MSG_COMMIT, ECD_SYNC_BROADCAST, m_sequence, ECD_SYNC_ON_TRIGGER, 0);
+  return m_sequence;
+}
+
+
+void ECD_SyncCoordinator::requestStatus(uint8_t t_board)
+{
+  send(ECD_SYNC_MSG_STATUS, t_board, 0, 0, 0);
+}
+
+
+bool ECD_SyncCoordinator::isDone(uint8_t t_board, uint16_t t_sequence) const
+{
+  return t_board < m_numberOfBoards && m_doneSequence[t_board] == t_sequence;
+}
+
+
+bool ECD_SyncCoordinator::isRefused(uint8_t t_board, uint16_t t_sequence) const
+{
+  return t_board < m_numberOfBoards && m_refusedSequence[t_board] == t_sequence;
+}
+
+
+bool ECD_SyncCoordinator::allDone(uint16_t t_sequence) const
+{
+  for (uint8_t board = 0; board < m_numberOfBoards; board++) {
+    if (m_doneSequence[board] != t_sequence) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+unsigned long ECD_SyncCoordinator::getStartTime(uint8_t t_board) const
+{
+  return (t_board < m_numberOfBoards) ? m_startTime[t_board] : 0;
+}
+
+unsigned long ECD_SyncCoordinator::getCompletionTime(uint8_t t_board) const
+{
+  return (t_board < m_numberOfBoards) ? m_completionTime[t_board] : 0;
+}
+
+unsigned long ECD_SyncCoordinator::getStartSkew(uint16_t t_sequence) const
+{
+  return spread(m_startTime, t_sequence);
+}
+
+unsigned long ECD_SyncCoordinator::getCompletionSkew(uint16_t t_sequence) const
+{
+  return spread(m_completionTime, t_sequence);
+}
+
+long ECD_SyncCoordinator::getClockOffset(uint8_t t_board) const
+{
+  return (t_board < m_numberOfBoards) ? m_clockOffset[t_board] : 0;
+}
+
+
+/***************************************************************************/
+/**************************** PRIVATE FUNCTIONS ****************************/
+/***************************************************************************/
+
+void ECD_SyncCoordinator::send(uint8_t t_type, uint8_t t_board, uint16_t t_sequence, uint32_t t_time, uint32_t t_value)
+{
+  ECD_SyncMessage message;
+
+  message.type     = t_type;
+  message.board    = t_board;
+  message.sequence = t_sequence;
+  message.time     = t_time;
+  message.value    = t_value;
+  m_link.send(message);
+}
+
+
+/**
+ * @brief Max - min of the reported times of the boards that finished t_sequence.
+ */
+unsigned long ECD_SyncCoordinator::spread(const unsigned long* t_times, uint16_t t_sequence) const
+{
+  bool          any      = false;
+  unsigned long earliest = 0;
+  unsigned long latest   = 0;
+
+  for (uint8_t board = 0; board < m_numberOfBoards; board++) {
+    if (m_doneSequence[board] != t_sequence) {
+      continue;
+    }
+    if (!any || (long)(t_times[board] - earliest) < 0) { earliest = t_times[board]; }
+    if (!any || (long)(t_times[board] - latest) > 0)   { latest   = t_times[board]; }
+    any = true;
+  }
+  return latest - earliest;
+}
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -0,0 +1,220 @@
+
+/**
+ * @file YnvisibleECDSync.h
+ * @brief Synchronized updates of displays spread over several Driver v5 boards.
+ *
+ * A coordinator (one of the boards or a host) stages the next frame on every
+ * board, then commits it for a common start tick; each board starts its
+ * executeDisplay() at that tick and reports when it finished.
+ *
+ * Protocol (ECD_SyncMessage over an ECD_SyncLink):
+ *  - PING / PONG / OFFSET: the coordinator estimates the clock offset of a
+ *    board from one round trip (local time of the board against the middle
+ *    of the round trip) and sends it to the board.
+ *  - FRAME: 32 segment states of a board for the next update sequence,
+ *    with the segment count of the whole frame. The board buffers the chunks
+ *    and records which ones arrived.
+ *  - COMMIT (broadcast): start tick in coordinator time, converted by every
+ *    board to its own clock; or ECD_SYNC_ON_TRIGGER to start on a shared
+ *    trigger line instead (the line ISR calls ECD_SyncBoard::trigger()).
+ *    A board only applies the staged frame and arms when every chunk of the
+ *    frame of that sequence arrived; otherwise (e.g. a FRAME dropped for a
+ *    bad checksum) it refuses the commit and keeps its display unchanged.
+ *  - STATUS / DONE / NAK: start and completion time of the last update of a
+ *    board, in coordinator time, or NAK if the last commit was refused.
+ *
+ * Boards only send when addressed, so one half-duplex bus (e.g. RS-485 on a
+ * serial port, ECD_StreamSyncLink) can chain all boards.
+ *
+ * Start skew between boards:
+ *  - Tick commit: clock offset error (up to half the round-trip asymmetry)
+ *    plus clock drift since the last syncClock(); the commit lead time must
+ *    exceed the link latency.
+ *  - Trigger line: interrupt latency only.
+ *
+ * Created by Ynvisible (Oct 2026)
+ */
+
+#ifndef _YNVISIBLE_ECD_SYNC
+#define _YNVISIBLE_ECD_SYNC
+
+#include "Arduino.h"
+#include "YnvisibleECD.h"
+
+
+// ---------------------------------------------------------------------------
+// Static Configuration Macros
+// ---------------------------------------------------------------------------
+
+#define ECD_SYNC_MAX_BOARDS                 8             // Boards per coordinator
+#define ECD_SYNC_BROADCAST                  0xFF          // Board id of messages to every board
+#define ECD_SYNC_ON_TRIGGER                 0xFFFFFFFFUL  // COMMIT time: start on the trigger line
+#define ECD_SYNC_WAIT_MS                    5             // (ms) ECD_SyncBoard::run() blocks for a start closer than this
+#define ECD_SYNC_FRAME_SEGMENTS             32            // Segment states per FRAME message
+#define ECD_SYNC_START_BYTE                 0xA5          // ECD_StreamSyncLink frame marker
+#define ECD_SYNC_WIRE_BYTES                 15            // ECD_StreamSyncLink frame: marker, 13 bytes, checksum
+
+
+// ---------------------------------------------------------------------------
+// Messages & Transport
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Message types of the sync protocol.
+ */
+enum ecdSyncMessage_e {
+    ECD_SYNC_MSG_PING   = 0,    // Coordinator → board: time = coordinator time
+    ECD_SYNC_MSG_PONG   = 1,    // Board → coordinator: time = PING time, value = board time
+    ECD_SYNC_MSG_OFFSET = 2,    // Coordinator → board: value = board time - coordinator time
+    ECD_SYNC_MSG_FRAME  = 3,    // Coordinator → board: sequence, time = first segment | frame segments << 16, value = states (bit i)
+    ECD_SYNC_MSG_COMMIT = 4,    // Coordinator → all: sequence, time = start tick or ECD_SYNC_ON_TRIGGER
+    ECD_SYNC_MSG_STATUS = 5,    // Coordinator → board: report the last update
+    ECD_SYNC_MSG_DONE   = 6,    // Board → coordinator: sequence, time = start, value = completion
+    ECD_SYNC_MSG_NAK    = 7     // Board → coordinator: refused COMMIT sequence, time = staged sequence, value = chunks received (bit i)
+};
+
+/**
+ * @brief One protocol message (all times in ms).
+ */
+struct ECD_SyncMessage {
+
+    uint8_t  type                           { 0 };                              // ecdSyncMessage_e
+    uint8_t  board                          { 0 };                              // Addressed or sending board (ECD_SYNC_BROADCAST = all)
+    uint16_t sequence                       { 0 };                              // Update sequence number
+    uint32_t time                           { 0 };                              // See ecdSyncMessage_e
+    uint32_t value                          { 0 };                              // See ecdSyncMessage_e
+};
+
+/**
+ * @class ECD_SyncLink
+ * @brief Message transport between the coordinator and the boards.
+ */
+class ECD_SyncLink {
+public:
+    virtual ~ECD_SyncLink() {}
+    virtual void send(const ECD_SyncMessage& t_message) = 0;        ///< Queue one message
+    virtual bool receive(ECD_SyncMessage& t_message) = 0;           ///< Next received message, false if none (non-blocking)
+};
+
+/**
+ * @class ECD_StreamSyncLink
+ * @brief Sync messages over a Stream (serial port, RS-485 transceiver),
+ * framed with a start byte and an XOR checksum.
+ */
+class ECD_StreamSyncLink : public ECD_SyncLink {
+public:
+    explicit ECD_StreamSyncLink(Stream& t_stream) : m_stream(t_stream) {}
+
+    void send(const ECD_SyncMessage& t_message) override;
+    bool receive(ECD_SyncMessage& t_message) override;
+
+private:
+    Stream&  m_stream;
+    uint8_t  m_buffer[ECD_SYNC_WIRE_BYTES];
+    uint8_t  m_length                       {0};
+};
+
+
+// ---------------------------------------------------------------------------
+// Board & Coordinator
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ECD_SyncBoard
+ * @brief Board side: stages frames, starts committed updates on time, reports.
+ *
+ * Call poll() and run() from loop(); run() executes a committed update once
+ * its start is less than ECD_SYNC_WAIT_MS away (waiting on the backend clock
+ * for the exact tick) or once triggered. FRAME chunks are buffered and only
+ * reach the display with a COMMIT of the same sequence that finds the frame
+ * complete.
+ */
+class ECD_SyncBoard {
+public:
+    ECD_SyncBoard(YNV_ECD& t_display, ECD_SyncLink& t_link, uint8_t t_boardId);
+
+    void poll(void);                                                ///< Handle received messages
+    bool run(void);                                                 ///< Execute a due update, true if one ran
+    void trigger(void);                                             ///< Trigger line edge (ISR safe)
+
+    bool     isSynchronized(void) const { return m_synchronized; }  ///< Clock offset received
+    long     getClockOffset(void) const { return m_clockOffset; }   ///< (ms) Board time - coordinator time
+    bool     isArmed(void) const { return m_armed; }                ///< Update committed, not started
+    uint16_t getCompletedSequence(void) const { return m_completedSequence; } ///< Sequence of the last update
+    unsigned long getLastStartMs(void) const { return m_lastStartMs; }        ///< (ms) Board time of the last start
+    unsigned long getLastEndMs(void) const { return m_lastEndMs; }            ///< (ms) Board time of the last completion
+    unsigned long getRefusedCommits(void) const { return m_refusedCommits; }  ///< COMMITs refused (stale or partial frame)
+
+private:
+    void reply(uint8_t t_type, uint16_t t_sequence, uint32_t t_time, uint32_t t_value); ///< Send to the coordinator
+    void stageChunk(const ECD_SyncMessage& t_message);              ///< Buffer one FRAME message
+    bool frameComplete(void) const;                                 ///< Every chunk of the staged frame received
+
+    YNV_ECD&      m_display;
+    ECD_SyncLink& m_link;
+    uint8_t       m_boardId;
+    long          m_clockOffset         {0};
+    bool          m_synchronized        {false};
+    bool          m_armed               {false};
+    bool          m_onTrigger           {false};
+    volatile bool m_triggered           {false};
+    uint16_t      m_sequence            {0};                        // Committed update
+    uint16_t      m_completedSequence   {0};
+    unsigned long m_startMs             {0};                        // (ms) Board time of the committed start
+    unsigned long m_lastStartMs         {0};
+    unsigned long m_lastEndMs           {0};
+    uint16_t      m_frameSequence       {0};                        // Sequence of the staged frame
+    uint16_t      m_frameSegments       {0};                        // Segment count of the staged frame (0 = none)
+    uint8_t       m_frameChunks         {0};                        // FRAME messages received (bit i: segments 32i..32i+31)
+    ecdSegmentMask_t m_frameStates      {0};
+    bool          m_refused             {false};                    // Last COMMIT refused, no update since
+    uint16_t      m_refusedSequence     {0};
+    unsigned long m_refusedCommits      {0};
+};
+
+/**
+ * @class ECD_SyncCoordinator
+ * @brief Coordinator side: clock offsets, frame staging, commits, reports.
+ */
+class ECD_SyncCoordinator {
+public:
+    ECD_SyncCoordinator(ECD_SyncLink& t_link, uint8_t t_numberOfBoards, unsigned long (*t_clock)(void) = nullptr);
+
+    void     poll(void);                                            ///< Handle replies (offsets, reports)
+    void     syncClock(uint8_t t_board);                            ///< Start a clock offset measurement of one board
+    void     stageFrame(uint8_t t_board, const bool* t_states, int t_count); ///< Send the next frame of one board
+    uint16_t commit(unsigned long t_leadMs);                        ///< Start the staged frames t_leadMs from now, returns the sequence
+    uint16_t commitOnTrigger(void);                                 ///< Start the staged frames on the trigger line
+    void     requestStatus(uint8_t t_board);                        ///< Ask one board for its last update
+
+    bool     isDone(uint8_t t_board, uint16_t t_sequence) const;    ///< Board reported update t_sequence
+    bool     isRefused(uint8_t t_board, uint16_t t_sequence) const; ///< Board reported commit t_sequence refused (re-stage and commit again)
+    bool     allDone(uint16_t t_sequence) const;                    ///< Every board reported update t_sequence
+    unsigned long getStartTime(uint8_t t_board) const;              ///< (ms) Reported start, coordinator time
+    unsigned long getCompletionTime(uint8_t t_board) const;         ///< (ms) Reported completion, coordinator time
+    unsigned long getStartSkew(uint16_t t_sequence) const;          ///< (ms) Reported start spread of an update
+    unsigned long getCompletionSkew(uint16_t t_sequence) const;     ///< (ms) Reported completion spread of an update
+    long     getClockOffset(uint8_t t_board) const;                 ///< (ms) Last measured offset of a board
+
+private:
+    unsigned long now(void) const { return (m_clock != nullptr) ? m_clock() : ::millis(); }
+    void     send(uint8_t t_type, uint8_t t_board, uint16_t t_sequence, uint32_t t_time, uint32_t t_value);
+    unsigned long spread(const unsigned long* t_times, uint16_t t_sequence) const;
+
+    ECD_SyncLink& m_link;
+    uint8_t       m_numberOfBoards;
+    unsigned long (*m_clock)(void);
+    uint16_t      m_sequence                                {0};
+    long          m_clockOffset         [ECD_SYNC_MAX_BOARDS] {};
+    uint16_t      m_doneSequence        [ECD_SYNC_MAX_BOARDS] {};
+    uint16_t      m_refusedSequence     [ECD_SYNC_MAX_BOARDS] {};
+    unsigned long m_startTime           [ECD_SYNC_MAX_BOARDS] {};
+    unsigned long m_completionTime      [ECD_SYNC_MAX_BOARDS] {};
+};
+
+#endif // _YNVISIBLE_ECD_SYNC
+
+
+/***************************************************************************
+ ****************************** END OF FILE ********************************
+ ***************************************************************************/
@@ -47,16 +47,13 @@ int evalKit7BarsPinList     [EVAL_KIT_7BARS_NUM_SEGMENTS]           = EVAL_KIT_7
 // Pointer to the currently active display (used by generic helpers)
 static YNV_ECD* p_currentDisplay = nullptr;
 
-// Static global driving flag (shared by all YNV_ECD objects)
-bool YNV_ECD::m_stopDrivingFlag = false;
-
-// Pre-instantiated YNV_ECD objects for each display type
-YNV_ECD ecdEvalKitSingle   (EVAL_KIT_SINGLE_NUM_SEGMENTS,        &evalKitSinglePinList);      // Single segment display
-YNV_ECD ecdEvalKit7SegDot  (EVAL_KIT_7SEG_DOT_NUM_SEGMENTS,       evalKit7SegDotPinList);    // 7-seg with dot
-YNV_ECD ecdEvalKit15SegNeg (EVAL_KIT_15SEG_NEGATIVE_NUM_SEGMENTS, evalKit15SegNegPinList);   // Dual 7-seg with minus sign
-YNV_ECD ecdEvalKit15SegDot (EVAL_KIT_15SEG_DOT_NUM_SEGMENTS,      evalKit15SegDotPinList);   // Dual 7-seg with middle dot
-YNV_ECD ecdEvalKit3Bars    (EVAL_KIT_3BARS_NUM_SEGMENTS,          evalKit3BarsPinList);      // 3-bar display (bottom to top)
-YNV_ECD ecdEvalKit7Bars    (EVAL_KIT_7BARS_NUM_SEGMENTS,          evalKit7BarsPinList);      // 7-bar display (bottom to top)
+// Pre-instantiated YNV_ECD objects for each display type (storage sized per display)
+YNV_ECD_Sized<EVAL_KIT_SINGLE_NUM_SEGMENTS>         ecdEvalKitSingle   (EVAL_KIT_SINGLE_NUM_SEGMENTS,        &evalKitSinglePinList);      // Single segment display
+YNV_ECD_Sized<EVAL_KIT_7SEG_DOT_NUM_SEGMENTS>       ecdEvalKit7SegDot  (EVAL_KIT_7SEG_DOT_NUM_SEGMENTS,       evalKit7SegDotPinList);    // 7-seg with dot
+YNV_ECD_Sized<EVAL_KIT_15SEG_NEGATIVE_NUM_SEGMENTS> ecdEvalKit15SegNeg (EVAL_KIT_15SEG_NEGATIVE_NUM_SEGMENTS, evalKit15SegNegPinList);   // Dual 7-seg with minus sign
+YNV_ECD_Sized<EVAL_KIT_15SEG_DOT_NUM_SEGMENTS>      ecdEvalKit15SegDot (EVAL_KIT_15SEG_DOT_NUM_SEGMENTS,      evalKit15SegDotPinList);   // Dual 7-seg with middle dot
+YNV_ECD_Sized<EVAL_KIT_3BARS_NUM_SEGMENTS>          ecdEvalKit3Bars    (EVAL_KIT_3BARS_NUM_SEGMENTS,          evalKit3BarsPinList);      // 3-bar display (bottom to top)
+YNV_ECD_Sized<EVAL_KIT_7BARS_NUM_SEGMENTS>          ecdEvalKit7Bars    (EVAL_KIT_7BARS_NUM_SEGMENTS,          evalKit7BarsPinList);      // 7-bar display (bottom to top)
 
 // Last two-digit value shown on 15-seg displays (used to detect tens rollover)
 EK_15Seg_Values_t last15SegNumber {0, 0};
@@ -212,6 +209,65 @@ void evaluationKitInit(void) {
 }
 
 
+#ifdef YNV_ECD_SIMULATOR
+/***************************************************************************/
+/**
+ * @brief Drive all Evaluation Kit displays on a simulated board.
+ *
+ * All displays share the Driver v5 segment pins, so they share one simulator.
+ *
+ * @param simulator Simulated board, or nullptr to return to the hardware.
+ */
+/***************************************************************************/
+void evaluationKitAttachSimulator(YNV_ECD_Simulator* simulator) {
+
+    ecdEvalKitSingle.attachSimulator(simulator);
+    ecdEvalKit7SegDot.attachSimulator(simulator);
+    ecdEvalKit15SegNeg.attachSimulator(simulator);
+    ecdEvalKit15SegDot.attachSimulator(simulator);
+    ecdEvalKit3Bars.attachSimulator(simulator);
+    ecdEvalKit7Bars.attachSimulator(simulator);
+}
+#endif
+
+
+/***************************************************************************/
+/**
+ * @brief Get the driving statistics summed over all Evaluation Kit displays.
+ *
+ * @return Accumulated statistics since the last evaluationKitResetStats().
+ */
+/***************************************************************************/
+ECD_Stats evaluationKitGetStats(void) {
+
+    const YNV_ECD* displays[] = { &ecdEvalKitSingle, &ecdEvalKit7SegDot, &ecdEvalKit15SegNeg,
+                                  &ecdEvalKit15SegDot, &ecdEvalKit3Bars, &ecdEvalKit7Bars };
+    ECD_Stats total;
+
+    for (const YNV_ECD* display : displays) {
+        total += display->getStats();                               // Every counter, including later additions
+    }
+
+    return total;
+}
+
+
+/***************************************************************************/
+/**
+ * @brief Clear the driving statistics of all Evaluation Kit displays.
+ */
+/***************************************************************************/
+void evaluationKitResetStats(void) {
+
+    ecdEvalKitSingle.resetStats();
+    ecdEvalKit7SegDot.resetStats();
+    ecdEvalKit15SegNeg.resetStats();
+    ecdEvalKit15SegDot.resetStats();
+    ecdEvalKit3Bars.resetStats();
+    ecdEvalKit7Bars.resetStats();
+}
+
+
 /***************************************************************************/
 /**
  * @brief Request the current display to stop any ongoing driving.
@@ -548,30 +604,11 @@ void displayDirectSetAll(bool state, uint16_t driveTime) {
     // Set CE according to requested state
     if (state) {
         // COLOR-like drive: CE below WE
-        ecdEvalKit15SegNeg.enableCounterElectrode(SUPPLY_VOLTAGE - REFRESH_COLORING_VOLTAGE);
+        ecdEvalKit15SegNeg.directDriveAll(state, SUPPLY_VOLTAGE - REFRESH_COLORING_VOLTAGE, driveTime);
     } else {
         // BLEACH-like drive: CE above WE
-        ecdEvalKit15SegNeg.enableCounterElectrode(REFRESH_BLEACHING_VOLTAGE);
-    }
-    delay(10);  // Short settling time for CE and DAC
-
-    // Force all segments to the requested state
-    for (int i = 0; i < EVAL_KIT_15SEG_NEGATIVE_NUM_SEGMENTS; i++) {
-        pinMode(evalKit15SegNegPinList[i], OUTPUT);
-        digitalWrite(evalKit15SegNegPinList[i], state);
+        ecdEvalKit15SegNeg.directDriveAll(state, REFRESH_BLEACHING_VOLTAGE, driveTime);
     }
-
-    // Hold state for requested time
-    delay(driveTime);
-
-    // Return all segments to High-Z
-    for (int i = 0; i < EVAL_KIT_15SEG_NEGATIVE_NUM_SEGMENTS; i++) {
-        pinMode(evalKit15SegNegPinList[i], INPUT);
-    }
-    
-    // Release CE to High-Z
-    ecdEvalKit15SegNeg.disableCounterElectrode();
-    delay(10);   // Small guard delay after disabling CE
 }
 
 
@@ -31,6 +31,10 @@
 
 #include "YnvisibleECD.h"
 
+#ifdef YNV_ECD_SIMULATOR
+#include "YnvisibleECDSimulator.h"
+#endif
+
 
 /***************************************************************************/
 /*************************** DISPLAY CONFIGURATION *************************/
@@ -160,6 +164,13 @@ struct EK_15Seg_Values_t {
 
 /* ---- Initialization ---- */
 void evaluationKitInit(void);
+#ifdef YNV_ECD_SIMULATOR
+void evaluationKitAttachSimulator(YNV_ECD_Simulator* simulator);
+#endif
+
+/* ---- Statistics ---- */
+ECD_Stats evaluationKitGetStats(void);
+void evaluationKitResetStats(void);
 
 /* ---- Driving Control ---- */
 void displayStopAnimation(void);